@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+
+#include <jvm/Global.hpp>
+
+// Collects everything that is not reachable from a single root
+class ListCollector : public coldspot::GarbageCollector
+{
+public:
+
+  ListCollector(coldspot::HeapSpace *heapSpace,
+    coldspot::ObjectAllocator *allocator)
+    : coldspot::GarbageCollector(heapSpace), root(0), released(0),
+      _allocator(allocator) { }
+
+  void collectGarbage() override
+  {
+    _heap_space->clear_marks();
+
+    mark_used(root);
+
+    for (auto region : _heap_space->regions())
+    {
+      for (coldspot::Object *object = region->first_object(); object != 0;)
+      {
+        coldspot::Object *next = region->next_object(object);
+        if (!coldspot::HeapSpace::is_marked(object))
+        {
+          _allocator->release_object(object);
+          ++released;
+        }
+        object = next;
+      }
+    }
+
+    _heap_space->reclaim_regions();
+  }
+
+  void collectGarbageForExit() override { }
+
+  coldspot::Object *root;
+  uint32_t released;
+
+private:
+
+  coldspot::ObjectAllocator *_allocator;
+};
+
+// Marks from a single root
+class RootObjectTask : public coldspot::RootTask
+{
+public:
+
+  RootObjectTask(coldspot::Object *object) : _object(object) { }
+
+  void scan(coldspot::GCWorker &worker) override
+  {
+    worker.mark(_object);
+  }
+
+private:
+
+  coldspot::Object *_object;
+};
+
+class TestThread : public coldspot::Thread
+{
+public:
+
+  TestThread() : coldspot::Thread(coldspot::THREADTYPE_VM) { }
+
+  void run() override { }
+};
+
+// Heap-space of the current test thread, with nodes of a list and of a
+// binary tree
+class GarbageCollectorTestCase : public ::testing::Test
+{
+protected:
+
+  GarbageCollectorTestCase() : allocator(&heapSpace) { }
+
+  void SetUp() override
+  {
+    coldspot::_current_thread = &thread;
+
+    nodeClass.name = "Node";
+    nodeClass.object_size = sizeof(coldspot::Object *);
+    nodeClass.reference_offsets.init(1);
+    nodeClass.reference_offsets[0] = 0;
+
+    treeNodeClass.name = "TreeNode";
+    treeNodeClass.object_size = 2 * sizeof(coldspot::Object *);
+    treeNodeClass.reference_offsets.init(2);
+    treeNodeClass.reference_offsets[0] = 0;
+    treeNodeClass.reference_offsets[1] = sizeof(coldspot::Object *);
+  }
+
+  void TearDown() override
+  {
+    heapSpace.retire_tlab(&thread);
+    coldspot::_current_thread = 0;
+  }
+
+  coldspot::Object *allocate_node(coldspot::Class *clazz)
+  {
+    coldspot::Object *node;
+    allocator.allocate_object(clazz, &node);
+    return node;
+  }
+
+  TestThread thread;
+  coldspot::Class nodeClass;
+  coldspot::Class treeNodeClass;
+  coldspot::HeapSpace heapSpace;
+  coldspot::ObjectAllocator allocator;
+};
+
+TEST_F(GarbageCollectorTestCase, LongLinkedList)
+{
+  const uint32_t length = 10000000;
+
+  ListCollector collector(&heapSpace, &allocator);
+
+  coldspot::Object *head = 0;
+  for (uint32_t i = 0; i < length; ++i)
+  {
+    coldspot::Object *node = allocate_node(&nodeClass);
+    node->set_value<coldspot::Object *>(0, head);
+    head = node;
+  }
+
+  // Marking the whole list must not exhaust the native stack
+  collector.root = head;
+  collector.collectGarbage();
+  EXPECT_EQ(0u, collector.released);
+
+  // The unreachable list is released and its regions are reclaimed
+  heapSpace.retire_tlab(&thread);
+  collector.root = 0;
+  collector.collectGarbage();
+  EXPECT_EQ(length, collector.released);
+  EXPECT_EQ(0u, heapSpace.regions().size());
+}
+
+TEST_F(GarbageCollectorTestCase, FreeEndIsReused)
+{
+  ListCollector collector(&heapSpace, &allocator);
+
+  // Only the first node of the region survives
+  coldspot::Object *survivor = allocate_node(&nodeClass);
+  for (uint32_t i = 0; i < 1000; ++i)
+  {
+    allocate_node(&nodeClass);
+  }
+
+  heapSpace.retire_tlab(&thread);
+  collector.root = survivor;
+  collector.collectGarbage();
+  EXPECT_EQ(1000u, collector.released);
+
+  // The next buffer starts behind the survivor
+  coldspot::Object *node = allocate_node(&nodeClass);
+  EXPECT_EQ((uint8_t *) survivor + coldspot::HeapSpace::object_size(survivor),
+    (uint8_t *) node);
+  EXPECT_FALSE(coldspot::HeapSpace::is_marked(node));
+  EXPECT_EQ(1u, heapSpace.regions().size());
+}
+
+TEST_F(GarbageCollectorTestCase, ParallelMarking)
+{
+  const uint32_t length = 1 << 20;
+
+  coldspot::dynarray<coldspot::Object *> nodes(length);
+  for (uint32_t i = length; i-- > 1;)
+  {
+    coldspot::Object *node = allocate_node(&treeNodeClass);
+    if (2 * i < length)
+    {
+      node->set_value<coldspot::Object *>(0, nodes[2 * i]);
+    }
+    if (2 * i + 1 < length)
+    {
+      node->set_value<coldspot::Object *>(sizeof(coldspot::Object *),
+        nodes[2 * i + 1]);
+    }
+    nodes[i] = node;
+  }
+
+  // Every node is marked exactly once by one of the workers
+  heapSpace.clear_marks();
+  coldspot::ParallelMarker marker(4);
+  coldspot::List<coldspot::RootTask *> tasks;
+  tasks.addBack(new RootObjectTask(nodes[2]));
+  tasks.addBack(new RootObjectTask(nodes[3]));
+  EXPECT_FALSE(marker.mark(tasks));
+
+  uint32_t marked = 0;
+  for (uint32_t i = 1; i < length; ++i)
+  {
+    if (coldspot::HeapSpace::is_marked(nodes[i]))
+    {
+      ++marked;
+    }
+  }
+  EXPECT_EQ(length - 2, marked);
+
+  for (auto task : tasks)
+  {
+    delete task;
+  }
+}
+
+TEST_F(GarbageCollectorTestCase, RecordedTopHidesNewObjects)
+{
+  coldspot::Object *node = allocate_node(&nodeClass);
+  heapSpace.record_tops();
+
+  // Allocated during the collection
+  allocate_node(&nodeClass);
+
+  coldspot::HeapRegion *region = coldspot::HeapRegion::of(node);
+  EXPECT_EQ(node, region->first_recorded_object());
+  EXPECT_EQ(node, region->first_young_recorded_object());
+  EXPECT_EQ(0, region->next_recorded_object(node));
+  EXPECT_NE(nullptr, region->next_object(node));
+}
+
+TEST_F(GarbageCollectorTestCase, ReferenceStoreDirtiesCard)
+{
+  coldspot::Object *oldNode = allocate_node(&nodeClass);
+  heapSpace.promote();
+
+  coldspot::Object *youngNode = allocate_node(&nodeClass);
+
+  coldspot::HeapRegion *region = coldspot::HeapRegion::of(oldNode);
+  EXPECT_TRUE(region->is_old(oldNode));
+  EXPECT_FALSE(region->is_old(youngNode));
+  EXPECT_EQ(youngNode, region->first_young_object());
+  EXPECT_FALSE(region->has_dirty_cards());
+
+  // The old node references a young one now
+  oldNode->set_value<coldspot::Object *>(0, youngNode);
+  EXPECT_TRUE(region->is_card_dirty(oldNode));
+  EXPECT_TRUE(region->has_dirty_cards());
+
+  // After a collection both are old and the cards are clean
+  heapSpace.promote();
+  EXPECT_TRUE(region->is_old(youngNode));
+  EXPECT_FALSE(region->has_dirty_cards());
+}
+
+TEST_F(GarbageCollectorTestCase, OverwrittenReferenceIsRecorded)
+{
+  coldspot::Object *holder = allocate_node(&nodeClass);
+  coldspot::Object *node = allocate_node(&nodeClass);
+  holder->set_value<coldspot::Object *>(0, node);
+
+  // The snapshot is taken, later objects are young
+  heapSpace.clear_marks();
+  heapSpace.promote();
+  coldspot::_satb_active.store(true);
+
+  coldspot::Object *youngNode = allocate_node(&nodeClass);
+
+  coldspot::HeapRegion *region = coldspot::HeapRegion::of(holder);
+  EXPECT_EQ(holder, region->first_old_object());
+  EXPECT_EQ(node, region->next_old_object(holder));
+  EXPECT_EQ(0, region->next_old_object(node));
+
+  // The node was reachable at the snapshot, so it is marked
+  holder->set_value<coldspot::Object *>(0, youngNode);
+  coldspot::_satb_active.store(false);
+
+  coldspot::GCWorker worker(0, 0);
+  thread.satb_queue().drain(worker);
+  worker.drain();
+  EXPECT_TRUE(coldspot::HeapSpace::is_marked(node));
+  EXPECT_FALSE(coldspot::HeapSpace::is_marked(holder));
+
+  // Stores outside of a marking are not recorded
+  holder->set_value<coldspot::Object *>(0, node);
+  heapSpace.clear_marks();
+  thread.satb_queue().drain(worker);
+  worker.drain();
+  EXPECT_FALSE(coldspot::HeapSpace::is_marked(youngNode));
+}
+
+TEST_F(GarbageCollectorTestCase, StoppedThreadHandsOverQueue)
+{
+  coldspot::Object *holder = allocate_node(&nodeClass);
+  coldspot::Object *node = allocate_node(&nodeClass);
+  holder->set_value<coldspot::Object *>(0, node);
+
+  heapSpace.clear_marks();
+  coldspot::_satb_active.store(true);
+  holder->set_value<coldspot::Object *>(0, 0);
+
+  // The collector finds the recorded node in the global list only
+  thread.set_state(coldspot::THREADSTATE_BLOCKED);
+  thread.set_state(coldspot::THREADSTATE_RUNNABLE);
+  coldspot::_satb_active.store(false);
+
+  coldspot::GCWorker worker(0, 0);
+  EXPECT_TRUE(coldspot::SatbQueue::drain_global(worker));
+  worker.drain();
+  EXPECT_TRUE(coldspot::HeapSpace::is_marked(node));
+  EXPECT_FALSE(coldspot::SatbQueue::drain_global(worker));
+}
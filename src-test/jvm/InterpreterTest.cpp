@@ -10,7 +10,7 @@
     code[0] = coldspot::op; \
     code[1] = coldspot::op_return; \
     coldspot::Frame frame(coldspot::FRAMETYPE_JAVA, 0, 0, code); \
-    coldspot::Value operands[1]; \
+    coldspot::Slot operands[1]; \
     frame.operands = operands; \
     frame.push((type) param); \
     coldspot::Value value; \
@@ -26,7 +26,7 @@
     code[0] = coldspot::op; \
     code[1] = coldspot::op_return; \
     coldspot::Frame frame(coldspot::FRAMETYPE_JAVA, 0, 0, code); \
-    coldspot::Value operands[2]; \
+    coldspot::Slot operands[2]; \
     frame.operands = operands; \
     frame.push((type) first); \
     frame.push((type) second); \
@@ -68,6 +68,34 @@ TEST_ARITHMETIC_2(FREM, FRETURN, jfloat, 10.0, 4.0, 2.0, as_float,
 TEST_ARITHMETIC_2(DREM, DRETURN, jdouble, 10.0, 4.0, 2.0, as_double,
     EXPECT_DOUBLE_EQ)
 
+TEST(InterpreterTestCase, Instruction_IDIV_MinValue)
+{
+  coldspot::Interpreter interpreter;
+  uint8_t code[] = { coldspot::IDIV, coldspot::IRETURN };
+  coldspot::Frame frame(coldspot::FRAMETYPE_JAVA, 0, 0, code);
+  coldspot::Slot operands[2];
+  frame.operands = operands;
+  frame.push((jint) INT32_MIN);
+  frame.push((jint) -1);
+  coldspot::Value value;
+  interpreter.execute(&frame, &value);
+  EXPECT_EQ(INT32_MIN, value.as_int());
+}
+
+TEST(InterpreterTestCase, Instruction_LREM_MinValue)
+{
+  coldspot::Interpreter interpreter;
+  uint8_t code[] = { coldspot::LREM, coldspot::LRETURN };
+  coldspot::Frame frame(coldspot::FRAMETYPE_JAVA, 0, 0, code);
+  coldspot::Slot operands[2];
+  frame.operands = operands;
+  frame.push((jlong) INT64_MIN);
+  frame.push((jlong) -1);
+  coldspot::Value value;
+  interpreter.execute(&frame, &value);
+  EXPECT_EQ(0, value.as_long());
+}
+
 TEST_ARITHMETIC_1(INEG, IRETURN, jint, 1, -1, as_int, EXPECT_EQ)
 TEST_ARITHMETIC_1(LNEG, LRETURN, jlong, 1, -1, as_long, EXPECT_EQ)
 TEST_ARITHMETIC_1(FNEG, FRETURN, jfloat, 1.0, -1.0, as_float, EXPECT_FLOAT_EQ)
@@ -113,6 +113,27 @@ void print_usage()
     LOG_ERROR("\t-Xverbose:[debug|execute]\n")
     LOG_ERROR("\t\tActivates non-standard verbose messages\n")
 
+    LOG_ERROR("\t-Xinterp:[threaded|switch]\n")
+    LOG_ERROR("\t\tSelects the dispatch of the interpreter\n")
+
+    LOG_ERROR("\t-Xint\n")
+    LOG_ERROR("\t\tDisables the compilation of hot methods\n")
+
+    LOG_ERROR("\t-Xprof\n")
+    LOG_ERROR("\t\tPrints the hottest methods on exit\n")
+
+    LOG_ERROR("\t-Xprof:inlinecaches\n")
+    LOG_ERROR("\t\tPrints the statistics of the inline caches on exit\n")
+
+    LOG_ERROR("\t-Xprof:ngrams\n")
+    LOG_ERROR("\t\tPrints the most frequent instruction-sequences on exit\n")
+
+    LOG_ERROR("\t-XX:ParallelGCThreads=<count>\n")
+    LOG_ERROR("\t\tSets the number of threads marking objects in parallel\n")
+
+    LOG_ERROR("\t-XX:+UseConcMarkSweepGC\n")
+    LOG_ERROR("\t\tCollects concurrently to the running threads\n")
+
     fflush(stderr);
 }
 
@@ -25,7 +25,7 @@
   if (_charArrayClass == 0) { \
     errorValue = _vm->class_loader()->load_array("[C", 0, &_charArrayClass); \
     RETURN_ON_FAIL(errorValue); \
-    if (!_charArrayClass->initialized) { \
+    if (!_charArrayClass->is_initialized()) { \
       errorValue = _vm->class_loader()->initialize_class(_charArrayClass); \
       RETURN_ON_FAIL(errorValue); \
     } \
@@ -45,7 +45,21 @@ namespace coldspot
         uint8_t *srcMemory = src->memory() + (srcStart * typeSize);
         uint8_t *destMemory = dest->memory() + (destStart * typeSize);
 
+        if (!dest->type()->component_type->is_primitive())
+        {
+            Object **elements = (Object **) destMemory;
+            for (jint i = 0; i < length; ++i)
+            {
+                HeapSpace::pre_write_barrier(elements[i]);
+            }
+        }
+
         memcpy(destMemory, srcMemory, length * typeSize);
+
+        if (!dest->type()->component_type->is_primitive())
+        {
+            HeapSpace::write_barrier(dest);
+        }
     }
 
 
@@ -214,8 +228,18 @@ namespace coldspot
 
         uint8_t componentSize = static_cast<uint8_t>(componentType->type_size);
 
+        if (!componentType->is_primitive())
+        {
+            HeapSpace::pre_write_barrier(((Object **) memory())[index]);
+        }
+
         memcpy(&memory()[componentSize * index], &value.value(), componentSize);
 
+        if (!componentType->is_primitive())
+        {
+            HeapSpace::write_barrier(this);
+        }
+
         return RETURN_OK;
     }
 
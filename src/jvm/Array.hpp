@@ -71,6 +71,9 @@ namespace coldspot
 
     private:
 
+        // Reads the length in compiled code
+        friend class TemplateCompiler;
+
         jint _length;
 
         inline error_t validate_index(jint index);
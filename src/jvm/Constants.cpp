@@ -42,6 +42,8 @@ namespace coldspot
     const char *CLASSNAME_DOUBLE = "java/lang/Double";
 
     const char *CLASSNAME_ABSTRACTMETHODERROR = "java/lang/AbstractMethodError";
+    const char *CLASSNAME_ERROR = "java/lang/Error";
+    const char *CLASSNAME_EXCEPTIONININITIALIZERERROR = "java/lang/ExceptionInInitializerError";
     const char *CLASSNAME_INCOMPATIBLECLASSCHANGEERROR = "java/lang/IncompatibleClassChangeError";
     const char *CLASSNAME_INSTANTIATIONERROR = "java/lang/InstantiationError";
     const char *CLASSNAME_LINKAGEERROR = "java/lang/LinkageError";
@@ -51,6 +53,7 @@ namespace coldspot
     const char *CLASSNAME_OUTOFMEMORYERROR = "java/lang/OutOfMemoryError";
     const char *CLASSNAME_STACKOVERFLOWERROR = "java/lang/StackOverflowError";
     const char *CLASSNAME_UNSATISFIEDLINKERROR = "java/lang/UnsatisfiedLinkError";
+    const char *CLASSNAME_VERIFYERROR = "java/lang/VerifyError";
 
     const char *CLASSNAME_ARITHMETICEXCEPTION = "java/lang/ArithmeticException";
     const char *CLASSNAME_ARRAYINDEXOUTOFBOUNDSEXCEPTION = "java/lang/ArrayIndexOutOfBoundsException";
@@ -58,11 +61,13 @@ namespace coldspot
     const char *CLASSNAME_CLASSNOTFOUNDEXCEPTION = "java/lang/ClassNotFoundException";
     const char *CLASSNAME_ILLEGALARGUMENTEXCEPTION = "java/lang/IllegalArgumentException";
     const char *CLASSNAME_ILLEGALMONITORSTATEEXCEPTION = "java/lang/IllegalMonitorStateException";
+    const char *CLASSNAME_INTERRUPTEDEXCEPTION = "java/lang/InterruptedException";
     const char *CLASSNAME_NEGATIVEARRAYSIZEEXCEPTION = "java/lang/NegativeArraySizeException";
     const char *CLASSNAME_NULLPOINTEREXCEPTION = "java/lang/NullPointerException";
 
     const char *METHODNAME_CONSTRUCTOR = "<init>";
     const char *METHODNAME_STATICINIT = "<clinit>";
+    const char *METHODNAME_FINALIZE = "finalize";
 
     const char *FUNCNAME_JNIONLOAD = "JNI_OnLoad";
     const char *FUNCNAME_JNIONUNLOAD = "JNI_OnUnload";
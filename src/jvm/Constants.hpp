@@ -48,6 +48,8 @@ namespace coldspot
 
     // Errors
     extern const char *CLASSNAME_ABSTRACTMETHODERROR;
+    extern const char *CLASSNAME_ERROR;
+    extern const char *CLASSNAME_EXCEPTIONININITIALIZERERROR;
     extern const char *CLASSNAME_INCOMPATIBLECLASSCHANGEERROR;
     extern const char *CLASSNAME_INSTANTIATIONERROR;
     extern const char *CLASSNAME_LINKAGEERROR;
@@ -57,6 +59,7 @@ namespace coldspot
     extern const char *CLASSNAME_OUTOFMEMORYERROR;
     extern const char *CLASSNAME_STACKOVERFLOWERROR;
     extern const char *CLASSNAME_UNSATISFIEDLINKERROR;
+    extern const char *CLASSNAME_VERIFYERROR;
 
     // Exceptions
     extern const char *CLASSNAME_ARITHMETICEXCEPTION;
@@ -65,12 +68,14 @@ namespace coldspot
     extern const char *CLASSNAME_CLASSNOTFOUNDEXCEPTION;
     extern const char *CLASSNAME_ILLEGALARGUMENTEXCEPTION;
     extern const char *CLASSNAME_ILLEGALMONITORSTATEEXCEPTION;
+    extern const char *CLASSNAME_INTERRUPTEDEXCEPTION;
     extern const char *CLASSNAME_NEGATIVEARRAYSIZEEXCEPTION;
     extern const char *CLASSNAME_NULLPOINTEREXCEPTION;
 
     // Method names
     extern const char *METHODNAME_CONSTRUCTOR;
     extern const char *METHODNAME_STATICINIT;
+    extern const char *METHODNAME_FINALIZE;
 
     // Function names
     extern const char *FUNCNAME_JNIONLOAD;
@@ -44,6 +44,7 @@
 #include "NativeCall.hpp"
 #include "Object.hpp"
 #include "Options.hpp"
+#include "Slot.hpp"
 #include "Type.hpp"
 #include "Value.hpp"
 #include "VirtualMachine.hpp"
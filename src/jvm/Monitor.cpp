@@ -24,51 +24,76 @@
 namespace coldspot
 {
 
+    // Hints the processor, that the thread is spinning.
+    static inline void spin_pause()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+
     void Monitor::enter()
     {
-        _mutex.lock();
+        Thread *self = _current_thread;
+        if (_owner.load(std::memory_order_relaxed) == self && _recursion != 0)
+        {
+            ++_recursion;
+            return;
+        }
+
+        lock();
 
-        _owner = _current_thread;
+        _owner.store(self, std::memory_order_relaxed);
+        _recursion = 1;
     }
 
 
     bool Monitor::try_enter()
     {
-        bool success = _mutex.try_lock();
-        if (success)
+        Thread *self = _current_thread;
+        if (_owner.load(std::memory_order_relaxed) == self && _recursion != 0)
+        {
+            ++_recursion;
+            return true;
+        }
+
+        uint32_t state = UNLOCKED;
+        if (!_state.compare_exchange_strong(state, LOCKED,
+            std::memory_order_acquire))
         {
-            _owner = _current_thread;
+            return false;
         }
 
-        return success;
+        _owner.store(self, std::memory_order_relaxed);
+        _recursion = 1;
+
+        return true;
     }
 
 
     error_t Monitor::exit()
     {
-        if (_current_thread != _owner)
+        error_t errorValue = check_owner();
+        RETURN_ON_FAIL(errorValue)
+
+        if (--_recursion == 0)
         {
-            _current_executor->throw_exception(
-                CLASSNAME_ILLEGALMONITORSTATEEXCEPTION);
-            return RETURN_EXCEPTION;
+            _owner.store(0, std::memory_order_relaxed);
+            unlock();
         }
 
-        _mutex.unlock();
-
         return RETURN_OK;
     }
 
 
     error_t Monitor::notify()
     {
-        if (_current_thread != _owner)
-        {
-            _current_executor->throw_exception(
-                CLASSNAME_ILLEGALMONITORSTATEEXCEPTION);
-            return RETURN_EXCEPTION;
-        }
+        error_t errorValue = check_owner();
+        RETURN_ON_FAIL(errorValue)
 
-        _condition.notify();
+        _sequence.fetch_add(1, std::memory_order_relaxed);
+        System::wakeAddress(&_sequence, false);
 
         return RETURN_OK;
     }
@@ -76,14 +101,11 @@ namespace coldspot
 
     error_t Monitor::notify_all()
     {
-        if (_current_thread != _owner)
-        {
-            _current_executor->throw_exception(
-                CLASSNAME_ILLEGALMONITORSTATEEXCEPTION);
-            return RETURN_EXCEPTION;
-        }
+        error_t errorValue = check_owner();
+        RETURN_ON_FAIL(errorValue)
 
-        _condition.notify_all();
+        _sequence.fetch_add(1, std::memory_order_relaxed);
+        System::wakeAddress(&_sequence, true);
 
         return RETURN_OK;
     }
@@ -91,25 +113,138 @@ namespace coldspot
 
     error_t Monitor::wait(jlong ms)
     {
-        if (_current_thread != _owner)
+        error_t errorValue = check_owner();
+        RETURN_ON_FAIL(errorValue)
+
+        if (ms < 0)
         {
             _current_executor->throw_exception(
-                CLASSNAME_ILLEGALMONITORSTATEEXCEPTION);
+                CLASSNAME_ILLEGALARGUMENTEXCEPTION);
             return RETURN_EXCEPTION;
         }
 
-        if (ms < 0)
+        // Timeouts too long to represent wait without limit
+        jlong nanos = ms < INT64_MAX / 1000000 ? ms * 1000000 : 0;
+
+        Thread *self = _current_thread;
+        if (self != 0 && self->is_interrupted(true))
         {
-            _current_executor->throw_exception(
-                CLASSNAME_ILLEGALARGUMENTEXCEPTION);
+            _current_executor->throw_exception(CLASSNAME_INTERRUPTEDEXCEPTION);
             return RETURN_EXCEPTION;
         }
 
-        // TODO InterruptedException
+        // Notifications after the release change the sequence,
+        // so that they are not lost
+        uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+        uint32_t recursion = _recursion;
+
+        _recursion = 0;
+        _owner.store(0, std::memory_order_relaxed);
+        unlock();
+
+        if (self == 0)
+        {
+            System::waitAddress(&_sequence, sequence, nanos);
+        }
+        else
+        {
+            // Interrupts also change the sequence once registered
+            self->set_blocker(&_sequence);
+            self->set_state(ms == 0 ? THREADSTATE_WAITING
+                                    : THREADSTATE_TIMED_WAITING);
+            if (!self->is_interrupted(false))
+            {
+                System::waitAddress(&_sequence, sequence, nanos);
+            }
+            self->set_state(THREADSTATE_RUNNABLE);
+            self->set_blocker(0);
+        }
 
-        _condition.wait(_mutex);
+        lock();
+        _owner.store(self, std::memory_order_relaxed);
+        _recursion = recursion;
 
-        _owner = _current_thread;
+        if (self != 0 && self->is_interrupted(true))
+        {
+            _current_executor->throw_exception(CLASSNAME_INTERRUPTEDEXCEPTION);
+            return RETURN_EXCEPTION;
+        }
+
+        return RETURN_OK;
+    }
+
+
+    void Monitor::lock()
+    {
+        uint32_t state = UNLOCKED;
+        if (_state.compare_exchange_strong(state, LOCKED,
+            std::memory_order_acquire))
+        {
+            return;
+        }
+
+        // Spin while the lock was recently released in time
+        int32_t spins = _spins.load(std::memory_order_relaxed);
+        for (int32_t i = 0; i < spins; ++i)
+        {
+            spin_pause();
+            state = UNLOCKED;
+            if (_state.load(std::memory_order_relaxed) == UNLOCKED &&
+                _state.compare_exchange_strong(state, LOCKED,
+                    std::memory_order_acquire))
+            {
+                _spins.store(spins < MAX_SPINS ? spins * 2 : MAX_SPINS,
+                    std::memory_order_relaxed);
+                return;
+            }
+        }
+        _spins.store(spins > MIN_SPINS ? spins / 2 : MIN_SPINS,
+            std::memory_order_relaxed);
+
+        // Park until the lock is released, a blocked thread is skipped by
+        // the suspension of the vm-threads
+        Thread *self = _current_thread;
+        if (self != 0)
+        {
+            self->set_state(THREADSTATE_BLOCKED);
+        }
+
+        state = _state.exchange(CONTENDED, std::memory_order_acquire);
+        while (state != UNLOCKED)
+        {
+            System::waitAddress(&_state, CONTENDED, 0);
+            state = _state.exchange(CONTENDED, std::memory_order_acquire);
+        }
+
+        if (self != 0)
+        {
+            self->set_state(THREADSTATE_RUNNABLE);
+
+            // A collection may have started while the thread was blocked,
+            // wait for its end before running java code again
+            self->safepoint();
+        }
+    }
+
+
+    void Monitor::unlock()
+    {
+        if (_state.exchange(UNLOCKED, std::memory_order_release) == CONTENDED)
+        {
+            System::wakeAddress(&_state, false);
+        }
+    }
+
+
+    error_t Monitor::check_owner()
+    {
+        if (_owner.load(std::memory_order_relaxed) != _current_thread ||
+            _recursion == 0)
+        {
+            _current_executor->throw_exception(
+                CLASSNAME_ILLEGALMONITORSTATEEXCEPTION);
+            return RETURN_EXCEPTION;
+        }
 
         return RETURN_OK;
     }
@@ -22,9 +22,9 @@
 #ifndef COLDSPOT_JVM_MONITOR_HPP_
 #define COLDSPOT_JVM_MONITOR_HPP_
 
+#include <atomic>
+
 #include <jvm/jni/Types.hpp>
-#include <jvm/thread/Condition.hpp>
-#include <jvm/thread/Mutex.hpp>
 #include <jvm/Error.hpp>
 
 namespace coldspot
@@ -32,12 +32,16 @@ namespace coldspot
 
     class Thread;
 
-    // The monitor is used to synchronize an object.
+    // The monitor is used to synchronize an object. Contended threads spin
+    // for a while before they park on the lock, the number of spins adapts
+    // to the recent success of spinning. Parked threads and waiting threads
+    // block on futex words (see System::waitAddress).
     class Monitor
     {
     public:
 
-        Monitor() : _owner(0)
+        Monitor() : _state(UNLOCKED), _owner(0), _recursion(0),
+                    _spins(INITIAL_SPINS), _sequence(0)
         {
         }
 
@@ -56,14 +60,35 @@ namespace coldspot
         error_t notify_all();
 
         // Causes the current thread to wait until another thread
-        // invokes the notify or notifyAll method.
+        // invokes the notify or notifyAll method, the time has elapsed
+        // or the thread is interrupted.
         error_t wait(jlong ms);
 
     private:
 
-        Mutex _mutex;
-        Condition _condition;
-        Thread *_owner;
+        // States of the lock, contended if threads may be parked
+        static const uint32_t UNLOCKED = 0;
+        static const uint32_t LOCKED = 1;
+        static const uint32_t CONTENDED = 2;
+
+        static const int32_t INITIAL_SPINS = 128;
+        static const int32_t MIN_SPINS = 16;
+        static const int32_t MAX_SPINS = 4096;
+
+        std::atomic<uint32_t> _state;
+        std::atomic<Thread *> _owner;
+        uint32_t _recursion;
+        std::atomic<int32_t> _spins;
+
+        // Incremented by notifications, waiting threads park on it
+        std::atomic<uint32_t> _sequence;
+
+        // Acquires and releases the lock.
+        void lock();
+        void unlock();
+
+        // Checks that the current thread owns the monitor.
+        error_t check_owner();
     };
 
 }
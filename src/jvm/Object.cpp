@@ -19,6 +19,8 @@
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <type_traits>
+
 #include <jvm/Global.hpp>
 
 namespace coldspot
@@ -38,7 +40,7 @@ namespace coldspot
         }
 
         error_t error_value;
-        if (!clazz->initialized)
+        if (!clazz->is_initialized())
         {
             error_value = _vm->class_loader()->initialize_class(clazz);
             RETURN_ON_FAIL(error_value);
@@ -85,6 +87,193 @@ namespace coldspot
     }
 
 
+    void Object::monitor_enter_slow(uint64_t owner)
+    {
+        bool contended = false;
+        for (uint32_t attempt = 0; ; ++attempt)
+        {
+            uint64_t word = _lock_word.load(std::memory_order_acquire);
+
+            // Inflated lock
+            if ((word & LOCK_INFLATED) != 0)
+            {
+                ((Monitor *) (word & ~LOCK_INFLATED))->enter();
+                break;
+            }
+
+            // Recursive thin lock, inflated if the count overflows
+            if (word != 0 && (word & LOCK_OWNER_MASK) == owner)
+            {
+                if ((word & LOCK_COUNT_MASK) != LOCK_COUNT_MASK)
+                {
+                    _lock_word.store(word + LOCK_RECURSION,
+                        std::memory_order_relaxed);
+                    break;
+                }
+                inflate(word)->enter();
+                break;
+            }
+
+            // Released meanwhile, inflate the lock if it was contended
+            if (word == 0)
+            {
+                if (!contended)
+                {
+                    if (_lock_word.compare_exchange_strong(word,
+                        owner | LOCK_RECURSION, std::memory_order_acquire))
+                    {
+                        break;
+                    }
+                    continue;
+                }
+
+                Monitor *monitor = new Monitor;
+                if (_lock_word.compare_exchange_strong(word,
+                    (uint64_t) monitor | LOCK_INFLATED,
+                    std::memory_order_acq_rel))
+                {
+                    monitor->enter();
+                    break;
+                }
+                delete monitor;
+                continue;
+            }
+
+            // Wait until the owner releases the thin lock
+            if (!contended && _current_thread != 0)
+            {
+                _current_thread->set_state(THREADSTATE_BLOCKED);
+            }
+            contended = true;
+            if (attempt < 64)
+            {
+                System::yield();
+            }
+            else
+            {
+                System::sleep(1);
+            }
+        }
+
+        if (contended && _current_thread != 0)
+        {
+            _current_thread->set_state(THREADSTATE_RUNNABLE);
+
+            // The collection, that skipped the blocked thread, may still
+            // be running
+            _current_thread->safepoint();
+        }
+    }
+
+
+    error_t Object::monitor_exit_slow(uint64_t word)
+    {
+        if ((word & LOCK_INFLATED) != 0)
+        {
+            return ((Monitor *) (word & ~LOCK_INFLATED))->exit();
+        }
+
+        _current_executor->throw_exception(
+            CLASSNAME_ILLEGALMONITORSTATEEXCEPTION);
+        return RETURN_EXCEPTION;
+    }
+
+
+    bool Object::monitor_try_enter()
+    {
+        uint64_t owner = current_lock_owner();
+        uint64_t word = 0;
+        if (_lock_word.compare_exchange_strong(word, owner | LOCK_RECURSION,
+            std::memory_order_acquire))
+        {
+            return true;
+        }
+
+        if ((word & LOCK_INFLATED) != 0)
+        {
+            return ((Monitor *) (word & ~LOCK_INFLATED))->try_enter();
+        }
+
+        // Owned by another thread
+        if ((word & LOCK_OWNER_MASK) != owner)
+        {
+            return false;
+        }
+
+        monitor_enter_slow(owner);
+        return true;
+    }
+
+
+    error_t Object::monitor_wait(jlong ms)
+    {
+        Monitor *monitor;
+        error_t errorValue = owned_monitor(&monitor);
+        RETURN_ON_FAIL(errorValue)
+
+        return monitor->wait(ms);
+    }
+
+
+    error_t Object::monitor_notify()
+    {
+        Monitor *monitor;
+        error_t errorValue = owned_monitor(&monitor);
+        RETURN_ON_FAIL(errorValue)
+
+        return monitor->notify();
+    }
+
+
+    error_t Object::monitor_notify_all()
+    {
+        Monitor *monitor;
+        error_t errorValue = owned_monitor(&monitor);
+        RETURN_ON_FAIL(errorValue)
+
+        return monitor->notify_all();
+    }
+
+
+    Monitor *Object::inflate(uint64_t word)
+    {
+        // Only the owner of the thin lock changes it, so the monitor
+        // is entered as often as the thin lock before it is published
+        Monitor *monitor = new Monitor;
+        for (uint64_t i = 0; i < (word & LOCK_COUNT_MASK); i += LOCK_RECURSION)
+        {
+            monitor->enter();
+        }
+        _lock_word.store((uint64_t) monitor | LOCK_INFLATED,
+            std::memory_order_release);
+
+        return monitor;
+    }
+
+
+    error_t Object::owned_monitor(Monitor **monitor)
+    {
+        uint64_t word = _lock_word.load(std::memory_order_acquire);
+
+        // The monitor checks the owner itself
+        if ((word & LOCK_INFLATED) != 0)
+        {
+            *monitor = (Monitor *) (word & ~LOCK_INFLATED);
+            return RETURN_OK;
+        }
+
+        if (word == 0 || (word & LOCK_OWNER_MASK) != current_lock_owner())
+        {
+            _current_executor->throw_exception(
+                CLASSNAME_ILLEGALMONITORSTATEEXCEPTION);
+            return RETURN_EXCEPTION;
+        }
+
+        *monitor = inflate(word);
+        return RETURN_OK;
+    }
+
+
     template<typename T>
     T Object::get_value(uint32_t offset)
     {
@@ -107,7 +296,17 @@ namespace coldspot
     template<typename T>
     void Object::set_value(uint32_t offset, T value)
     {
+        if (std::is_pointer<T>::value)
+        {
+            HeapSpace::pre_write_barrier(*((Object **) (_memory + offset)));
+        }
+
         *((T *) (_memory + offset)) = value;
+
+        if (std::is_pointer<T>::value)
+        {
+            HeapSpace::write_barrier(this);
+        }
     }
 
 #define EXPLICIT(type) template void Object::set_value<type>(uint32_t offset, type value);
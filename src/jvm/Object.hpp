@@ -22,12 +22,14 @@
 #ifndef COLDSPOT_JVM_OBJECT_HPP_
 #define COLDSPOT_JVM_OBJECT_HPP_
 
+#include <atomic>
 #include <cstdint>
 #include <limits>
 
 #include <jvm/common/HashMap.hpp>
 #include <jvm/common/Memory.hpp>
 #include <jvm/jdk/Global.hpp>
+#include <jvm/thread/Thread.hpp>
 #include <jvm/Monitor.hpp>
 
 namespace coldspot
@@ -50,12 +52,16 @@ namespace coldspot
         // Creates a new object from the class using the default constructor.
         static error_t new_object_default(Class *clazz, Object **object);
 
-        Object(Class *type) : _type(type), _monitor(0), _memory_size(0),
-                              _memory(0), _used(true) { }
+        Object(Class *type) : _type(type), _lock_word(0), _memory_size(0),
+                              _memory(0), _finalizing(false) { }
 
         virtual ~Object()
         {
-            DELETE_OBJECT(_monitor);
+            uint64_t word = _lock_word.load(std::memory_order_relaxed);
+            if ((word & LOCK_INFLATED) != 0)
+            {
+                delete (Monitor *) (word & ~LOCK_INFLATED);
+            }
         }
 
         // Clones the object.
@@ -73,23 +79,62 @@ namespace coldspot
         template<typename T>
         void set_value(uint32_t offset, T value);
 
-        // Lazy creation of the monitor
-        Monitor *ensure_monitor()
+        // Enters the lock of the object. An unlocked object is locked by a
+        // single compare-and-swap, recursive locking increments the count.
+        void monitor_enter()
         {
-            return _monitor == 0 ? (_monitor = new Monitor) : _monitor;
+            uint64_t owner = current_lock_owner();
+            uint64_t word = 0;
+            if (!_lock_word.compare_exchange_strong(word,
+                owner | LOCK_RECURSION, std::memory_order_acquire))
+            {
+                monitor_enter_slow(owner);
+            }
         }
 
+        // Exits the lock of the object.
+        error_t monitor_exit()
+        {
+            uint64_t owner = current_lock_owner();
+            uint64_t word = _lock_word.load(std::memory_order_relaxed);
+            if ((word & (LOCK_OWNER_MASK | LOCK_INFLATED)) != owner ||
+                (word & LOCK_COUNT_MASK) == 0)
+            {
+                return monitor_exit_slow(word);
+            }
+
+            if ((word & LOCK_COUNT_MASK) == LOCK_RECURSION)
+            {
+                _lock_word.store(0, std::memory_order_release);
+            }
+            else
+            {
+                _lock_word.store(word - LOCK_RECURSION,
+                    std::memory_order_relaxed);
+            }
+            return RETURN_OK;
+        }
+
+        // Enters the lock, if it is free or owned by the current thread.
+        bool monitor_try_enter();
+
+        // Waiting and notification need the monitor, the thin lock of the
+        // current thread is inflated.
+        error_t monitor_wait(jlong ms);
+        error_t monitor_notify();
+        error_t monitor_notify_all();
+
         // Getters
         Class *type() const { return _type; }
         uint32_t memory_size() const { return _memory_size; }
         uint8_t *memory() const { return _memory; }
-        bool used() const { return _used; }
+        bool finalizing() const { return _finalizing; }
 
         // Setters
         void set_memory_size(
             uint32_t memory_size) { _memory_size = memory_size; }
         void set_memory(uint8_t *memory) { _memory = memory; }
-        void set_used(bool used) { _used = used; }
+        void set_finalizing(bool finalizing) { _finalizing = finalizing; }
 
     protected:
 
@@ -98,11 +143,37 @@ namespace coldspot
 
     private:
 
+        // Reads the memory in compiled code
+        friend class TemplateCompiler;
+
+        // The lock word is 0 if the object is unlocked. A thin lock holds the
+        // id of the owning thread in the upper half and the recursion count
+        // above the lowest bit. The inflated lock points to the monitor and
+        // has the lowest bit set, it stays inflated.
+        static const uint64_t LOCK_INFLATED = 1;
+        static const uint64_t LOCK_RECURSION = 2;
+        static const uint64_t LOCK_COUNT_MASK = 0xFFFFFFFE;
+        static const uint64_t LOCK_OWNER_MASK = 0xFFFFFFFF00000000;
+
+        static uint64_t current_lock_owner()
+        {
+            return _current_thread != 0
+                   ? (uint64_t) _current_thread->id() << 32 : 0;
+        }
+
+        // Contended locking, inflation and the inflated lock.
+        void monitor_enter_slow(uint64_t owner);
+        error_t monitor_exit_slow(uint64_t word);
+        Monitor *inflate(uint64_t word);
+        error_t owned_monitor(Monitor **monitor);
+
         Class *_type;
-        Monitor *_monitor;
+        std::atomic<uint64_t> _lock_word;
         uint32_t _memory_size;
         uint8_t *_memory;
-        bool _used;
+
+        // Handed to the finalizer, the object is released afterwards
+        bool _finalizing;
     };
 
 }
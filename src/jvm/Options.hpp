@@ -41,10 +41,25 @@ namespace coldspot
         bool verboseExecute;
         bool verboseJNI;
         bool verboseDebug;
+        bool threadedInterpreter;
+        bool interpretOnly;
+        bool profileMethods;
+        bool profileInlineCaches;
+        bool profileNGrams;
+        uint32_t parallelGCThreads;
+        bool concurrentGC;
 
         Options() : verboseClass(false), verboseGC(false),
                     verboseExecute(false), verboseJNI(false),
-                    verboseDebug(false)
+                    verboseDebug(false),
+#if defined(COLDSPOT_THREADED_INTERPRETER)
+                    threadedInterpreter(true),
+#else
+                    threadedInterpreter(false),
+#endif
+                    interpretOnly(false), profileMethods(false),
+                    profileInlineCaches(false), profileNGrams(false),
+                    parallelGCThreads(0), concurrentGC(false)
         {
         }
 
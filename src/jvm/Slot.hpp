@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_SLOT_HPP_
+#define COLDSPOT_JVM_SLOT_HPP_
+
+#include <cstdint>
+
+#include "Value.hpp"
+
+namespace coldspot
+{
+
+#if defined(COLDSPOT_UNTAGGED_SLOTS)
+
+    // Represents a local-variable or operand without a type-tag.
+    // The garbage-collector finds the references by the reference-maps
+    // of the executing method.
+    class Slot
+    {
+    public:
+
+        Slot() : _value(0) { }
+        Slot(Value value) : _value(value.value()) { }
+
+        // Constructors with implicit conversion
+        Slot(jboolean b) : _value(b) { }
+        Slot(jbyte b) : _value(b) { }
+        Slot(jchar c) : _value(c) { }
+        Slot(jshort s) : _value(s) { }
+        Slot(jint i) : _value(i) { }
+        Slot(jfloat f) : _value(*(reinterpret_cast<uint32_t *>(&f))) { }
+        Slot(jlong l) : _value(l) { }
+        Slot(jdouble d) : _value(*(reinterpret_cast<uint64_t *>(&d))) { }
+        Slot(uint32_t r) : _value(r) { }
+        Slot(Object *o) : _value(reinterpret_cast<uint64_t>(o)) { }
+
+        // Getters
+        uint64_t &value() { return _value; }
+
+        // Converters
+        jboolean as_boolean() { return static_cast<jboolean>(_value); }
+        jbyte as_byte() { return static_cast<jbyte>(_value); }
+        jchar as_char() { return static_cast<jchar>(_value); }
+        jshort as_short() { return static_cast<jshort>(_value); }
+        jint as_int() { return static_cast<jint>(_value); }
+        jfloat as_float() { return *(reinterpret_cast<jfloat *>(&_value)); }
+        jlong as_long() { return static_cast<jlong>(_value); }
+        jdouble as_double() { return *(reinterpret_cast<jdouble *>(&_value)); }
+        uint32_t as_return_addr() { return static_cast<uint32_t>(_value); }
+        Object *as_object() { return reinterpret_cast<Object *>(_value); }
+        Array *as_array() { return reinterpret_cast<Array *>(_value); }
+
+    private:
+
+        // Reads and writes the value in compiled code
+        friend class TemplateCompiler;
+
+        uint64_t _value;
+    };
+
+    // Restores the value of a slot with the type known by the caller.
+    inline Value to_value(Slot slot, Type type)
+    {
+        return Value(type, slot.value());
+    }
+
+#else
+
+    // Local-variables and operands carry their type-tag.
+    using Slot = Value;
+
+    inline Value to_value(const Slot &slot, Type)
+    {
+        return slot;
+    }
+
+#endif
+
+}
+
+#endif
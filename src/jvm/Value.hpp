@@ -109,6 +109,9 @@ namespace coldspot
 
     private:
 
+        // Reads and writes the members in compiled code
+        friend class TemplateCompiler;
+
         Type _type;
         uint64_t _value;
     };
@@ -39,7 +39,8 @@ namespace coldspot
     }
 
     VirtualMachine::VirtualMachine() : _non_daemon_thread_count(0), _options(0),
-                                       _stack_overflow_error(0)
+                                       _stack_overflow_error(0),
+                                       _out_of_memory_error(0)
     {
         _vm = this;
 
@@ -113,6 +114,21 @@ namespace coldspot
     {
         wait_for_threads();
 
+        if (_options->profileMethods)
+        {
+            MethodProfiler::print_statistics(_class_Loader);
+        }
+
+        if (_options->profileInlineCaches)
+        {
+            InlineCache::print_statistics(_class_Loader);
+        }
+
+        if (_options->profileNGrams)
+        {
+            NGramProfiler::print_statistics();
+        }
+
         _jdk_handler->release();
 
         release_java_vm();
@@ -303,6 +319,10 @@ namespace coldspot
         // Unlock the mutex for WAITING state
         thread->wait_mutex().unlock();
 
+        // Return the allocation buffer
+        _memory_manager->heap_space().retire_tlab(thread);
+        thread->satb_queue().flush();
+
         // Detach thread from native thread
         thread->detach_native();
 
@@ -332,6 +352,8 @@ namespace coldspot
 
     void VirtualMachine::resume_vm_threads()
     {
+        _safepoint_poll.store(false);
+
         for (auto thread : *_threads)
         {
             bool vmThreadType = thread->type() == THREADTYPE_VM ||
@@ -344,8 +366,10 @@ namespace coldspot
                 thread->block_mutex().unlock();
 
                 // Remove the waiting-condition
+                thread->wait_mutex().lock();
                 thread->wait_condition().set_wait_requested(false);
                 thread->wait_condition().notify_all();
+                thread->wait_mutex().unlock();
             }
         }
     }
@@ -370,6 +394,9 @@ namespace coldspot
             }
         }
 
+        // Arm the poll after the requests are set
+        _safepoint_poll.store(true);
+
         // Wait for all vm-threads to reach their safepoints or get blocked
         for (auto thread : *_threads)
         {
@@ -417,6 +444,15 @@ namespace coldspot
         errorValue = Object::new_object_default(clazz, &_stack_overflow_error);
         RETURN_ON_FAIL(errorValue)
 
+        // Create java/lang/OutOfMemoryError, allocating it after the heap
+        // is exhausted would fail
+        errorValue = _class_Loader->load_class(CLASSNAME_OUTOFMEMORYERROR,
+            &clazz);
+        RETURN_ON_FAIL(errorValue)
+
+        errorValue = Object::new_object_default(clazz, &_out_of_memory_error);
+        RETURN_ON_FAIL(errorValue)
+
         return RETURN_OK;
     }
 
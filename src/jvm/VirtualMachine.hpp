@@ -132,6 +132,7 @@ namespace coldspot
         JNIEnv *jni_interface() const { return _jni_interface; }
         HashMap<String, Object *> &string_pool() { return _string_pool; };
         Object *stack_overflow_error() const { return _stack_overflow_error; }
+        Object *out_of_memory_error() const { return _out_of_memory_error; }
 
     private:
 
@@ -161,8 +162,9 @@ namespace coldspot
         // Global pool of string literals
         HashMap<String, Object *> _string_pool;
 
-        // Pre allocated error object.
+        // Pre allocated error objects.
         Object *_stack_overflow_error;
+        Object *_out_of_memory_error;
 
         // Creates the java-objects for error handling.
         error_t create_error_objects();
@@ -181,6 +181,35 @@ namespace coldspot
     }
 
 
+    Method *Class::get_virtual_method(Method *method)
+    {
+        // Virtual class-method
+        jint index = method->vtable_index();
+        if (index >= 0)
+        {
+            return index < vtable.length() ? vtable[index] : 0;
+        }
+
+        // Interface-method
+        index = method->itable_index();
+        if (index >= 0)
+        {
+            Class *interfaceClass = method->declaring_class();
+            for (uint16_t i = 0; i < itables.length(); ++i)
+            {
+                if (itables[i].interface_class == interfaceClass)
+                {
+                    return itables[i].methods[index];
+                }
+            }
+            return 0;
+        }
+
+        // Private, static and constructor-methods are not dispatched
+        return method;
+    }
+
+
     bool Class::is_implementing(Class *clazz)
     {
         auto begin = interface_classes.begin();
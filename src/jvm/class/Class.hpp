@@ -22,12 +22,16 @@
 #ifndef COLDSPOT_JVM_CLASS_CLASS_HPP_
 #define COLDSPOT_JVM_CLASS_CLASS_HPP_
 
+#include <atomic>
+
 #include <jvm/class/Signature.hpp>
 #include <jvm/common/HashMap.hpp>
 #include <jvm/common/List.hpp>
 #include <jvm/common/SmartArray.hpp>
 #include <jvm/common/String.hpp>
 #include <jvm/jdk/Global.hpp>
+#include <jvm/thread/Condition.hpp>
+#include <jvm/thread/Mutex.hpp>
 #include <jvm/Error.hpp>
 #include <jvm/Value.hpp>
 #include <jvm/Array.hpp>
@@ -41,6 +45,28 @@ namespace coldspot
     class Field;
     class Method;
     class RunTimeConstantPoolEntry;
+    class Thread;
+
+    // States of the initialization of a class (JVMS 5.5).
+    enum ClassState
+    {
+        CLASSSTATE_UNINITIALIZED,
+        CLASSSTATE_INITIALIZING,
+        CLASSSTATE_INITIALIZED,
+        CLASSSTATE_ERRONEOUS
+    };
+
+    // Methods of a class, that implement the methods of an interface.
+    // The methods are indexed by the itable-index of the interface-method.
+    class InterfaceTable
+    {
+    public:
+
+        Class *interface_class;
+        SmartArray<Method *, uint16_t> methods;
+
+        InterfaceTable() : interface_class(0) { }
+    };
 
     class Class
     {
@@ -93,6 +119,20 @@ namespace coldspot
         HashMap<Signature, Field *> fields;
         HashMap<Signature, Method *> methods;
 
+        // Virtual methods by their vtable-index, inherited ones first
+        SmartArray<Method *, uint16_t> vtable;
+
+        // Method tables of all implemented interfaces
+        SmartArray<InterfaceTable, uint16_t> itables;
+
+        // Offsets of all reference fields in the objects, inherited ones
+        // first, and whether the elements of the arrays are references
+        SmartArray<uint32_t, uint16_t> reference_offsets;
+        bool reference_array;
+
+        // Objects override the finalize-method of java/lang/Object
+        bool finalizable;
+
         // Static field storage
         uint32_t static_memory_size;
         uint8_t *static_memory;
@@ -101,13 +141,22 @@ namespace coldspot
 
         // State of initialization
         bool resolved;
-        bool initialized;
         bool primitive;
 
+        // The state is published with release, so that threads seeing
+        // the class initialized see its static fields too. Threads wait
+        // on the condition while another thread runs the initializer.
+        std::atomic<ClassState> state;
+        Thread *initializing_thread;
+        Mutex initialization_mutex;
+        Condition initialization_condition;
+
         Class() : class_file(0), super_class(0), class_loader(0), object(0),
                   component_type(0), type(TYPE_VOID), type_size(0),
-                  object_size(0), static_memory_size(0), static_memory(0),
-                  resolved(false), initialized(false), primitive(false) { }
+                  object_size(0), reference_array(false), finalizable(false),
+                  static_memory_size(0), static_memory(0),
+                  resolved(false), primitive(false),
+                  state(CLASSSTATE_UNINITIALIZED), initializing_thread(0) { }
         ~Class();
 
         // Member access without lookup.
@@ -123,6 +172,17 @@ namespace coldspot
         error_t get_field(const Signature &signature, Field **field);
         error_t get_method(const Signature &signature, Method **method);
 
+        // Returns the method that is invoked for the resolved method
+        // on objects of this class, 0 if there is no implementation.
+        Method *get_virtual_method(Method *method);
+
+        // Checks the state of initialization without locking.
+        bool is_initialized() const
+        {
+            return state.load(std::memory_order_acquire) ==
+                   CLASSSTATE_INITIALIZED;
+        }
+
         // Type checking.
         bool is_abstract();
         bool is_array();
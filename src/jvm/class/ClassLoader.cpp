@@ -131,7 +131,7 @@ namespace coldspot
 
         // Create basics
         local <Class> localClass(new Class);
-        localClass->initialized = true;
+        localClass->state.store(CLASSSTATE_INITIALIZED);
         localClass->class_loader = classLoader;
         localClass->name = name;
         localClass->type = TYPE_REFERENCE;
@@ -142,6 +142,8 @@ namespace coldspot
         error_t errorValue = resolve_by_descriptor(name, index, classLoader,
             &localClass->component_type);
         RETURN_ON_FAIL_UNLOCK(errorValue, _load_mutex)
+        localClass->reference_array =
+            !localClass->component_type->is_primitive();
 
         // Load super-class
         errorValue = load_class(CLASSNAME_OBJECT, &localClass->super_class);
@@ -160,6 +162,9 @@ namespace coldspot
         localClass->interface_classes.put(CLASSNAME_SERIALIZABLE,
             serializableClass);
 
+        // Arrays inherit the methods of java/lang/Object
+        build_method_tables(localClass.get());
+
         // Register class
         _loaded_classes.put(ClassIdentifier(classLoader, name),
             localClass.get());
@@ -188,7 +193,7 @@ namespace coldspot
 
         // Create class
         local <Class> localClass(new Class);
-        localClass->initialized = true;
+        localClass->state.store(CLASSSTATE_INITIALIZED);
         localClass->name = name;
         localClass->primitive = true;
 
@@ -300,6 +305,9 @@ namespace coldspot
             return errorValue;
         }
 
+        // Cached call-targets may be outdated by the new class
+        InlineCache::invalidate_all();
+
         // If java/lang/Class is loaded, create class-objects
         // for all previously loaded classes
         if (name == CLASSNAME_CLASS)
@@ -326,39 +334,137 @@ namespace coldspot
     // TODO see https://docs.oracle.com/javase/specs/jvms/se7/html/jvms-5.html#jvms-5.5
     error_t ClassLoader::initialize_class(Class *clazz)
     {
-        _load_mutex.lock();
-
         // Nothing to do if the class is already initialized
-        if (clazz->initialized)
+        if (clazz->is_initialized())
         {
-            RETURN_UNLOCK(RETURN_OK, _load_mutex)
+            return RETURN_OK;
+        }
+
+        // Wait while another thread initializes the class
+        clazz->initialization_mutex.lock();
+        while (clazz->state.load(std::memory_order_relaxed) ==
+               CLASSSTATE_INITIALIZING &&
+               clazz->initializing_thread != _current_thread)
+        {
+            clazz->initialization_condition.wait(clazz->initialization_mutex);
+
+            // A collection may have skipped the waiting thread, poll without
+            // the lock, threads blocked on it can't reach their safepoints
+            if (_current_thread != 0)
+            {
+                clazz->initialization_mutex.unlock();
+                _current_thread->safepoint();
+                clazz->initialization_mutex.lock();
+            }
         }
 
-        // Mark as initialized
-        clazz->initialized = true;
+        switch (clazz->state.load(std::memory_order_relaxed))
+        {
+            // Initialized meanwhile or requested recursively
+            case CLASSSTATE_INITIALIZED:
+            case CLASSSTATE_INITIALIZING:
+                RETURN_UNLOCK(RETURN_OK, clazz->initialization_mutex)
+
+            // A previous initialization failed
+            case CLASSSTATE_ERRONEOUS:
+            {
+                clazz->initialization_mutex.unlock();
+                String javaName = Class::to_java_class_name(clazz->name);
+                _current_executor->throw_exception(
+                    CLASSNAME_NOCLASSDEFFOUNDERROR, javaName.c_str());
+                return RETURN_EXCEPTION;
+            }
+
+            default:
+                break;
+        }
+
+        clazz->state.store(CLASSSTATE_INITIALIZING, std::memory_order_relaxed);
+        clazz->initializing_thread = _current_thread;
+        clazz->initialization_mutex.unlock();
 
         // If the class has a super-class, initialize it first
+        error_t errorValue = RETURN_OK;
         if (clazz->super_class != 0)
         {
-            error_t errorValue = initialize_class(clazz->super_class);
-            RETURN_ON_FAIL_UNLOCK(errorValue, _load_mutex)
+            errorValue = initialize_class(clazz->super_class);
         }
 
-        LOG_DEBUG_VERBOSE(Class,
-            "initialize class '" << clazz->name.c_str() << "'")
-
         // Find and invoke static initialization method if it exists
-        Method *method;
-        error_t errorValue = clazz->get_declared_method(
-            Signature("()V", METHODNAME_STATICINIT), &method);
         if (errorValue == RETURN_OK)
         {
-            Value value;
-            errorValue = method->invoke(0, 0, &value);
-            RETURN_ON_FAIL_UNLOCK(errorValue, _load_mutex)
+            LOG_DEBUG_VERBOSE(Class,
+                "initialize class '" << clazz->name.c_str() << "'")
+
+            Method *method;
+            if (clazz->get_declared_method(
+                Signature("()V", METHODNAME_STATICINIT), &method) == RETURN_OK)
+            {
+                Value value;
+                errorValue = method->invoke(0, 0, &value);
+                if (errorValue != RETURN_OK &&
+                    _current_executor->initializer_exception() != 0)
+                {
+                    errorValue = throw_initializer_exception();
+                }
+            }
         }
 
-        RETURN_UNLOCK(RETURN_OK, _load_mutex)
+        // Publish the result and wake up the waiting threads
+        clazz->initialization_mutex.lock();
+        clazz->initializing_thread = 0;
+        clazz->state.store(errorValue == RETURN_OK ? CLASSSTATE_INITIALIZED
+                                                   : CLASSSTATE_ERRONEOUS,
+            std::memory_order_release);
+        clazz->initialization_condition.notify_all();
+        clazz->initialization_mutex.unlock();
+
+        return errorValue;
+    }
+
+
+    error_t ClassLoader::throw_initializer_exception()
+    {
+        // The exception stays reachable through the executor meanwhile
+        Object *exception = _current_executor->initializer_exception();
+
+        Class *errorClass;
+        error_t errorValue = load_class(CLASSNAME_ERROR, &errorClass);
+        if (errorValue == RETURN_OK && exception->type() != errorClass &&
+            !exception->type()->is_subclass_of(errorClass))
+        {
+            Class *wrapperClass;
+            errorValue = load_class(CLASSNAME_EXCEPTIONININITIALIZERERROR,
+                &wrapperClass);
+            if (errorValue == RETURN_OK)
+            {
+                errorValue = initialize_class(wrapperClass);
+            }
+
+            Method *constructor;
+            if (errorValue == RETURN_OK)
+            {
+                errorValue = wrapperClass->get_method(
+                    Signature("(Ljava/lang/Throwable;)V",
+                        METHODNAME_CONSTRUCTOR), &constructor);
+            }
+
+            if (errorValue == RETURN_OK)
+            {
+                Value exceptionParameter = exception;
+                errorValue = Object::new_object(constructor,
+                    &exceptionParameter, &exception);
+            }
+        }
+
+        _current_executor->set_initializer_exception(0);
+        if (errorValue != RETURN_OK)
+        {
+            return errorValue;
+        }
+
+        _current_executor->throw_exception(exception);
+        return RETURN_EXCEPTION;
     }
 
 
@@ -401,7 +507,7 @@ namespace coldspot
             clazz->object = javaClass;
             _object_mapping.put(javaClass, clazz);
 
-            if (classClass->initialized)
+            if (classClass->is_initialized())
             {
                 Method *method;
                 errorValue = classClass->get_method(
@@ -426,12 +532,240 @@ namespace coldspot
         error_t errorValue = resolve_class(clazz);
         RETURN_ON_FAIL(errorValue);
 
+        layout_fields(clazz);
         prepare_class(clazz);
+        build_method_tables(clazz);
+
+        // Objects of classes without a finalize-method are released by
+        // the gc directly
+        if (clazz->super_class != 0)
+        {
+            clazz->finalizable = clazz->super_class->finalizable;
+
+            auto &declaredMethods = clazz->declared_methods;
+            for (uint16_t i = 0; i < declaredMethods.length(); ++i)
+            {
+                const Signature &signature = declaredMethods[i]->signature();
+                if (!declaredMethods[i]->isStatic() &&
+                    signature.name == METHODNAME_FINALIZE &&
+                    signature.descriptor == "()V")
+                {
+                    clazz->finalizable = true;
+                }
+            }
+        }
 
         return RETURN_OK;
     }
 
 
+    void ClassLoader::build_method_tables(Class *clazz)
+    {
+        auto &declaredMethods = clazz->declared_methods;
+
+        // Interface-methods are indexed by their slot
+        if (clazz->class_file != 0 && clazz->is_interface())
+        {
+            for (uint16_t i = 0; i < declaredMethods.length(); ++i)
+            {
+                Method *method = declaredMethods[i];
+                if (!method->isStatic() &&
+                    method->signature().name != METHODNAME_STATICINIT)
+                {
+                    method->set_itable_index(i);
+                }
+            }
+            return;
+        }
+
+        // Overriding methods take the vtable-index of the inherited method,
+        // all other virtual methods are appended
+        Class *superClass = clazz->super_class;
+        uint16_t inheritedLength = superClass ? superClass->vtable.length() : 0;
+        uint16_t length = inheritedLength;
+
+        for (uint16_t i = 0; i < declaredMethods.length(); ++i)
+        {
+            Method *method = declaredMethods[i];
+            if (method->isStatic() || method->isPrivate() ||
+                method->signature().name == METHODNAME_CONSTRUCTOR ||
+                method->signature().name == METHODNAME_STATICINIT)
+            {
+                continue;
+            }
+
+            jint index = -1;
+            for (uint16_t j = 0; j < inheritedLength; ++j)
+            {
+                if (superClass->vtable[j]->signature() == method->signature())
+                {
+                    index = j;
+                    break;
+                }
+            }
+
+            method->set_vtable_index(index >= 0 ? index : length++);
+        }
+
+        clazz->vtable.init(length);
+        for (uint16_t i = 0; i < inheritedLength; ++i)
+        {
+            clazz->vtable[i] = superClass->vtable[i];
+        }
+        for (uint16_t i = 0; i < declaredMethods.length(); ++i)
+        {
+            Method *method = declaredMethods[i];
+            if (method->vtable_index() >= 0)
+            {
+                clazz->vtable[method->vtable_index()] = method;
+            }
+        }
+
+        // Each itable maps the interface-methods to the implementing methods
+        List<Class *> interfaces;
+        collect_interfaces(clazz, interfaces);
+
+        clazz->itables.init(interfaces.size());
+        uint16_t tableIndex = 0;
+        for (Class *interfaceClass : interfaces)
+        {
+            InterfaceTable &table = clazz->itables[tableIndex++];
+            table.interface_class = interfaceClass;
+
+            auto &interfaceMethods = interfaceClass->declared_methods;
+            table.methods.init(interfaceMethods.length());
+            for (uint16_t i = 0; i < interfaceMethods.length(); ++i)
+            {
+                Method *interfaceMethod = interfaceMethods[i];
+                if (interfaceMethod->itable_index() < 0)
+                {
+                    continue;
+                }
+
+                for (uint16_t j = 0; j < clazz->vtable.length(); ++j)
+                {
+                    if (clazz->vtable[j]->signature() ==
+                        interfaceMethod->signature())
+                    {
+                        table.methods[i] = clazz->vtable[j];
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+
+    void ClassLoader::collect_interfaces(Class *clazz,
+        List<Class *> &interfaces)
+    {
+        auto begin = clazz->interface_classes.begin();
+        auto end = clazz->interface_classes.end();
+
+        while (begin != end)
+        {
+            Class *interfaceClass = begin->value;
+            if (interfaces.find(interfaceClass) == interfaces.end())
+            {
+                interfaces.addBack(interfaceClass);
+                collect_interfaces(interfaceClass, interfaces);
+            }
+
+            ++begin;
+        }
+
+        if (clazz->super_class != 0)
+        {
+            collect_interfaces(clazz->super_class, interfaces);
+        }
+    }
+
+
+    // Order of the instance fields in the layout
+    static uint8_t field_rank(Field *field)
+    {
+        Type type = field->type()->type;
+        if (type == TYPE_LONG || type == TYPE_DOUBLE)
+        {
+            return 0;
+        }
+
+        if (type == TYPE_REFERENCE)
+        {
+            return 1;
+        }
+
+        switch (field->type()->type_size)
+        {
+            case 4:
+                return 2;
+            case 2:
+                return 3;
+            default:
+                return 4;
+        }
+    }
+
+
+    void ClassLoader::layout_fields(Class *clazz)
+    {
+        // The fields of the class follow the inherited ones. Wide fields
+        // come first, then references, ints, shorts and bytes, so that
+        // only the start of the class needs padding.
+        Class *superClass = clazz->super_class;
+        uint32_t offset = superClass != 0 ? superClass->object_size : 0;
+
+        // The reference-map extends the inherited one
+        auto &declaredFields = clazz->declared_fields;
+        uint16_t inheritedReferences = 0;
+        if (superClass != 0)
+        {
+            inheritedReferences = superClass->reference_offsets.length();
+        }
+
+        uint16_t references = inheritedReferences;
+        for (uint16_t i = 0; i < declaredFields.length(); ++i)
+        {
+            Field *field = declaredFields[i];
+            if (!field->is_static() && field_rank(field) == 1)
+            {
+                ++references;
+            }
+        }
+
+        clazz->reference_offsets.init(references);
+        for (uint16_t i = 0; i < inheritedReferences; ++i)
+        {
+            clazz->reference_offsets[i] = superClass->reference_offsets[i];
+        }
+
+        references = inheritedReferences;
+        for (uint8_t rank = 0; rank <= 4; ++rank)
+        {
+            for (uint16_t i = 0; i < declaredFields.length(); ++i)
+            {
+                Field *field = declaredFields[i];
+                if (field->is_static() || field_rank(field) != rank)
+                {
+                    continue;
+                }
+
+                uint8_t size = field->type()->type_size;
+                offset = (offset + size - 1) / size * size;
+                field->set_offset(offset);
+                offset += size;
+
+                if (rank == 1)
+                {
+                    clazz->reference_offsets[references++] = field->offset();
+                }
+            }
+        }
+
+        clazz->object_size = offset;
+    }
+
+
     void ClassLoader::prepare_class(Class *clazz)
     {
         uint32_t memory_size = 0;
@@ -469,7 +803,6 @@ namespace coldspot
             RETURN_ON_FAIL(errorValue);
 
             clazz->super_class = superClass;
-            clazz->object_size += superClass->object_size;
         }
 
         // Resolve interface-classes
@@ -561,11 +894,6 @@ namespace coldspot
                     field.get());
                 RETURN_ON_FAIL(errorValue);
 
-                if (!field->is_static())
-                {
-                    clazz->object_size += field->type()->type_size;
-                }
-
                 uint16_t slot = 0;
                 for (uint16_t i = 0; i < clazz->declared_fields.length(); ++i)
                 {
@@ -622,8 +950,6 @@ namespace coldspot
                     methodInfo, method.get());
                 RETURN_ON_FAIL(errorValue);
 
-                method->set_frame_size(Frame::size(method.get()));
-
                 errorValue = resolve_method_signature(clazz, methodInfo,
                     method.get());
                 RETURN_ON_FAIL(errorValue);
@@ -695,6 +1021,22 @@ namespace coldspot
             method->parameter_types().addBack(parameterType);
         }
 
+        // Types of the arguments on the operand-stack of the caller
+        auto &parameterTypes = method->parameter_types();
+        auto &argumentTypes = method->argument_types();
+        argumentTypes.init(
+            parameterTypes.size() + (method->isStatic() ? 0 : 1));
+
+        uint16_t argument = 0;
+        if (!method->isStatic())
+        {
+            argumentTypes[argument++] = TYPE_REFERENCE;
+        }
+        for (auto parameterType : parameterTypes)
+        {
+            argumentTypes[argument++] = parameterType->type;
+        }
+
         Class *returnType;
         errorValue = resolve_by_descriptor(descriptor, ++index,
             clazz->class_loader, &returnType);
@@ -818,7 +1160,8 @@ namespace coldspot
                 CodeAttribute *codeAttribute = (CodeAttribute *) attribute;
 
                 // Resolve basics
-                method->set_code(codeAttribute->code);
+                method->set_bytecode(codeAttribute->code,
+                    codeAttribute->codeLength);
                 method->set_locals_count(codeAttribute->maxLocals);
                 method->set_operands_count(codeAttribute->maxStack);
 
@@ -23,6 +23,7 @@
 #define COLDSPOT_JVM_CLASS_CLASSLOADER_HPP_
 
 #include <jvm/common/HashMap.hpp>
+#include <jvm/common/List.hpp>
 #include <jvm/common/Pair.hpp>
 #include <jvm/common/String.hpp>
 
@@ -48,6 +49,8 @@ namespace coldspot
     {
     public:
 
+        ClassLoader() { }
+
         ~ClassLoader();
 
         // Loads a class with the bootstrap loader or the specified loader.
@@ -67,12 +70,14 @@ namespace coldspot
         error_t define_class(const String &name, Object *classLoader,
             ClassFileInputStream *inputStream, Class **clazz);
 
-        // Initializes the class if it is not already initialized.
+        // Initializes the class if it is not already initialized. Returns
+        // without waiting if the current thread is initializing the class.
         error_t initialize_class(Class *clazz);
 
         // Getters.
         HashMap<Object *, Class *> &object_mapping() { return _object_mapping; }
         HashMap<ClassIdentifier, Class *> &loaded_classes() { return _loaded_classes; }
+        Mutex &load_mutex() { return _load_mutex; }
 
     private:
 
@@ -80,6 +85,10 @@ namespace coldspot
         HashMap<Object *, Class *> _object_mapping;
         HashMap<ClassIdentifier, Class *> _loaded_classes;
 
+        // Throws the exception of a failed static initializer, exceptions
+        // that are no errors are wrapped into an ExceptionInInitializerError.
+        error_t throw_initializer_exception();
+
         // Parses the class file and associates it with the class.
         error_t read_classfile(Class *clazz,
             ClassFileInputStream *input_stream);
@@ -90,9 +99,21 @@ namespace coldspot
         // Linking resolves and prepares the class.
         error_t link_class(Class *clazz);
 
+        // Assigns the offsets of the instance fields once,
+        // the size of the objects follows from them.
+        void layout_fields(Class *clazz);
+
         // Sets all static fields of the class to their default-values.
         void prepare_class(Class *clazz);
 
+        // Builds the vtable and the itables of the class,
+        // or assigns the itable-indices of an interface.
+        void build_method_tables(Class *clazz);
+
+        // Collects all interfaces the class implements, including
+        // super-interfaces and interfaces of super-classes.
+        void collect_interfaces(Class *clazz, List<Class *> &interfaces);
+
         // Resolves the class and it elements
         error_t resolve_class(Class *clazz);
         error_t resolve_field(Class *clazz, const Signature &signature);
@@ -19,6 +19,8 @@
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <type_traits>
+
 #include <jvm/Global.hpp>
 
 namespace coldspot
@@ -43,7 +45,7 @@ namespace coldspot
 
     Value Field::get_static() const
     {
-        if (!_declaring_class->initialized)
+        if (!_declaring_class->is_initialized())
         {
             _vm->class_loader()->initialize_class(_declaring_class);
         }
@@ -54,7 +56,7 @@ namespace coldspot
 
     void Field::set_static(Value value) const
     {
-        if (!_declaring_class->initialized)
+        if (!_declaring_class->is_initialized())
         {
             _vm->class_loader()->initialize_class(_declaring_class);
         }
@@ -109,7 +111,18 @@ namespace coldspot
 
     void Field::set(Object *object, Value value)
     {
+        if (!_type->is_primitive())
+        {
+            HeapSpace::pre_write_barrier(
+                *((Object **) (object->memory() + _offset)));
+        }
+
         value_to_memory(object->memory(), value);
+
+        if (!_type->is_primitive())
+        {
+            HeapSpace::write_barrier(object);
+        }
     }
 
 
@@ -135,7 +148,18 @@ namespace coldspot
     template<typename T>
     void Field::set(Object *object, T value)
     {
+        if (std::is_pointer<T>::value)
+        {
+            HeapSpace::pre_write_barrier(
+                *((Object **) (object->memory() + _offset)));
+        }
+
         *((T *) (object->memory() + _offset)) = value;
+
+        if (std::is_pointer<T>::value)
+        {
+            HeapSpace::write_barrier(object);
+        }
     }
 
 #define EXPLICIT(type) template void Field::set<type>(Object *object, type value);
@@ -87,31 +87,18 @@ namespace coldspot
             return RETURN_EXCEPTION;
         }
 
-        // Search in the current object and all super-objects for the method to call
-        error_t errorValue;
-        Signature signature((*method)->_signature);
-        Class *type = object->type();
-        do
-        {
-            Method *currentMethod;
-            errorValue = type->get_declared_method(signature, &currentMethod);
-            if (errorValue == RETURN_OK)
-            {
-                (*clazz) = type;
-                (*method) = currentMethod;
-                break;
-            }
-            type = type->super_class;
-        } while (type);
-
-        // Throw exception if the method does not exist
-        if (errorValue != RETURN_OK)
+        // Select the implementation through the method-tables of the object
+        Method *target = object->type()->get_virtual_method(*method);
+        if (target == 0 || target->isAbstract())
         {
             _current_executor->throw_exception(CLASSNAME_ABSTRACTMETHODERROR,
-                signature.name.c_str());
+                (*method)->_signature.name.c_str());
             return RETURN_EXCEPTION;
         }
 
+        (*clazz) = target->declaring_class();
+        (*method) = target;
+
         return RETURN_OK;
     }
 
@@ -121,6 +108,9 @@ namespace coldspot
         DELETE_CONTAINER_OBJECTS(_exception_handlers)
         DELETE_OBJECT(_debug_infos)
         DELETE_OBJECT(_native_call)
+        delete[] _code.load();
+        DELETE_ARRAY(_reference_maps)
+        delete _compiled_method.load();
     }
 
 
@@ -181,27 +171,35 @@ namespace coldspot
     error_t Method::invokeJava(Object *object, Value *parameters,
         Value *returnValue)
     {
-        // Create frame
-        auto &frames = _current_executor->frames();
-        uint8_t *frameMemory = frames.push(Frame::size(this));
-        Frame *frame = Frame::create(FRAMETYPE_JAVA, _declaring_class, this,
-            frameMemory);
+        Frame *frame;
+        error_t errorValue = push_frame(object, parameters, &frame);
+        RETURN_ON_FAIL(errorValue);
+
+        // Execute method
+        return _current_executor->execute(frame, returnValue);
+    }
 
-        if (_signature.name == "startsWith")
-        { ;
-        }
+
+    error_t Method::push_frame(Object *object, Value *parameters,
+        Frame **frame)
+    {
+        error_t errorValue = create_frame(0, frame);
+        RETURN_ON_FAIL(errorValue);
+
+        Slot *localVariables = (*frame)->localVariables;
+        memset((void *) localVariables, 0, sizeof(Slot) * _locals_count);
 
         // Copy object to the local variables
         uint32_t index = 0;
         if (object != 0)
         {
-            frame->localVariables[index++] = object;
+            localVariables[index++] = object;
         }
 
         // Copy parameters to the local variables
         for (uint32_t i = 0; i < _parameter_types.size(); ++i)
         {
-            frame->localVariables[index++] = parameters[i];
+            localVariables[index++] = parameters[i];
 
             // Long and double need two indices
             Type type = parameters[i].type();
@@ -211,21 +209,89 @@ namespace coldspot
             }
         }
 
-        // Enter monitor for synchronized methods
+        enter_monitor(object);
+
+        return RETURN_OK;
+    }
+
+
+    error_t Method::push_frame(Slot *arguments, Frame **frame)
+    {
+        error_t errorValue = create_frame(arguments, frame);
+        RETURN_ON_FAIL(errorValue);
+
+        uint32_t count = _argument_types.length();
+
+        // Long and double need two indices, so the arguments are spread
+        // from the last one, to not overwrite the ones not moved yet
+        uint32_t wideCount = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Type type = _argument_types[i];
+            if (type == TYPE_LONG || type == TYPE_DOUBLE)
+            {
+                ++wideCount;
+            }
+        }
+
+        uint32_t argumentsSize = count + wideCount;
+        uint32_t index = argumentsSize;
+        for (uint32_t i = count; wideCount != 0; --i)
+        {
+            Slot argument = arguments[i - 1];
+            Type type = _argument_types[i - 1];
+            if (type == TYPE_LONG || type == TYPE_DOUBLE)
+            {
+                arguments[--index] = Slot();
+                --wideCount;
+            }
+            arguments[--index] = argument;
+        }
+
+        // Clear the remaining local variables
+        memset((void *) (arguments + argumentsSize), 0,
+            sizeof(Slot) * (_locals_count - argumentsSize));
+
+        enter_monitor(isStatic() ? 0 : arguments[0].as_object());
+
+        return RETURN_OK;
+    }
+
+
+    error_t Method::create_frame(Slot *values, Frame **frame)
+    {
+        // Translate the bytecode on the first invocation
+        if (code() == 0)
+        {
+            error_t errorValue = Translator::translate(this);
+            RETURN_ON_FAIL(errorValue);
+        }
+
+        // If the stack is full, throw a StackOverflowError in the caller
+        *frame = _current_executor->push_frame(this, values);
+        if (*frame == 0)
+        {
+            _current_executor->throw_exception(_vm->stack_overflow_error());
+            return RETURN_EXCEPTION;
+        }
+
+        return RETURN_OK;
+    }
+
+
+    void Method::enter_monitor(Object *object)
+    {
         if (is_synchronized())
         {
             if (isStatic())
             {
-                _declaring_class->object->ensure_monitor()->enter();
+                _declaring_class->object->monitor_enter();
             }
             else
             {
-                object->ensure_monitor()->enter();
+                object->monitor_enter();
             }
         }
-
-        // Execute method
-        return _current_executor->execute(frame, returnValue);
     }
 
 
@@ -257,11 +323,20 @@ namespace coldspot
             _native_call->init();
         }
 
+        // Native code records into the global list of the collector, the
+        // own queue is handed to it before
+        if (_current_thread != 0)
+        {
+            _current_thread->satb_queue().flush();
+        }
+
         // Create frame
-        auto &frames = _current_executor->frames();
-        uint8_t *frame_memory = frames.push(_frame_size);
-        Frame *frame = Frame::create(FRAMETYPE_NATIVE, _declaring_class, this,
-            frame_memory);
+        Frame *frame = _current_executor->push_frame(this);
+        if (frame == 0)
+        {
+            _current_executor->throw_exception(_vm->stack_overflow_error());
+            return RETURN_EXCEPTION;
+        }
 
         // Create local-references
         List <jobject> local_references;
@@ -285,7 +360,7 @@ namespace coldspot
         bool synchronized = is_synchronized();
         if (synchronized)
         {
-            object->ensure_monitor()->enter();
+            object->monitor_enter();
         }
 
         // Call native function
@@ -294,14 +369,14 @@ namespace coldspot
         // Exit monitor for synchronized methods
         if (synchronized)
         {
-            object->ensure_monitor()->exit();
+            object->monitor_exit();
         }
 
         // Exception that was not handled by the method
         Object *unhandled_exception = frame->exception;
 
         // Pop frame
-        frames.pop();
+        _current_executor->pop_frame();
 
         // Rethrow unhandled exception to the remaining stack
         if (unhandled_exception != 0)
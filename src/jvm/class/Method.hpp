@@ -26,9 +26,12 @@
 #include <jvm/class/MethodDebugInfos.hpp>
 #include <jvm/common/HashMap.hpp>
 #include <jvm/common/List.hpp>
+#include <jvm/common/SmartArray.hpp>
 #include <jvm/common/StringBuilder.hpp>
+#include <jvm/execution/Translator.hpp>
 #include <jvm/system/NativeTypes.hpp>
 #include <jvm/Error.hpp>
+#include <jvm/Slot.hpp>
 
 #include "ExceptionHandler.hpp"
 #include "Signature.hpp"
@@ -37,6 +40,8 @@ namespace coldspot
 {
 
     class Class;
+    class CompiledMethod;
+    class Frame;
     class Object;
     class MethodInfo;
     class NativeCall;
@@ -56,8 +61,13 @@ namespace coldspot
 
         Method(Class *declaringClass, const Signature &signature)
             : _declaring_class(declaringClass), _signature(signature),
-              _return_type(0), _code(0), _locals_count(0), _operands_count(0),
-              _frame_size(0), _debug_infos(0), _native_call(0), _slot(0) { }
+              _return_type(0), _bytecode(0), _code_length(0), _code(0),
+              _locals_count(0), _operands_count(0), _reference_maps(0),
+              _reference_map_size(0), _invocation_count(0),
+              _backedge_count(0), _backedge_distance(0),
+              _compiled_method(0), _debug_infos(0),
+              _native_call(0), _slot(0), _vtable_index(-1),
+              _itable_index(-1) { }
         ~Method();
 
         // Invokes a method.
@@ -68,6 +78,15 @@ namespace coldspot
         error_t invokeJava(Object *object, Value *parameters,
             Value *returnValue);
 
+        // Pushes the frame of a java (non-native) method with the parameters
+        // as local-variables, without executing it.
+        error_t push_frame(Object *object, Value *parameters, Frame **frame);
+
+        // Pushes the frame of a java (non-native) method, whose
+        // local-variables overlap the arguments (and the object for
+        // non-static methods) on top of the operands of the caller.
+        error_t push_frame(Slot *arguments, Frame **frame);
+
         // Invokes a native method.
         // The first parameters must be either:
         // - a java-class (static methods)
@@ -97,32 +116,79 @@ namespace coldspot
         const Signature &signature() const { return _signature; }
         Class *return_type() const { return _return_type; }
         List<Class *> &parameter_types() { return _parameter_types; }
+        SmartArray<Type, uint16_t> &argument_types() { return _argument_types; }
         uint16_t access_flags() const { return _access_flags; }
         List<ExceptionHandler *> &exception_handlers() { return _exception_handlers; }
-        uint8_t *code() const { return _code; }
+        uint8_t *bytecode() const { return _bytecode; }
+        uint32_t code_length() const { return _code_length; }
+        uint8_t *code() const
+        {
+            return _code.load(std::memory_order_acquire);
+        }
+        SmartArray<CacheEntry, uint16_t> &cache_entries() { return _cache_entries; }
         const uint16_t &locals_count() const { return _locals_count; }
         const uint16_t &operands_count() const { return _operands_count; }
+        bool is_reference(uint32_t pc, uint32_t slot) const
+        {
+            return pc < _code_length && _reference_maps != 0 &&
+                   (_reference_maps[pc * _reference_map_size + slot / 8] &
+                    (1 << (slot % 8))) != 0;
+        }
+        uint64_t &invocation_count() { return _invocation_count; }
+        uint64_t &backedge_count() { return _backedge_count; }
+        uint64_t &backedge_distance() { return _backedge_distance; }
+        CompiledMethod *compiled_method() const
+        {
+            return _compiled_method.load(std::memory_order_acquire);
+        }
         MethodDebugInfos *debug_infos() const { return _debug_infos; }
         NativeCall *native_call() const { return _native_call; }
         uint16_t slot() const { return _slot; }
+        jint vtable_index() const { return _vtable_index; }
+        jint itable_index() const { return _itable_index; }
 
         // Setters.
         void set_return_type(Class *return_type) { _return_type = return_type; }
         void set_access_flags(uint16_t flags) { _access_flags = flags; }
-        void set_code(uint8_t *code) { _code = code; }
+        void set_bytecode(uint8_t *bytecode, uint32_t code_length)
+        {
+            _bytecode = bytecode;
+            _code_length = code_length;
+        }
+        void set_code(uint8_t *code)
+        {
+            _code.store(code, std::memory_order_release);
+        }
         void set_locals_count(
             uint16_t locals_count) { _locals_count = locals_count; }
         void set_operands_count(
             uint16_t operands_count) { _operands_count = operands_count; }
-        void set_frame_size(uint32_t frame_size) { _frame_size = frame_size; }
+        void set_reference_maps(uint8_t *maps, uint16_t map_size)
+        {
+            _reference_maps = maps;
+            _reference_map_size = map_size;
+        }
+        void set_compiled_method(CompiledMethod *compiled_method)
+        {
+            _compiled_method.store(compiled_method, std::memory_order_release);
+        }
         void set_debug_infos(
             MethodDebugInfos *debug_infos) { _debug_infos = debug_infos; }
         void set_native_call(
             NativeCall *native_call) { _native_call = native_call; }
         void set_slot(uint16_t slot) { _slot = slot; }
+        void set_vtable_index(jint index) { _vtable_index = index; }
+        void set_itable_index(jint index) { _itable_index = index; }
 
     private:
 
+        // Translates the method if needed and pushes a frame with the
+        // local-variables starting at the values (0 for the stack-top).
+        error_t create_frame(Slot *values, Frame **frame);
+
+        // Enters the monitor of synchronized methods.
+        void enter_monitor(Object *object);
+
         // General
         Class *_declaring_class;
         Signature _signature;
@@ -131,20 +197,42 @@ namespace coldspot
         Class *_return_type;
         List<Class *> _parameter_types;
 
+        // Types of the arguments (and the object of non-static methods)
+        // on the operand-stack of the caller
+        SmartArray<Type, uint16_t> _argument_types;
+
         uint16_t _access_flags;
 
         // Exception Handlers
         List<ExceptionHandler *> _exception_handlers;
 
-        // Bytecode
-        uint8_t *_code;
+        // Bytecode of the class-file
+        uint8_t *_bytecode;
+        uint32_t _code_length;
+
+        // Translated code, created on the first invocation. Other threads
+        // see it only once it is complete.
+        std::atomic<uint8_t *> _code;
+
+        // Resolved constant-pool references of the translated code
+        SmartArray<CacheEntry, uint16_t> _cache_entries;
 
         // Limits
         uint16_t _locals_count;
         uint16_t _operands_count;
 
-        // Size of the frame of this class
-        uint32_t _frame_size;
+        // Bits of the local-variables and operands holding references
+        // before each instruction (untagged slots only)
+        uint8_t *_reference_maps;
+        uint16_t _reference_map_size;
+
+        // Invocations and backward branches counted by the interpreter,
+        // the method is compiled when one of them reaches its threshold.
+        // The distances of the branches estimate the looped bytecode.
+        uint64_t _invocation_count;
+        uint64_t _backedge_count;
+        uint64_t _backedge_distance;
+        std::atomic<CompiledMethod *> _compiled_method;
 
         // Debug infos
         MethodDebugInfos *_debug_infos;
@@ -155,6 +243,11 @@ namespace coldspot
         // Mapping to java/lang/reflect/Method object
         uint16_t _slot;
 
+        // Index into the vtable of the declaring class (virtual methods)
+        // or into the itables of the declaring interface (interface methods)
+        jint _vtable_index;
+        jint _itable_index;
+
         // Builds the native method name.
         void native_method_name(StringBuilder &builder);
 
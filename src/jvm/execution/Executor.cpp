@@ -26,9 +26,59 @@ namespace coldspot
 
     __thread Executor *_current_executor = 0;
 
-    Executor::Executor() : _uncaught_exception(0)
+    Executor::Executor() : _uncaught_exception(0), _initializer_exception(0)
     {
         _frames.init(JAVA_STACK_SIZE);
+
+        _values = new Slot[VALUE_STACK_SIZE / sizeof(Slot)];
+        _values_top = _values;
+        _values_end = _values + VALUE_STACK_SIZE / sizeof(Slot);
+    }
+
+
+    Executor::~Executor()
+    {
+        DELETE_ARRAY(_values)
+    }
+
+
+    Frame *Executor::push_frame(Method *method, Slot *values)
+    {
+        if (values == 0)
+        {
+            values = _values_top;
+        }
+
+        // Keep a reserve on the frame-stack for the exception-handling
+        Slot *valuesEnd = values + Frame::values_count(method);
+        if (_frames.capacity() - _frames.position() < sizeof(Frame) + 1024 ||
+            valuesEnd > _values_end)
+        {
+            return 0;
+        }
+
+        FrameType type = method->isNative() ? FRAMETYPE_NATIVE : FRAMETYPE_JAVA;
+        Frame *frame = Frame::create(type, method->declaring_class(), method,
+            _frames.push(sizeof(Frame)), values);
+
+        frame->callerValuesTop = _values_top;
+        _values_top = valuesEnd;
+
+        return frame;
+    }
+
+
+    void Executor::pop_frame()
+    {
+        // Frames can be executed without being pushed, e.g. by tests
+        if (_frames.empty())
+        {
+            return;
+        }
+
+        Frame *frame = (Frame *) _frames.peek();
+        _values_top = frame->callerValuesTop;
+        _frames.pop();
     }
 
 
@@ -133,14 +183,23 @@ namespace coldspot
             // Exit monitor if the method we are unwinding is synchronized
             if (frame->method->is_synchronized())
             {
-                frame->callee()->ensure_monitor()->exit();
+                frame->callee()->monitor_exit();
             }
 
             // Invalidate frame
             frame->valid = false;
+            Method *method = frame->method;
 
             // Pop frame from stack
-            _frames.pop();
+            pop_frame();
+
+            // The class-loader throws the exception of a static initializer
+            // on behalf of the class
+            if (method->signature().name == METHODNAME_STATICINIT)
+            {
+                _initializer_exception = exception;
+                return RETURN_EXCEPTION;
+            }
 
             // If the thread has no more frames, set the exception as uncaught
             if (_frames.empty())
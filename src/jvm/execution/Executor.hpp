@@ -26,6 +26,7 @@
 
 #include <jvm/common/dynamic_stack.hpp>
 #include <jvm/Error.hpp>
+#include <jvm/Slot.hpp>
 
 namespace coldspot
 {
@@ -33,6 +34,7 @@ namespace coldspot
     class Array;
     class Class;
     class Frame;
+    class Method;
     class Object;
     class Thread;
     class Value;
@@ -45,9 +47,7 @@ namespace coldspot
         // Initializes the executor and a frame-stack.
         Executor();
 
-        virtual ~Executor()
-        {
-        }
+        virtual ~Executor();
 
         // Executes a frame and returns the return-value.
         virtual error_t execute(Frame *initialFrame, Value *returnValue) = 0;
@@ -71,16 +71,44 @@ namespace coldspot
         error_t throw_exception(const char *exceptionName,
             const char *message = 0);
 
+        // Pushes a frame for the method. Its local-variables start at the
+        // values, that overlap the top operands of the calling frame,
+        // or at the top of the value-stack if no values are passed.
+        // Returns 0 if the stack is full.
+        Frame *push_frame(Method *method, Slot *values = 0);
+
+        // Pops the top frame and releases its values.
+        void pop_frame();
+
         // Getters.
         dynamic_stack &frames() { return _frames; }
         Object *uncaught_exception() const { return _uncaught_exception; }
+        Object *initializer_exception() const
+        {
+            return _initializer_exception;
+        }
+
+        // Setters.
+        void set_initializer_exception(Object *exception)
+        {
+            _initializer_exception = exception;
+        }
 
     protected:
 
         dynamic_stack _frames;
 
+        // Local-variables and operands of the frames
+        Slot *_values;
+        Slot *_values_top;
+        Slot *_values_end;
+
         Object *_uncaught_exception;
 
+        // Exception of a static initializer, the unwinding stops at its
+        // frame, so the class-loader can wrap it
+        Object *_initializer_exception;
+
         // TODO remove
         error_t createMultiArray(Class *clazz, const fixed_stack <jint> &sizes,
             jint dimension, jint dimensionSize, Array **array);
@@ -26,12 +26,13 @@
 
 #include <jvm/common/List.hpp>
 #include <jvm/jdk/Global.hpp>
-#include <jvm/Value.hpp>
+#include <jvm/Slot.hpp>
 
 #define KB                  1024
 #define MB                  (KB * KB)
 
 #define JAVA_STACK_SIZE     (256 * KB)
+#define VALUE_STACK_SIZE    (512 * KB)
 #define NATIVE_STACK_SIZE   MB
 
 #define CURRENT_PC(frame) \
@@ -52,39 +53,31 @@ namespace coldspot
 
     // Every executing method is represented by a frame on the stack.
     // It holds all relevant information that are important for the execution.
+    // The local-variables and operands are located on the separate
+    // value-stack, so that the local-variables of a called method can
+    // overlap the operands of the caller, that hold the arguments.
     class Frame
     {
     public:
 
-        // Returns the size of a frame for the given method.
-        static uint32_t size(Method *method)
+        // Returns the count of local-variables and operands of the method.
+        static uint32_t values_count(Method *method)
         {
-            // The size of the frame
-            uint32_t size = sizeof(Frame);
-
-            // Plus the size of all local-variables and operands
-            size += sizeof(Value) * method->locals_count();
-            size += sizeof(Value) * method->operands_count();
-
-            return size;
+            return method->locals_count() + method->operands_count();
         }
 
-        // Creates a frame in a pre-allocated memory-block.
+        // Creates a frame in a pre-allocated memory-block,
+        // with its local-variables and operands starting at the values.
         static Frame *create(FrameType type, Class *clazz, Method *method,
-            uint8_t *memory)
+            uint8_t *memory, Slot *values)
         {
             // Create frame in the memory-block.
             Frame *frame = new(memory) Frame(type, clazz, method,
                 method->code());
 
-            // Local-variables are located after the frame
-            frame->localVariables = (Value * )(memory + sizeof(Frame));
-
             // Operands are located after the local-variables
-            uint32_t localVariablesSize =
-                sizeof(Value) * method->locals_count();
-            frame->operands = (Value * )(
-                memory + sizeof(Frame) + localVariablesSize);
+            frame->localVariables = values;
+            frame->operands = values + method->locals_count();
 
             return frame;
         }
@@ -97,8 +90,8 @@ namespace coldspot
         Method *method;
 
         // Value storage
-        Value *localVariables;
-        Value *operands;
+        Slot *localVariables;
+        Slot *operands;
         uint16_t operandsCount;
 
         // Current instruction
@@ -113,17 +106,21 @@ namespace coldspot
         // Used for stack-unwinding
         bool valid;
 
+        // Top of the value-stack before the frame was pushed
+        Slot *callerValuesTop;
+
         Frame(FrameType type, Class *clazz, Method *method, uint8_t *code)
             : type(type), clazz(clazz), method(method), localVariables(0),
               operands(0), operandsCount(0), currentCode(code),
-              localReferences(0), exception(0), valid(true) { }
+              localReferences(0), exception(0), valid(true),
+              callerValuesTop(0) { }
 
         Frame(const Frame &other) = delete;
         Frame &operator=(const Frame &other) = delete;
 
-        void push(const Value &value) { operands[operandsCount++] = value; }
-        Value &peek() { return operands[operandsCount - 1]; }
-        Value pop() { return operands[--operandsCount]; }
+        void push(const Slot &value) { operands[operandsCount++] = value; }
+        Slot &peek() { return operands[operandsCount - 1]; }
+        Slot pop() { return operands[--operandsCount]; }
 
         Object *callee() const
         {
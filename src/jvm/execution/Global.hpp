@@ -25,5 +25,10 @@
 #include "Frame.hpp"
 #include "Instructions.hpp"
 #include "Interpreter.hpp"
+#include "MethodProfiler.hpp"
+#include "NGramProfiler.hpp"
+#include "StackAnalyzer.hpp"
+#include "TemplateCompiler.hpp"
+#include "Translator.hpp"
 
 #endif
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    std::atomic<uint32_t> InlineCache::_global_epoch(0);
+
+
+    void InlineCache::update(Class *type, Method *target)
+    {
+        // Megamorphic call-sites stay so until classes are defined
+        if (_megamorphic.load(std::memory_order_relaxed) &&
+            _epoch.load(std::memory_order_relaxed) ==
+            _global_epoch.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        // Skip the update if another thread is updating the cache
+        uint32_t version = _version.load(std::memory_order_relaxed);
+        if ((version & 1) != 0 || !_version.compare_exchange_strong(version,
+            version + 1, std::memory_order_acquire))
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        // Start over if classes were defined since the last update
+        uint32_t epoch = _global_epoch.load(std::memory_order_acquire);
+        if (_epoch.load(std::memory_order_relaxed) != epoch)
+        {
+            _size.store(0, std::memory_order_relaxed);
+            _megamorphic.store(false, std::memory_order_relaxed);
+            _epoch.store(epoch, std::memory_order_relaxed);
+        }
+
+        uint8_t size = _size.load(std::memory_order_relaxed);
+        bool cached = false;
+        for (uint8_t i = 0; i < size; ++i)
+        {
+            if (_types[i].load(std::memory_order_relaxed) == type)
+            {
+                cached = true;
+                break;
+            }
+        }
+
+        if (!cached)
+        {
+            if (size < MAX_TYPES)
+            {
+                _types[size].store(type, std::memory_order_relaxed);
+                _targets[size].store(target, std::memory_order_relaxed);
+                _size.store(size + 1, std::memory_order_relaxed);
+            }
+            else
+            {
+                _megamorphic.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        _version.store(version + 2, std::memory_order_release);
+    }
+
+
+    void InlineCache::print_statistics(ClassLoader *classLoader)
+    {
+        auto begin = classLoader->loaded_classes().begin();
+        auto end = classLoader->loaded_classes().end();
+
+        while (begin != end)
+        {
+            Class *clazz = begin->value;
+            for (uint16_t i = 0; i < clazz->declared_methods.length(); ++i)
+            {
+                Method *method = clazz->declared_methods[i];
+                auto &entries = method->cache_entries();
+                for (uint16_t j = 0; j < entries.length(); ++j)
+                {
+                    InlineCache *cache = entries[j].inline_cache;
+                    if (cache == 0 || cache->hits() + cache->misses() == 0)
+                    {
+                        continue;
+                    }
+
+                    LOG_INFO("inline cache " << clazz->name.c_str() << "." <<
+                        method->signature().name.c_str() <<
+                        method->signature().descriptor.c_str() << " #" << j <<
+                        ": hits=" << cache->hits() << " misses=" <<
+                        cache->misses() << " types=" << (int) cache->size() <<
+                        (cache->megamorphic() ? " megamorphic" : ""))
+                }
+            }
+
+            ++begin;
+        }
+    }
+
+}
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_EXECUTION_INLINECACHE_HPP_
+#define COLDSPOT_JVM_EXECUTION_INLINECACHE_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+namespace coldspot
+{
+
+    class Class;
+    class ClassLoader;
+    class Method;
+
+    // Receiver-types and their targets of a virtual or interface call-site.
+    // The cache starts monomorphic, widens up to MAX_TYPES receiver-types
+    // and is marked megamorphic afterwards. Lookups are lock-free, updates
+    // are guarded by an odd version (sequence-lock). Defining a class
+    // invalidates all caches.
+    class InlineCache
+    {
+    public:
+
+        static const uint8_t MAX_TYPES = 4;
+
+        InlineCache() : _version(0), _epoch(0), _size(0), _megamorphic(false),
+                        _hits(0), _misses(0)
+        {
+        }
+
+        // Returns the cached target for the receiver-type or 0 on a miss.
+        // Hits and misses are only counted if profiling.
+        inline Method *lookup(Class *type, bool profile);
+
+        // Records the target for the receiver-type after a miss.
+        void update(Class *type, Method *target);
+
+        // Invalidates the caches of all call-sites.
+        static void invalidate_all()
+        {
+            _global_epoch.fetch_add(1, std::memory_order_release);
+        }
+
+        // Prints the statistics of all call-sites of the loaded classes.
+        static void print_statistics(ClassLoader *classLoader);
+
+        // Getters.
+        uint8_t size() const { return _size.load(std::memory_order_relaxed); }
+        bool megamorphic() const { return _megamorphic.load(std::memory_order_relaxed); }
+        uint64_t hits() const { return _hits.load(std::memory_order_relaxed); }
+        uint64_t misses() const { return _misses.load(std::memory_order_relaxed); }
+
+    private:
+
+        std::atomic<uint32_t> _version;
+        std::atomic<uint32_t> _epoch;
+        std::atomic<uint8_t> _size;
+        std::atomic<bool> _megamorphic;
+        std::atomic<Class *> _types[MAX_TYPES];
+        std::atomic<Method *> _targets[MAX_TYPES];
+
+        // Counters are updated without read-modify-write,
+        // so concurrent updates may get lost
+        std::atomic<uint64_t> _hits;
+        std::atomic<uint64_t> _misses;
+
+        static std::atomic<uint32_t> _global_epoch;
+
+        static void increment(std::atomic<uint64_t> &counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        }
+    };
+
+
+    inline Method *InlineCache::lookup(Class *type, bool profile)
+    {
+        uint32_t version = _version.load(std::memory_order_acquire);
+        if ((version & 1) == 0 && !_megamorphic.load(std::memory_order_relaxed)
+            && _epoch.load(std::memory_order_relaxed) ==
+               _global_epoch.load(std::memory_order_acquire))
+        {
+            uint8_t size = _size.load(std::memory_order_relaxed);
+            for (uint8_t i = 0; i < size; ++i)
+            {
+                if (_types[i].load(std::memory_order_relaxed) == type)
+                {
+                    Method *target = _targets[i].load(std::memory_order_relaxed);
+
+                    // The entry is valid, if no update happened meanwhile
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (_version.load(std::memory_order_relaxed) == version)
+                    {
+                        if (profile)
+                        {
+                            increment(_hits);
+                        }
+                        return target;
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (profile)
+        {
+            increment(_misses);
+        }
+        return 0;
+    }
+
+}
+
+#endif
@@ -228,6 +228,74 @@ namespace coldspot
     const uint8_t GOTO_W = 200;
     const uint8_t JSR_W = 201;
 
+    // Internal instructions, only used in translated code
+    const uint8_t LDC_UNCACHED = 203;
+
+    // Field-access with resolved offsets, specialized by the field-type
+    const uint8_t GETFIELD_BYTE_QUICK = 204;
+    const uint8_t GETFIELD_CHAR_QUICK = 205;
+    const uint8_t GETFIELD_SHORT_QUICK = 206;
+    const uint8_t GETFIELD_INT_QUICK = 207;
+    const uint8_t GETFIELD_FLOAT_QUICK = 208;
+    const uint8_t GETFIELD_LONG_QUICK = 209;
+    const uint8_t GETFIELD_DOUBLE_QUICK = 210;
+    const uint8_t GETFIELD_REF_QUICK = 211;
+    const uint8_t PUTFIELD_BYTE_QUICK = 212;
+    const uint8_t PUTFIELD_CHAR_QUICK = 213;
+    const uint8_t PUTFIELD_SHORT_QUICK = 214;
+    const uint8_t PUTFIELD_INT_QUICK = 215;
+    const uint8_t PUTFIELD_FLOAT_QUICK = 216;
+    const uint8_t PUTFIELD_LONG_QUICK = 217;
+    const uint8_t PUTFIELD_DOUBLE_QUICK = 218;
+    const uint8_t PUTFIELD_REF_QUICK = 219;
+    const uint8_t GETSTATIC_BYTE_QUICK = 220;
+    const uint8_t GETSTATIC_CHAR_QUICK = 221;
+    const uint8_t GETSTATIC_SHORT_QUICK = 222;
+    const uint8_t GETSTATIC_INT_QUICK = 223;
+    const uint8_t GETSTATIC_FLOAT_QUICK = 224;
+    const uint8_t GETSTATIC_LONG_QUICK = 225;
+    const uint8_t GETSTATIC_DOUBLE_QUICK = 226;
+    const uint8_t GETSTATIC_REF_QUICK = 227;
+    const uint8_t PUTSTATIC_BYTE_QUICK = 228;
+    const uint8_t PUTSTATIC_CHAR_QUICK = 229;
+    const uint8_t PUTSTATIC_SHORT_QUICK = 230;
+    const uint8_t PUTSTATIC_INT_QUICK = 231;
+    const uint8_t PUTSTATIC_FLOAT_QUICK = 232;
+    const uint8_t PUTSTATIC_LONG_QUICK = 233;
+    const uint8_t PUTSTATIC_DOUBLE_QUICK = 234;
+    const uint8_t PUTSTATIC_REF_QUICK = 235;
+
+    // Superinstructions, each executes a sequence of instructions with a
+    // single dispatch. The translator replaces the first instruction of each
+    // sequence found in the bytecode, the rest of the sequence stays in the
+    // code. The leading instructions are executed inline, the last one by a
+    // direct jump into its handler, so it is given in its quick form:
+    // PAIR(name, opcode, first, last)
+    // TRIPLE(name, opcode, first, second, last)
+#define SUPERINSTRUCTIONS(PAIR, TRIPLE) \
+  PAIR(ALOAD_0_GETFIELD_INT, 236, ALOAD_0, GETFIELD_INT_QUICK) \
+  PAIR(ALOAD_0_GETFIELD_REF, 237, ALOAD_0, GETFIELD_REF_QUICK) \
+  PAIR(ALOAD_ARRAYLENGTH, 238, ALOAD, ARRAYLENGTH) \
+  PAIR(ILOAD_IALOAD, 239, ILOAD, IALOAD) \
+  PAIR(IINC_GOTO, 240, IINC, GOTO) \
+  TRIPLE(ILOAD_ILOAD_IF_ICMPEQ, 241, ILOAD, ILOAD, IF_ICMPEQ) \
+  TRIPLE(ILOAD_ILOAD_IF_ICMPNE, 242, ILOAD, ILOAD, IF_ICMPNE) \
+  TRIPLE(ILOAD_ILOAD_IF_ICMPLT, 243, ILOAD, ILOAD, IF_ICMPLT) \
+  TRIPLE(ILOAD_ILOAD_IF_ICMPGE, 244, ILOAD, ILOAD, IF_ICMPGE) \
+  TRIPLE(ILOAD_ILOAD_IF_ICMPGT, 245, ILOAD, ILOAD, IF_ICMPGT) \
+  TRIPLE(ILOAD_ILOAD_IF_ICMPLE, 246, ILOAD, ILOAD, IF_ICMPLE)
+
+#define DEFINE_SUPERINSTRUCTION_PAIR(name, opcode, first, last) \
+  const uint8_t name = opcode;
+#define DEFINE_SUPERINSTRUCTION_TRIPLE(name, opcode, first, second, last) \
+  const uint8_t name = opcode;
+
+    SUPERINSTRUCTIONS(DEFINE_SUPERINSTRUCTION_PAIR,
+        DEFINE_SUPERINSTRUCTION_TRIPLE)
+
+#undef DEFINE_SUPERINSTRUCTION_PAIR
+#undef DEFINE_SUPERINSTRUCTION_TRIPLE
+
 }
 
 #endif
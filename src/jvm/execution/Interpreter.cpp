@@ -23,69 +23,119 @@
 
 #include <jvm/Global.hpp>
 
+// Continues the frame in its compiled code, which returns at the first
+// instruction it leaves to the interpreter.
+#define CONTINUE_COMPILED \
+  if (_compile && frame->method != 0) { \
+    CompiledMethod *compiled = frame->method->compiled_method(); \
+    if (compiled != 0) { \
+      compiled->run(frame); \
+    } \
+  }
+
+// Counts for the profile and compiles the method of the frame once the
+// counter reaches the threshold.
+#define COUNT_AND_COMPILE(counter, threshold) \
+  if (frame->method != 0 && ++frame->method->counter() == threshold && \
+      _compile) { \
+    TemplateCompiler::compile(frame->method); \
+  } \
+  CONTINUE_COMPILED
+
+// Backward branches count the iterations of loops.
+#define BACKEDGE(offset) \
+  if (offset <= 0 && frame->method != 0) { \
+    frame->method->backedge_distance() -= offset; \
+    COUNT_AND_COMPILE(backedge_count, TemplateCompiler::BACKEDGE_THRESHOLD) \
+  }
+
+// Branches poll the safepoint only backwards by default,
+// returns and invokes of native methods always poll
+#if defined(COLDSPOT_SAFEPOINT_ALL_BRANCHES)
+#define SAFEPOINT_BRANCH(offset) \
+  SAFEPOINT
+#else
+#define SAFEPOINT_BRANCH(offset) \
+  if (offset <= 0) { \
+    SAFEPOINT \
+  }
+#endif
+
 // Generic instructions
 #define IF(operator) \
-  uint8_t* currentCode = code; \
-  int16_t offset = (*(++code) << 8) | *(++code); \
+  int16_t offset = read_operand<int16_t>(code + 1); \
   if (frame->pop().as_int() operator 0) { \
-    code = currentCode + offset; \
+    code += offset; \
   } else { \
-    ++code; \
+    code += 3; \
   } \
-  SAFEPOINT
+  SAFEPOINT_BRANCH(offset) \
+  BACKEDGE(offset)
 
 #define IFXNULL(operator) \
-  uint8_t* currentCode = code; \
-  int16_t offset = (*(++code) << 8) | *(++code); \
+  int16_t offset = read_operand<int16_t>(code + 1); \
   if (frame->pop().as_object() operator 0) { \
-    code = currentCode + offset; \
+    code += offset; \
   } else { \
-    ++code; \
+    code += 3; \
   } \
-  SAFEPOINT
+  SAFEPOINT_BRANCH(offset) \
+  BACKEDGE(offset)
 
 #define IF_ACMP(operator) \
-  uint8_t* currentCode = code; \
-  int16_t offset = (*(++code) << 8) | *(++code); \
+  int16_t offset = read_operand<int16_t>(code + 1); \
   Object* object2 = frame->pop().as_object(); \
   Object* object1 = frame->pop().as_object(); \
   if (object1 operator object2) { \
-    code = currentCode + offset; \
+    code += offset; \
   } else { \
-    ++code; \
+    code += 3; \
   } \
-  SAFEPOINT
+  SAFEPOINT_BRANCH(offset) \
+  BACKEDGE(offset)
 
 #define IF_ICMP(operator) \
-  uint8_t* currentCode = code; \
-  int16_t offset = (*(++code) << 8) | *(++code); \
+  int16_t offset = read_operand<int16_t>(code + 1); \
   jint value2 = frame->pop().as_int(); \
   jint value1 = frame->pop().as_int(); \
   if (value1 operator value2) { \
-    code = currentCode + offset; \
+    code += offset; \
   } else { \
-    ++code; \
+    code += 3; \
   } \
-  SAFEPOINT
+  SAFEPOINT_BRANCH(offset) \
+  BACKEDGE(offset)
 
 #define TADD(getter) \
   ++code; \
   frame->push(frame->pop().getter() + frame->pop().getter());
 
 #define TRETURN \
-  ++code; \
   if (frame->method != 0) { \
     if (frame->method->is_synchronized()) { \
       if (frame->method->isStatic()) { \
-        frame->clazz->object->ensure_monitor()->exit(); \
+        frame->clazz->object->monitor_exit(); \
       } else { \
-        frame->localVariables[0].as_object()->ensure_monitor()->exit(); \
+        frame->localVariables[0].as_object()->monitor_exit(); \
       } \
     } \
   } \
-  *returnValue = frame->pop(); \
-  _frames.pop(); \
-  return RETURN_OK;
+  Slot value = frame->pop(); \
+  if (frame == initialFrame) { \
+    *returnValue = to_value(value, RETURN_TYPE(frame)); \
+    pop_frame(); \
+    return RETURN_OK; \
+  } \
+  pop_frame(); \
+  frame = (Frame *) _frames.peek(); \
+  frame->push(value); \
+  SAFEPOINT \
+  CONTINUE_COMPILED \
+  continue;
+
+// Frames of tests have no method
+#define RETURN_TYPE(frame) \
+  (frame->method != 0 ? frame->method->return_type()->type : Type::TYPE_VOID)
 
 #define TSUB(type, getter) \
   ++code; \
@@ -99,14 +149,15 @@
 
 #define TASTORE_VALUE(value) \
   ++code; \
-  Value storeValue = frame->pop(); \
+  Slot storeValue = frame->pop(); \
   jint index = frame->pop().as_int(); \
   Array* array = frame->pop().as_array(); \
   if (!array) { \
-    throw_exception(CLASSNAME_NULLPOINTEREXCEPTION); \
+    THROW_WITH_RETURN_ON_UNWIND(CLASSNAME_NULLPOINTEREXCEPTION); \
     break; \
   } \
-  array->set_value(index, value);
+  array->set_value(index, \
+    to_value(value, array->type()->component_type->type));
 
 #define TASTORE \
   TASTORE_VALUE(storeValue)
@@ -131,17 +182,116 @@
   frame->localVariables[*(++code)] = frame->pop(); \
   ++code;
 
+#define TIINC \
+  Slot &localVariable = frame->localVariables[*(++code)]; \
+  jint value = (jbyte) * (++code); \
+  ++code; \
+  localVariable = (jint) (localVariable.as_int() + value);
+
+// Helpers for translated operands.
+#define CACHE_ENTRY \
+  (&frame->method->cache_entries()[read_operand<uint16_t>(code + 1)])
+
+#define RESOLVE_ENTRY(entry, getter, member) \
+  if (!entry->resolved) { \
+    error_t resolveError = frame->clazz->getter(entry->index, \
+      &entry->member); \
+    BREAK_ON_FAIL(resolveError); \
+    entry->resolved = true; \
+  }
+
+// Helpers for quick field-instructions.
+#define GETFIELD_QUICK(type) \
+  jint offset = CACHE_ENTRY->offset; \
+  code += 3; \
+  Object *object = frame->pop().as_object(); \
+  if (object == 0) { \
+    THROW_WITH_RETURN_ON_UNWIND(CLASSNAME_NULLPOINTEREXCEPTION); \
+    break; \
+  } \
+  frame->push(*((type *) (object->memory() + offset)));
+
+#define PUTFIELD_QUICK(type, getter) \
+  jint offset = CACHE_ENTRY->offset; \
+  code += 3; \
+  Slot value = frame->pop(); \
+  Object *object = frame->pop().as_object(); \
+  if (object == 0) { \
+    THROW_WITH_RETURN_ON_UNWIND(CLASSNAME_NULLPOINTEREXCEPTION); \
+    break; \
+  } \
+  *((type *) (object->memory() + offset)) = value.getter();
+
+#define GETSTATIC_QUICK(type) \
+  uint8_t *address = CACHE_ENTRY->address; \
+  code += 3; \
+  frame->push(*((type *) address));
+
+#define PUTSTATIC_QUICK(type, getter) \
+  uint8_t *address = CACHE_ENTRY->address; \
+  code += 3; \
+  *((type *) address) = frame->pop().getter();
+
 // Helper for invoke-instructions.
 #define FILL_INVOKE_INFO \
-  uint16_t methodIndex = (*(++code) << 8) | *(++code); \
-  ++code; \
-  error_t errorValue = frame->clazz->get_method_from_cp(methodIndex, &invokeMethod); \
-  BREAK_ON_FAIL(errorValue);
+  CacheEntry *entry = CACHE_ENTRY; \
+  RESOLVE_ENTRY(entry, get_method_from_cp, method) \
+  error_t errorValue = RETURN_OK; \
+  invokeMethod = entry->method;
+
+// The arguments (and the object of non-static methods) stay on the
+// operand-stack, where they become the local-variables of the invoked method.
+#define PEEK_ARGUMENTS \
+  uint32_t argumentsCount = invokeMethod->argument_types().length(); \
+  Slot *arguments = &frame->operands[frame->operandsCount - argumentsCount]; \
+  Object *object; \
+  if (!invokeMethod->isStatic()) { \
+    object = arguments[0].as_object(); \
+    if (object == 0) { \
+      frame->operandsCount -= argumentsCount; \
+      THROW_WITH_RETURN_ON_UNWIND(CLASSNAME_NULLPOINTEREXCEPTION); \
+      break; \
+    } \
+  } else if (invokeMethod->isNative()) { \
+    object = invokeMethod->declaring_class()->object; \
+  } else { \
+    object = 0; \
+  }
+
+// Native methods are invoked directly, java methods get a new frame
+// and are executed by the current interpreter loop. The code is advanced
+// just before the invocation, so that the operands match the current
+// instruction while the method is looked up and its class is initialized.
+#define INVOKE(length) \
+  code += length; \
+  frame->operandsCount -= argumentsCount; \
+  if (invokeMethod->isNative()) { \
+    Value value; \
+    errorValue = invoke_native(invokeMethod, object, arguments, &value); \
+    BREAK_ON_FAIL(errorValue); \
+    if (invokeMethod->return_type()->type != Type::TYPE_VOID) { \
+      frame->push(value); \
+    } \
+    SAFEPOINT \
+    NEXT \
+  } \
+  Frame *invokeFrame; \
+  errorValue = invokeMethod->push_frame(arguments, &invokeFrame); \
+  BREAK_ON_FAIL(errorValue); \
+  frame = invokeFrame; \
+  COUNT_AND_COMPILE(invocation_count, TemplateCompiler::INVOCATION_THRESHOLD) \
+  continue;
 
 // Helpers for exception-handling.
+// If the current frame was unwinded, execution continues in the frame with
+// the exception-handler, or returns if the initial frame was unwinded too.
 #define RETURN_ON_UNWIND \
   if (!frame->valid) { \
-    return RETURN_EXCEPTION; \
+    if (!initialFrame->valid) { \
+      return RETURN_EXCEPTION; \
+    } \
+    frame = (Frame *) _frames.peek(); \
+    continue; \
   }
 
 #define THROW_WITH_RETURN_ON_UNWIND(exception) \
@@ -154,24 +304,404 @@
     break; \
   }
 
+// Initializes the class, unless the class is initialized already.
+#define INITIALIZE_CLASS(clazz) \
+  if (!(clazz)->is_initialized()) { \
+    error_t initializeError = _vm->class_loader()->initialize_class(clazz); \
+    BREAK_ON_FAIL(initializeError); \
+  }
+
+// Helpers for instruction-dispatch.
+// Threaded dispatch needs the labels-as-values extension of gcc and clang.
+#if defined(__GNUC__)
+#define THREADED_DISPATCH_AVAILABLE 1
+#define THREADED_ENTRY(instruction) \
+  dispatch_table[instruction] = &&op_##instruction;
+#else
+#define THREADED_DISPATCH_AVAILABLE 0
+#endif
+
+// Every handler has a label, superinstructions jump to them directly.
+#define HANDLER_LABEL(instruction) op_##instruction:
+
+#define CASE(instruction) \
+  case instruction: \
+  HANDLER_LABEL(instruction)
+
+// Jumps directly to the handler of the next instruction in threaded mode,
+// otherwise leaves the switch and dispatches at the loop head.
+#if THREADED_DISPATCH_AVAILABLE
+#define NEXT \
+  if (Threaded) { \
+    goto *dispatch_table[*code]; \
+  } \
+  break;
+#else
+#define NEXT \
+  break;
+#endif
+
+// Helpers for superinstructions.
+// The leading instructions are executed inline, each advances the code
+// to the next one, so the operands always match the current instruction.
+#define INLINE_ALOAD TLOAD
+#define INLINE_ALOAD_0 TLOAD_N(0)
+#define INLINE_IINC TIINC
+#define INLINE_ILOAD TLOAD
+
+// The last instruction is dispatched regularly, until it was quickened.
+#define JUMP_TO_HANDLER(instruction) \
+  if (*code == instruction) { \
+    goto op_##instruction; \
+  } \
+  NEXT
+
+#define SUPERINSTRUCTION_PAIR(name, opcode, first, last) \
+  CASE(name) \
+  { \
+    { INLINE_##first } \
+    JUMP_TO_HANDLER(last) \
+  }
+
+#define SUPERINSTRUCTION_TRIPLE(name, opcode, first, second, last) \
+  CASE(name) \
+  { \
+    { INLINE_##first } \
+    { INLINE_##second } \
+    JUMP_TO_HANDLER(last) \
+  }
+
+#define SUPERINSTRUCTION_ENTRY_PAIR(name, opcode, first, last) \
+  THREADED_ENTRY(name)
+#define SUPERINSTRUCTION_ENTRY_TRIPLE(name, opcode, first, second, last) \
+  THREADED_ENTRY(name)
+
 namespace coldspot
 {
 
-    error_t Interpreter::execute(Frame *frame, Value *returnValue)
+    Interpreter::Interpreter() : _threaded(false), _profile_ngrams(false),
+                                 _profile_inline_caches(false),
+                                 _compile(false)
+    {
+        if (_vm != 0 && _vm->options() != 0)
+        {
+#if THREADED_DISPATCH_AVAILABLE
+            _threaded = _vm->options()->threadedInterpreter;
+#endif
+
+            // Profiling needs every instruction at the loop head
+            _profile_ngrams = _vm->options()->profileNGrams;
+            if (_profile_ngrams)
+            {
+                _threaded = false;
+            }
+
+            _profile_inline_caches = _vm->options()->profileInlineCaches;
+
+            // Compiled code would hide the instructions from the profilers
+            _compile = TEMPLATE_COMPILER_AVAILABLE &&
+                       !_vm->options()->interpretOnly && !_profile_ngrams &&
+                       !_vm->options()->profileMethods;
+        }
+    }
+
+
+    error_t Interpreter::execute(Frame *initialFrame, Value *returnValue)
     {
-        // If the stack is full, throw a StackOverflowError
-        if (_frames.capacity() - _frames.position() < 1024)
+#if THREADED_DISPATCH_AVAILABLE
+        if (_threaded)
         {
-            THROW_WITH_RETURN_ON_UNWIND(_vm->stack_overflow_error());
-            return RETURN_EXCEPTION;
+            return execute_loop<true>(initialFrame, returnValue);
         }
+#endif
+
+        return execute_loop<false>(initialFrame, returnValue);
+    }
+
+
+    template<bool Threaded>
+    error_t Interpreter::execute_loop(Frame *initialFrame, Value *returnValue)
+    {
+#if THREADED_DISPATCH_AVAILABLE
+        // Table with the handler-address of each instruction,
+        // filled once on the first threaded execution
+        static void *dispatch_table[256];
+        static std::atomic<bool> dispatch_table_filled(false);
+        static Mutex dispatch_table_mutex;
+
+        // The addresses of the handlers are only known in here, so the
+        // first thread fills the table under the lock
+        if (Threaded &&
+            !dispatch_table_filled.load(std::memory_order_acquire))
+        {
+            dispatch_table_mutex.lock();
+            if (!dispatch_table_filled.load(std::memory_order_relaxed))
+            {
+                for (int i = 0; i < 256; ++i)
+                {
+                    dispatch_table[i] = &&op_default;
+                }
+
+                THREADED_ENTRY(AALOAD)
+                THREADED_ENTRY(AASTORE)
+                THREADED_ENTRY(ACONST_NULL)
+                THREADED_ENTRY(ALOAD)
+                THREADED_ENTRY(ALOAD_0)
+                THREADED_ENTRY(ALOAD_1)
+                THREADED_ENTRY(ALOAD_2)
+                THREADED_ENTRY(ALOAD_3)
+                THREADED_ENTRY(ANEWARRAY)
+                THREADED_ENTRY(ARETURN)
+                THREADED_ENTRY(ARRAYLENGTH)
+                THREADED_ENTRY(ASTORE)
+                THREADED_ENTRY(ASTORE_0)
+                THREADED_ENTRY(ASTORE_1)
+                THREADED_ENTRY(ASTORE_2)
+                THREADED_ENTRY(ASTORE_3)
+                THREADED_ENTRY(ATHROW)
+                THREADED_ENTRY(BALOAD)
+                THREADED_ENTRY(BASTORE)
+                THREADED_ENTRY(BIPUSH)
+                THREADED_ENTRY(CALOAD)
+                THREADED_ENTRY(CASTORE)
+                THREADED_ENTRY(CHECKCAST)
+                THREADED_ENTRY(D2F)
+                THREADED_ENTRY(D2I)
+                THREADED_ENTRY(D2L)
+                THREADED_ENTRY(DADD)
+                THREADED_ENTRY(DALOAD)
+                THREADED_ENTRY(DASTORE)
+                THREADED_ENTRY(DCMPG)
+                THREADED_ENTRY(DCMPL)
+                THREADED_ENTRY(DCONST_0)
+                THREADED_ENTRY(DCONST_1)
+                THREADED_ENTRY(DDIV)
+                THREADED_ENTRY(DLOAD)
+                THREADED_ENTRY(DLOAD_0)
+                THREADED_ENTRY(DLOAD_1)
+                THREADED_ENTRY(DLOAD_2)
+                THREADED_ENTRY(DLOAD_3)
+                THREADED_ENTRY(DMUL)
+                THREADED_ENTRY(DNEG)
+                THREADED_ENTRY(DREM)
+                THREADED_ENTRY(DRETURN)
+                THREADED_ENTRY(DSTORE)
+                THREADED_ENTRY(DSTORE_0)
+                THREADED_ENTRY(DSTORE_1)
+                THREADED_ENTRY(DSTORE_2)
+                THREADED_ENTRY(DSTORE_3)
+                THREADED_ENTRY(DSUB)
+                THREADED_ENTRY(DUP)
+                THREADED_ENTRY(DUP_X1)
+                THREADED_ENTRY(DUP_X2)
+                THREADED_ENTRY(DUP2)
+                THREADED_ENTRY(DUP2_X1)
+                THREADED_ENTRY(DUP2_X2)
+                THREADED_ENTRY(F2D)
+                THREADED_ENTRY(F2I)
+                THREADED_ENTRY(F2L)
+                THREADED_ENTRY(FADD)
+                THREADED_ENTRY(FALOAD)
+                THREADED_ENTRY(FASTORE)
+                THREADED_ENTRY(FCMPG)
+                THREADED_ENTRY(FCMPL)
+                THREADED_ENTRY(FCONST_0)
+                THREADED_ENTRY(FCONST_1)
+                THREADED_ENTRY(FCONST_2)
+                THREADED_ENTRY(FDIV)
+                THREADED_ENTRY(FLOAD)
+                THREADED_ENTRY(FLOAD_0)
+                THREADED_ENTRY(FLOAD_1)
+                THREADED_ENTRY(FLOAD_2)
+                THREADED_ENTRY(FLOAD_3)
+                THREADED_ENTRY(FMUL)
+                THREADED_ENTRY(FNEG)
+                THREADED_ENTRY(FREM)
+                THREADED_ENTRY(FRETURN)
+                THREADED_ENTRY(FSTORE)
+                THREADED_ENTRY(FSTORE_0)
+                THREADED_ENTRY(FSTORE_1)
+                THREADED_ENTRY(FSTORE_2)
+                THREADED_ENTRY(FSTORE_3)
+                THREADED_ENTRY(FSUB)
+                THREADED_ENTRY(GETFIELD)
+                THREADED_ENTRY(GETSTATIC)
+                THREADED_ENTRY(GOTO)
+                THREADED_ENTRY(GOTO_W)
+                THREADED_ENTRY(I2B)
+                THREADED_ENTRY(I2C)
+                THREADED_ENTRY(I2D)
+                THREADED_ENTRY(I2F)
+                THREADED_ENTRY(I2L)
+                THREADED_ENTRY(I2S)
+                THREADED_ENTRY(IADD)
+                THREADED_ENTRY(IALOAD)
+                THREADED_ENTRY(IAND)
+                THREADED_ENTRY(IASTORE)
+                THREADED_ENTRY(ICONST_M1)
+                THREADED_ENTRY(ICONST_0)
+                THREADED_ENTRY(ICONST_1)
+                THREADED_ENTRY(ICONST_2)
+                THREADED_ENTRY(ICONST_3)
+                THREADED_ENTRY(ICONST_4)
+                THREADED_ENTRY(ICONST_5)
+                THREADED_ENTRY(IDIV)
+                THREADED_ENTRY(IF_ACMPEQ)
+                THREADED_ENTRY(IF_ACMPNE)
+                THREADED_ENTRY(IF_ICMPEQ)
+                THREADED_ENTRY(IF_ICMPNE)
+                THREADED_ENTRY(IF_ICMPLT)
+                THREADED_ENTRY(IF_ICMPGE)
+                THREADED_ENTRY(IF_ICMPGT)
+                THREADED_ENTRY(IF_ICMPLE)
+                THREADED_ENTRY(IFEQ)
+                THREADED_ENTRY(IFNE)
+                THREADED_ENTRY(IFLT)
+                THREADED_ENTRY(IFGE)
+                THREADED_ENTRY(IFGT)
+                THREADED_ENTRY(IFLE)
+                THREADED_ENTRY(IFNONNULL)
+                THREADED_ENTRY(IFNULL)
+                THREADED_ENTRY(IINC)
+                THREADED_ENTRY(ILOAD)
+                THREADED_ENTRY(ILOAD_0)
+                THREADED_ENTRY(ILOAD_1)
+                THREADED_ENTRY(ILOAD_2)
+                THREADED_ENTRY(ILOAD_3)
+                THREADED_ENTRY(IMUL)
+                THREADED_ENTRY(INEG)
+                THREADED_ENTRY(INSTANCEOF)
+                THREADED_ENTRY(INVOKEDYNAMIC)
+                THREADED_ENTRY(INVOKEINTERFACE)
+                THREADED_ENTRY(INVOKESPECIAL)
+                THREADED_ENTRY(INVOKESTATIC)
+                THREADED_ENTRY(INVOKEVIRTUAL)
+                THREADED_ENTRY(IOR)
+                THREADED_ENTRY(IREM)
+                THREADED_ENTRY(IRETURN)
+                THREADED_ENTRY(ISHL)
+                THREADED_ENTRY(ISHR)
+                THREADED_ENTRY(ISTORE)
+                THREADED_ENTRY(ISTORE_0)
+                THREADED_ENTRY(ISTORE_1)
+                THREADED_ENTRY(ISTORE_2)
+                THREADED_ENTRY(ISTORE_3)
+                THREADED_ENTRY(ISUB)
+                THREADED_ENTRY(IUSHR)
+                THREADED_ENTRY(IXOR)
+                THREADED_ENTRY(JSR)
+                THREADED_ENTRY(JSR_W)
+                THREADED_ENTRY(L2D)
+                THREADED_ENTRY(L2F)
+                THREADED_ENTRY(L2I)
+                THREADED_ENTRY(LADD)
+                THREADED_ENTRY(LALOAD)
+                THREADED_ENTRY(LAND)
+                THREADED_ENTRY(LASTORE)
+                THREADED_ENTRY(LCMP)
+                THREADED_ENTRY(LCONST_0)
+                THREADED_ENTRY(LCONST_1)
+                THREADED_ENTRY(LDC)
+                THREADED_ENTRY(LDC_W)
+                THREADED_ENTRY(LDC2_W)
+                THREADED_ENTRY(LDC_UNCACHED)
+                THREADED_ENTRY(GETFIELD_BYTE_QUICK)
+                THREADED_ENTRY(GETFIELD_CHAR_QUICK)
+                THREADED_ENTRY(GETFIELD_SHORT_QUICK)
+                THREADED_ENTRY(GETFIELD_INT_QUICK)
+                THREADED_ENTRY(GETFIELD_FLOAT_QUICK)
+                THREADED_ENTRY(GETFIELD_LONG_QUICK)
+                THREADED_ENTRY(GETFIELD_DOUBLE_QUICK)
+                THREADED_ENTRY(GETFIELD_REF_QUICK)
+                THREADED_ENTRY(PUTFIELD_BYTE_QUICK)
+                THREADED_ENTRY(PUTFIELD_CHAR_QUICK)
+                THREADED_ENTRY(PUTFIELD_SHORT_QUICK)
+                THREADED_ENTRY(PUTFIELD_INT_QUICK)
+                THREADED_ENTRY(PUTFIELD_FLOAT_QUICK)
+                THREADED_ENTRY(PUTFIELD_LONG_QUICK)
+                THREADED_ENTRY(PUTFIELD_DOUBLE_QUICK)
+                THREADED_ENTRY(PUTFIELD_REF_QUICK)
+                THREADED_ENTRY(GETSTATIC_BYTE_QUICK)
+                THREADED_ENTRY(GETSTATIC_CHAR_QUICK)
+                THREADED_ENTRY(GETSTATIC_SHORT_QUICK)
+                THREADED_ENTRY(GETSTATIC_INT_QUICK)
+                THREADED_ENTRY(GETSTATIC_FLOAT_QUICK)
+                THREADED_ENTRY(GETSTATIC_LONG_QUICK)
+                THREADED_ENTRY(GETSTATIC_DOUBLE_QUICK)
+                THREADED_ENTRY(GETSTATIC_REF_QUICK)
+                THREADED_ENTRY(PUTSTATIC_BYTE_QUICK)
+                THREADED_ENTRY(PUTSTATIC_CHAR_QUICK)
+                THREADED_ENTRY(PUTSTATIC_SHORT_QUICK)
+                THREADED_ENTRY(PUTSTATIC_INT_QUICK)
+                THREADED_ENTRY(PUTSTATIC_FLOAT_QUICK)
+                THREADED_ENTRY(PUTSTATIC_LONG_QUICK)
+                THREADED_ENTRY(PUTSTATIC_DOUBLE_QUICK)
+                THREADED_ENTRY(PUTSTATIC_REF_QUICK)
+                THREADED_ENTRY(LDIV)
+                THREADED_ENTRY(LLOAD)
+                THREADED_ENTRY(LLOAD_0)
+                THREADED_ENTRY(LLOAD_1)
+                THREADED_ENTRY(LLOAD_2)
+                THREADED_ENTRY(LLOAD_3)
+                THREADED_ENTRY(LMUL)
+                THREADED_ENTRY(LNEG)
+                THREADED_ENTRY(LOOKUPSWITCH)
+                THREADED_ENTRY(LOR)
+                THREADED_ENTRY(LREM)
+                THREADED_ENTRY(LRETURN)
+                THREADED_ENTRY(LSHL)
+                THREADED_ENTRY(LSHR)
+                THREADED_ENTRY(LSTORE)
+                THREADED_ENTRY(LSTORE_0)
+                THREADED_ENTRY(LSTORE_1)
+                THREADED_ENTRY(LSTORE_2)
+                THREADED_ENTRY(LSTORE_3)
+                THREADED_ENTRY(LSUB)
+                THREADED_ENTRY(LUSHR)
+                THREADED_ENTRY(LXOR)
+                THREADED_ENTRY(MONITORENTER)
+                THREADED_ENTRY(MONITOREXIT)
+                THREADED_ENTRY(MULTIANEWARRAY)
+                THREADED_ENTRY(NEW)
+                THREADED_ENTRY(NEWARRAY)
+                THREADED_ENTRY(NOP)
+                THREADED_ENTRY(POP)
+                THREADED_ENTRY(POP2)
+                THREADED_ENTRY(PUTFIELD)
+                THREADED_ENTRY(PUTSTATIC)
+                THREADED_ENTRY(RET)
+                THREADED_ENTRY(RETURN)
+                THREADED_ENTRY(SALOAD)
+                THREADED_ENTRY(SASTORE)
+                THREADED_ENTRY(SIPUSH)
+                THREADED_ENTRY(SWAP)
+                THREADED_ENTRY(TABLESWITCH)
+                THREADED_ENTRY(WIDE)
+                SUPERINSTRUCTIONS(SUPERINSTRUCTION_ENTRY_PAIR,
+                    SUPERINSTRUCTION_ENTRY_TRIPLE)
+
+                dispatch_table_filled.store(true, std::memory_order_release);
+            }
+            dispatch_table_mutex.unlock();
+        }
+#endif
 
-        // Frame info
-        auto &code = frame->currentCode;
+        // Java methods invoked by the initial frame are executed
+        // in this loop, the current frame changes on invoke and return
+        Frame *frame = initialFrame;
+        COUNT_AND_COMPILE(invocation_count, TemplateCompiler::INVOCATION_THRESHOLD)
 
         // Interpreter loop
         for (; ;)
         {
+            // Frame info
+            auto &code = frame->currentCode;
+
+            if (!Threaded && _profile_ngrams && frame->method != 0)
+            {
+                NGramProfiler::record(&_ngram_window, frame);
+            }
+
 #if IS_LOG_LEVEL_DEBUG
             auto& lineMapping = frame->method->getDebugInfos()->lineMapping;
             auto begin = lineMapping.begin();
@@ -195,7 +725,7 @@ namespace coldspot
             // Execute instruction
             switch (*code)
             {
-                case AALOAD:
+                CASE(AALOAD)
                 {
                     ++code;
                     jint index = frame->pop().as_int();
@@ -211,58 +741,56 @@ namespace coldspot
                         &value);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(value);
-                    break;
+                    NEXT
                 }
 
-                case AASTORE:
+                CASE(AASTORE)
                 {
                     TASTORE
-                    break;
+                    NEXT
                 }
 
-                case ACONST_NULL:
+                CASE(ACONST_NULL)
                 {
                     ++code;
                     frame->push((Object *) 0);
-                    break;
+                    NEXT
                 }
 
-                case ALOAD:
+                CASE(ALOAD)
                 {
                     TLOAD
-                    break;
+                    NEXT
                 }
 
-                case ALOAD_0:
+                CASE(ALOAD_0)
                 {
                     TLOAD_N(0)
-                    break;
+                    NEXT
                 }
 
-                case ALOAD_1:
+                CASE(ALOAD_1)
                 {
                     TLOAD_N(1)
-                    break;
+                    NEXT
                 }
 
-                case ALOAD_2:
+                CASE(ALOAD_2)
                 {
                     TLOAD_N(2)
-                    break;
+                    NEXT
                 }
 
-                case ALOAD_3:
+                CASE(ALOAD_3)
                 {
                     TLOAD_N(3)
-                    break;
+                    NEXT
                 }
 
-                case ANEWARRAY:
+                CASE(ANEWARRAY)
                 {
-
-                    uint8_t indexByte1 = *(++code);
-                    uint8_t indexByte2 = *(++code);
-                    ++code;
+                    CacheEntry *entry = CACHE_ENTRY;
+                    code += 3;
 
                     jint count = frame->pop().as_int();
                     if (count < 0)
@@ -272,37 +800,41 @@ namespace coldspot
                         break;
                     }
 
-                    Class *componentType;
-                    uint16_t index = (indexByte1 << 8) | indexByte2;
-                    error_t errorValue = frame->clazz->get_class_from_cp(index,
-                        &componentType);
-                    BREAK_ON_FAIL(errorValue);
+                    // The entry caches the array-class
+                    if (!entry->resolved)
+                    {
+                        Class *componentType;
+                        error_t errorValue = frame->clazz->get_class_from_cp(
+                            entry->index, &componentType);
+                        BREAK_ON_FAIL(errorValue);
 
-                    StringBuilder builder;
-                    builder << "[L" << componentType->name << ';';
+                        StringBuilder builder;
+                        builder << "[L" << componentType->name << ';';
 
-                    Class *clazz;
-                    errorValue = _vm->class_loader()->load_array(builder.str(),
-                        frame->clazz->class_loader, &clazz);
-                    BREAK_ON_FAIL(errorValue);
+                        errorValue = _vm->class_loader()->load_array(
+                            builder.str(), frame->clazz->class_loader,
+                            &entry->clazz);
+                        BREAK_ON_FAIL(errorValue);
+                        entry->resolved = true;
+                    }
 
                     Array *array;
-                    errorValue = _vm->memory_manager()->allocate_array(clazz,
-                        count, &array);
+                    error_t errorValue = _vm->memory_manager()->allocate_array(
+                        entry->clazz, count, &array);
                     BREAK_ON_FAIL(errorValue);
 
                     frame->push(array);
 
-                    break;
+                    NEXT
                 }
 
-                case ARETURN:
+                CASE(ARETURN)
                 {
                     TRETURN
-                    break;
+                    NEXT
                 }
 
-                case ARRAYLENGTH:
+                CASE(ARRAYLENGTH)
                 {
                     ++code;
                     Array *array = frame->pop().as_array();
@@ -313,48 +845,49 @@ namespace coldspot
                         break;
                     }
                     frame->push(array->length());
-                    break;
+                    NEXT
                 }
 
-                case ASTORE:
+                CASE(ASTORE)
                 {
                     TSTORE
-                    break;
+                    NEXT
                 }
 
-                case ASTORE_0:
+                CASE(ASTORE_0)
                 {
                     TSTORE_N(0)
-                    break;
+                    NEXT
                 }
 
-                case ASTORE_1:
+                CASE(ASTORE_1)
                 {
                     TSTORE_N(1)
-                    break;
+                    NEXT
                 }
 
-                case ASTORE_2:
+                CASE(ASTORE_2)
                 {
                     TSTORE_N(2)
-                    break;
+                    NEXT
                 }
 
-                case ASTORE_3:
+                CASE(ASTORE_3)
                 {
                     TSTORE_N(3)
-                    break;
+                    NEXT
                 }
 
-                case ATHROW:
+                CASE(ATHROW)
                 {
-                    ++code;
+                    // The code is not advanced, because the next instruction
+                    // can belong to a block with different operands
                     THROW_WITH_RETURN_ON_UNWIND(frame->pop().as_object());
                     SAFEPOINT
-                    break;
+                    NEXT
                 }
 
-                case BALOAD:
+                CASE(BALOAD)
                 {
                     ++code;
                     jint index = frame->pop().as_int();
@@ -370,24 +903,24 @@ namespace coldspot
                     error_t errorValue = array->get_value(index, &value);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(Value(Type::TYPE_INT, value.value()));
-                    break;
+                    NEXT
                 }
 
-                case BASTORE:
+                CASE(BASTORE)
                 {
                     TASTORE_VALUE(storeValue.as_byte())
-                    break;
+                    NEXT
                 }
 
-                case BIPUSH:
+                CASE(BIPUSH)
                 {
                     jint value = (jbyte) * (++code);
                     ++code;
                     frame->push(value);
-                    break;
+                    NEXT
                 }
 
-                case CALOAD:
+                CASE(CALOAD)
                 {
                     ++code;
                     jint index = frame->pop().as_int();
@@ -402,23 +935,21 @@ namespace coldspot
                     error_t errorValue = array->get_value<jchar>(index, &value);
                     BREAK_ON_FAIL(errorValue);
                     frame->push((jint) value);
-                    break;
+                    NEXT
                 }
 
-                case CASTORE:
+                CASE(CASTORE)
                 {
                     TASTORE_VALUE(storeValue.as_char())
-                    break;
+                    NEXT
                 }
 
-                case CHECKCAST:
+                CASE(CHECKCAST)
                 {
-                    uint16_t index = (*(++code) << 8) | *(++code);
-                    ++code;
-                    Class *checkType;
-                    error_t errorValue = frame->clazz->get_class_from_cp(index,
-                        &checkType);
-                    BREAK_ON_FAIL(errorValue);
+                    CacheEntry *entry = CACHE_ENTRY;
+                    RESOLVE_ENTRY(entry, get_class_from_cp, clazz)
+                    code += 3;
+                    Class *checkType = entry->clazz;
 
                     Object *object = frame->peek().as_object();
                     if (object == 0)
@@ -433,37 +964,37 @@ namespace coldspot
                             CLASSNAME_CLASSCASTEXCEPTION);
                         break;
                     }
-                    break;
+                    NEXT
                 }
 
-                case D2F:
+                CASE(D2F)
                 {
                     ++code;
                     frame->push((jfloat) frame->pop().as_double());
-                    break;
+                    NEXT
                 }
 
-                case D2I:
+                CASE(D2I)
                 {
                     ++code;
                     frame->push((jint) frame->pop().as_double());
-                    break;
+                    NEXT
                 }
 
-                case D2L:
+                CASE(D2L)
                 {
                     ++code;
                     frame->push((jlong) frame->pop().as_double());
-                    break;
+                    NEXT
                 }
 
-                case DADD:
+                CASE(DADD)
                 {
                     TADD(as_double)
-                    break;
+                    NEXT
                 }
 
-                case DALOAD:
+                CASE(DALOAD)
                 {
                     ++code;
                     jint index = frame->pop().as_int();
@@ -479,17 +1010,17 @@ namespace coldspot
                         &value);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(value);
-                    break;
+                    NEXT
                 }
 
-                case DASTORE:
+                CASE(DASTORE)
                 {
                     TASTORE
-                    break;
+                    NEXT
                 }
 
-                case DCMPG:
-                case DCMPL:
+                CASE(DCMPG)
+                CASE(DCMPL)
                 {
                     ++code;
                     jdouble value2 = frame->pop().as_double();
@@ -509,306 +1040,225 @@ namespace coldspot
                         result = 1;
                     }
                     frame->push(result);
-                    break;
+                    NEXT
                 }
 
-                case DCONST_0:
+                CASE(DCONST_0)
                 {
                     TCONST_V(jdouble, 0)
-                    break;
+                    NEXT
                 }
 
-                case DCONST_1:
+                CASE(DCONST_1)
                 {
                     TCONST_V(jdouble, 1)
-                    break;
+                    NEXT
                 }
 
-                case DDIV:
+                CASE(DDIV)
                 {
                     ++code;
                     jdouble value2 = frame->pop().as_double();
                     jdouble value1 = frame->pop().as_double();
                     frame->push(value1 / value2);
-                    break;
+                    NEXT
                 }
 
-                case DLOAD:
+                CASE(DLOAD)
                 {
                     TLOAD
-                    break;
+                    NEXT
                 }
 
-                case DLOAD_0:
+                CASE(DLOAD_0)
                 {
                     TLOAD_N(0)
-                    break;
+                    NEXT
                 }
 
-                case DLOAD_1:
+                CASE(DLOAD_1)
                 {
                     TLOAD_N(1)
-                    break;
+                    NEXT
                 }
 
-                case DLOAD_2:
+                CASE(DLOAD_2)
                 {
                     TLOAD_N(2)
-                    break;
+                    NEXT
                 }
 
-                case DLOAD_3:
+                CASE(DLOAD_3)
                 {
                     TLOAD_N(3)
-                    break;
+                    NEXT
                 }
 
-                case DMUL:
+                CASE(DMUL)
                 {
                     TMUL(as_double)
-                    break;
+                    NEXT
                 }
 
-                case DNEG:
+                CASE(DNEG)
                 {
                     ++code;
                     frame->push(-frame->pop().as_double());
-                    break;
+                    NEXT
                 }
 
-                case DREM:
+                CASE(DREM)
                 {
                     ++code;
                     jdouble value2 = frame->pop().as_double();
                     jdouble value1 = frame->pop().as_double();
                     frame->push(fmod(value1, value2));
-                    break;
+                    NEXT
                 }
 
-                case DRETURN:
+                CASE(DRETURN)
                 {
                     TRETURN
-                    break;
+                    NEXT
                 }
 
-                case DSTORE:
+                CASE(DSTORE)
                 {
                     TSTORE
-                    break;
+                    NEXT
                 }
 
-                case DSTORE_0:
+                CASE(DSTORE_0)
                 {
                     TSTORE_N(0)
-                    break;
+                    NEXT
                 }
 
-                case DSTORE_1:
+                CASE(DSTORE_1)
                 {
                     TSTORE_N(1)
-                    break;
+                    NEXT
                 }
 
-                case DSTORE_2:
+                CASE(DSTORE_2)
                 {
                     TSTORE_N(2)
-                    break;
+                    NEXT
                 }
 
-                case DSTORE_3:
+                CASE(DSTORE_3)
                 {
                     TSTORE_N(3)
-                    break;
+                    NEXT
                 }
 
-                case DSUB:
+                CASE(DSUB)
                 {
                     TSUB(jdouble, as_double)
-                    break;
+                    NEXT
                 }
 
-                case DUP:
+                CASE(DUP)
                 {
                     ++code;
                     frame->push(frame->peek());
-                    break;
+                    NEXT
                 }
 
-                case DUP_X1:
+                CASE(DUP_X1)
                 {
                     ++code;
-                    Value top1 = frame->pop();
-                    Value top2 = frame->pop();
+                    Slot top1 = frame->pop();
+                    Slot top2 = frame->pop();
                     frame->push(top1);
                     frame->push(top2);
                     frame->push(top1);
-                    break;
+                    NEXT
                 }
 
-                case DUP_X2:
+                CASE(DUP_X2)
                 {
                     ++code;
-                    Value top1 = frame->pop();
-                    Value top2 = frame->pop();
-                    if (top2.type() == Type::TYPE_LONG ||
-                        top2.type() == Type::TYPE_DOUBLE)
-                    {
-                        frame->push(top1);
-                        frame->push(top2);
-                        frame->push(top1);
-                    }
-                    else
-                    {
-                        Value top3 = frame->pop();
-                        frame->push(top1);
-                        frame->push(top3);
-                        frame->push(top2);
-                        frame->push(top1);
-                    }
-                    break;
+                    Slot top1 = frame->pop();
+                    Slot top2 = frame->pop();
+                    Slot top3 = frame->pop();
+                    frame->push(top1);
+                    frame->push(top3);
+                    frame->push(top2);
+                    frame->push(top1);
+                    NEXT
                 }
 
-                case DUP2:
+                CASE(DUP2)
                 {
                     ++code;
-                    Value top1 = frame->pop();
-                    if (top1.type() == Type::TYPE_LONG ||
-                        top1.type() == Type::TYPE_DOUBLE)
-                    {
-                        frame->push(top1);
-                        frame->push(top1);
-                    }
-                    else
-                    {
-                        Value top2 = frame->pop();
-                        frame->push(top2);
-                        frame->push(top1);
-                        frame->push(top2);
-                        frame->push(top1);
-                    }
-                    break;
+                    Slot top1 = frame->pop();
+                    Slot top2 = frame->pop();
+                    frame->push(top2);
+                    frame->push(top1);
+                    frame->push(top2);
+                    frame->push(top1);
+                    NEXT
                 }
 
-                case DUP2_X1:
+                CASE(DUP2_X1)
                 {
                     ++code;
-                    Value top1 = frame->pop();
-                    Value top2 = frame->pop();
-                    if ((top1.type() == Type::TYPE_LONG ||
-                         top1.type() == Type::TYPE_DOUBLE) &&
-                        top2.type() != Type::TYPE_LONG &&
-                        top2.type() != Type::TYPE_DOUBLE)
-                    {
-                        frame->push(top1);
-                        frame->push(top2);
-                        frame->push(top1);
-                    }
-                    else
-                    {
-                        Value top3 = frame->pop();
-                        frame->push(top2);
-                        frame->push(top1);
-                        frame->push(top3);
-                        frame->push(top2);
-                        frame->push(top1);
-                    }
-                    break;
+                    Slot top1 = frame->pop();
+                    Slot top2 = frame->pop();
+                    Slot top3 = frame->pop();
+                    frame->push(top2);
+                    frame->push(top1);
+                    frame->push(top3);
+                    frame->push(top2);
+                    frame->push(top1);
+                    NEXT
                 }
 
-                case DUP2_X2:
+                CASE(DUP2_X2)
                 {
                     ++code;
-                    Value top1 = frame->pop();
-                    Value top2 = frame->pop();
-                    if ((top1.type() == Type::TYPE_LONG ||
-                         top1.type() == Type::TYPE_DOUBLE) &&
-                        (top2.type() == Type::TYPE_LONG ||
-                         top2.type() == Type::TYPE_DOUBLE))
-                    {
-                        frame->push(top1);
-                        frame->push(top2);
-                        frame->push(top1);
-                    }
-                    else
-                    {
-                        Value top3 = frame->pop();
-                        if ((top1.type() != Type::TYPE_LONG &&
-                             top1.type() != Type::TYPE_DOUBLE) &&
-                            (top2.type() != Type::TYPE_LONG &&
-                             top2.type() != Type::TYPE_DOUBLE) &&
-                            (top3.type() == Type::TYPE_LONG ||
-                             top3.type() == Type::TYPE_DOUBLE))
-                        {
-                            frame->push(top2);
-                            frame->push(top1);
-                            frame->push(top3);
-                            frame->push(top2);
-                            frame->push(top1);
-                        }
-                        else if ((top1.type() == Type::TYPE_LONG ||
-                                  top1.type() == Type::TYPE_DOUBLE) &&
-                                 (top2.type() != Type::TYPE_LONG &&
-                                  top2.type() != Type::TYPE_DOUBLE) &&
-                                 (top3.type() != Type::TYPE_LONG &&
-                                  top3.type() != Type::TYPE_DOUBLE))
-                        {
-                            frame->push(top1);
-                            frame->push(top3);
-                            frame->push(top2);
-                            frame->push(top1);
-                        }
-                        else
-                        {
-                            Value top4 = frame->pop();
-                            if ((top1.type() != Type::TYPE_LONG &&
-                                 top1.type() != Type::TYPE_DOUBLE) &&
-                                (top2.type() != Type::TYPE_LONG &&
-                                 top2.type() != Type::TYPE_DOUBLE) &&
-                                (top3.type() != Type::TYPE_LONG &&
-                                 top3.type() != Type::TYPE_DOUBLE) &&
-                                (top4.type() != Type::TYPE_LONG &&
-                                 top4.type() != Type::TYPE_DOUBLE))
-                            {
-                                frame->push(top2);
-                                frame->push(top1);
-                                frame->push(top4);
-                                frame->push(top3);
-                                frame->push(top2);
-                                frame->push(top1);
-                            }
-                        }
-                    }
-                    break;
+                    Slot top1 = frame->pop();
+                    Slot top2 = frame->pop();
+                    Slot top3 = frame->pop();
+                    Slot top4 = frame->pop();
+                    frame->push(top2);
+                    frame->push(top1);
+                    frame->push(top4);
+                    frame->push(top3);
+                    frame->push(top2);
+                    frame->push(top1);
+                    NEXT
                 }
 
-                case F2D:
+                CASE(F2D)
                 {
                     ++code;
                     frame->push((jdouble) frame->pop().as_float());
-                    break;
+                    NEXT
                 }
 
-                case F2I:
+                CASE(F2I)
                 {
                     ++code;
                     frame->push((jint) frame->pop().as_float());
-                    break;
+                    NEXT
                 }
 
-                case F2L:
+                CASE(F2L)
                 {
                     ++code;
                     frame->push((jlong) frame->pop().as_float());
-                    break;
+                    NEXT
                 }
 
-                case FADD:
+                CASE(FADD)
                 {
                     TADD(as_float)
-                    break;
+                    NEXT
                 }
 
-                case FALOAD:
+                CASE(FALOAD)
                 {
                     ++code;
                     jint index = frame->pop().as_int();
@@ -825,17 +1275,17 @@ namespace coldspot
                         &value);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(value);
-                    break;
+                    NEXT
                 }
 
-                case FASTORE:
+                CASE(FASTORE)
                 {
                     TASTORE
-                    break;
+                    NEXT
                 }
 
-                case FCMPG:
-                case FCMPL:
+                CASE(FCMPG)
+                CASE(FCMPL)
                 {
                     ++code;
                     jfloat value2 = frame->pop().as_float();
@@ -854,145 +1304,143 @@ namespace coldspot
                         result = -1;
                     }
                     frame->push(result);
-                    break;
+                    NEXT
                 }
 
-                case FCONST_0:
+                CASE(FCONST_0)
                 {
                     TCONST_V(jfloat, 0)
-                    break;
+                    NEXT
                 }
 
-                case FCONST_1:
+                CASE(FCONST_1)
                 {
                     TCONST_V(jfloat, 1)
-                    break;
+                    NEXT
                 }
 
-                case FCONST_2:
+                CASE(FCONST_2)
                 {
                     TCONST_V(jfloat, 2)
-                    break;
+                    NEXT
                 }
 
-                case FDIV:
+                CASE(FDIV)
                 {
                     ++code;
                     jfloat value2 = frame->pop().as_float();
                     jfloat value1 = frame->pop().as_float();
                     frame->push(value1 / value2);
-                    break;
+                    NEXT
                 }
 
-                case FLOAD:
+                CASE(FLOAD)
                 {
                     TLOAD
-                    break;
+                    NEXT
                 }
 
-                case FLOAD_0:
+                CASE(FLOAD_0)
                 {
                     TLOAD_N(0)
-                    break;
+                    NEXT
                 }
 
-                case FLOAD_1:
+                CASE(FLOAD_1)
                 {
                     TLOAD_N(1)
-                    break;
+                    NEXT
                 }
 
-                case FLOAD_2:
+                CASE(FLOAD_2)
                 {
                     TLOAD_N(2)
-                    break;
+                    NEXT
                 }
 
-                case FLOAD_3:
+                CASE(FLOAD_3)
                 {
                     TLOAD_N(3)
-                    break;
+                    NEXT
                 }
 
-                case FMUL:
+                CASE(FMUL)
                 {
                     TMUL(as_float)
-                    break;
+                    NEXT
                 }
 
-                case FNEG:
+                CASE(FNEG)
                 {
                     ++code;
                     frame->push(-frame->pop().as_float());
-                    break;
+                    NEXT
                 }
 
-                case FREM:
+                CASE(FREM)
                 {
                     ++code;
                     jfloat value2 = frame->pop().as_float();
                     jfloat value1 = frame->pop().as_float();
                     frame->push((jfloat) fmod(value1, value2));
-                    break;
+                    NEXT
                 }
 
-                case FRETURN:
+                CASE(FRETURN)
                 {
                     TRETURN
-                    break;
+                    NEXT
                 }
 
-                case FSTORE:
+                CASE(FSTORE)
                 {
                     TSTORE
-                    break;
+                    NEXT
                 }
 
-                case FSTORE_0:
+                CASE(FSTORE_0)
                 {
                     TSTORE_N(0)
-                    break;
+                    NEXT
                 }
 
-                case FSTORE_1:
+                CASE(FSTORE_1)
                 {
                     TSTORE_N(1)
-                    break;
+                    NEXT
                 }
 
-                case FSTORE_2:
+                CASE(FSTORE_2)
                 {
                     TSTORE_N(2)
-                    break;
+                    NEXT
                 }
 
-                case FSTORE_3:
+                CASE(FSTORE_3)
                 {
                     TSTORE_N(3)
-                    break;
+                    NEXT
                 }
 
-                case FSUB:
+                CASE(FSUB)
                 {
                     TSUB(jfloat, as_float)
-                    break;
+                    NEXT
                 }
 
-                case GETFIELD:
+                CASE(GETFIELD)
                 {
-                    uint64_t fieldIndex = (*(++code) << 8) | *(++code);
-                    ++code;
-                    Field *field;
-                    error_t errorValue = frame->clazz->get_field_from_cp(
-                        fieldIndex, &field);
-                    BREAK_ON_FAIL(errorValue);
+                    CacheEntry *entry = CACHE_ENTRY;
+                    RESOLVE_ENTRY(entry, get_field_from_cp, field)
+                    code += 3;
+                    Field *field = entry->field;
                     if (field->is_static())
                     {
                         THROW_WITH_RETURN_ON_UNWIND(
                             CLASSNAME_INCOMPATIBLECLASSCHANGEERROR);
                         break;
                     }
-                    Value objectValue = frame->pop();
+                    Slot objectValue = frame->pop();
                     Object *object = objectValue.as_object();
                     if (!object)
                     {
@@ -1001,100 +1449,209 @@ namespace coldspot
                         break;
                     }
                     frame->push(field->get(object));
-                    break;
-                }
 
-                case GETSTATIC:
-                {
-                    uint64_t fieldIndex = (*(++code) << 8) | *(++code);
-                    ++code;
-                    Field *field;
-                    error_t errorValue = frame->clazz->get_field_from_cp(
-                        fieldIndex, &field);
-                    BREAK_ON_FAIL(errorValue);
-                    errorValue = _vm->class_loader()->initialize_class(
-                        field->declaring_class());
-                    BREAK_ON_FAIL(errorValue);
-                    if (!field->is_static())
-                    {
-                        THROW_WITH_RETURN_ON_UNWIND(
-                            CLASSNAME_INCOMPATIBLECLASSCHANGEERROR);
-                        break;
-                    }
-                    frame->push(field->get_static());
-                    break;
+                    // Use the quick instruction on further executions
+                    entry->offset = field->offset();
+                    rewrite_instruction(code - 3,
+                        Translator::quick_field_instruction(
+                            GETFIELD_BYTE_QUICK, field->type()->type));
+                    NEXT
                 }
 
-                case GOTO:
+                CASE(GETFIELD_BYTE_QUICK)
                 {
-                    uint8_t *currentCode = code;
-                    int16_t offset = (*(++code) << 8) | *(++code);
-                    code = currentCode + offset;
-                    SAFEPOINT
-                    break;
+                    GETFIELD_QUICK(jbyte)
+                    NEXT
                 }
 
-                case GOTO_W:
+                CASE(GETFIELD_CHAR_QUICK)
                 {
-                    uint8_t *currentCode = code;
-                    int32_t offset = (*(++code) << 24) | (*(++code) << 16) |
-                                     (*(++code) << 8) | *(++code);
-                    code = currentCode + offset;
-                    SAFEPOINT
-                    break;
+                    GETFIELD_QUICK(jchar)
+                    NEXT
                 }
 
-                case I2B:
+                CASE(GETFIELD_SHORT_QUICK)
                 {
-                    ++code;
-                    frame->push((jint) frame->pop().as_byte());
-                    break;
+                    GETFIELD_QUICK(jshort)
+                    NEXT
                 }
 
-                case I2C:
+                CASE(GETFIELD_INT_QUICK)
                 {
-                    ++code;
-                    jchar value = (jchar) frame->pop().as_int();
-                    frame->push((jint) value);
-                    break;
+                    GETFIELD_QUICK(jint)
+                    NEXT
                 }
 
-                case I2D:
+                CASE(GETFIELD_FLOAT_QUICK)
                 {
-                    ++code;
-                    frame->push((jdouble) frame->pop().as_int());
-                    break;
+                    GETFIELD_QUICK(jfloat)
+                    NEXT
                 }
 
-                case I2F:
+                CASE(GETFIELD_LONG_QUICK)
                 {
-                    ++code;
-                    frame->push((jfloat) frame->pop().as_int());
-                    break;
+                    GETFIELD_QUICK(jlong)
+                    NEXT
                 }
 
-                case I2L:
+                CASE(GETFIELD_DOUBLE_QUICK)
                 {
-                    ++code;
-                    frame->push((jlong) frame->pop().as_int());
-                    break;
+                    GETFIELD_QUICK(jdouble)
+                    NEXT
                 }
 
-                case I2S:
+                CASE(GETFIELD_REF_QUICK)
                 {
-                    ++code;
-                    jshort value = (jshort) frame->pop().as_int();
-                    frame->push((jint) value);
-                    break;
+                    GETFIELD_QUICK(Object *)
+                    NEXT
                 }
 
-                case IADD:
+                CASE(GETSTATIC)
                 {
-                    TADD(as_int)
-                    break;
+                    CacheEntry *entry = CACHE_ENTRY;
+                    RESOLVE_ENTRY(entry, get_field_from_cp, field)
+                    code += 3;
+                    Field *field = entry->field;
+                    INITIALIZE_CLASS(field->declaring_class())
+                    if (!field->is_static())
+                    {
+                        THROW_WITH_RETURN_ON_UNWIND(
+                            CLASSNAME_INCOMPATIBLECLASSCHANGEERROR);
+                        break;
+                    }
+                    frame->push(field->get_static());
+
+                    // Use the quick instruction on further executions,
+                    // once the initialization of the class is complete
+                    Class *declaringClass = field->declaring_class();
+                    if (declaringClass->is_initialized())
+                    {
+                        entry->address = declaringClass->static_memory +
+                                         field->offset();
+                        rewrite_instruction(code - 3,
+                            Translator::quick_field_instruction(
+                                GETSTATIC_BYTE_QUICK, field->type()->type));
+                    }
+                    NEXT
+                }
+
+                CASE(GETSTATIC_BYTE_QUICK)
+                {
+                    GETSTATIC_QUICK(jbyte)
+                    NEXT
+                }
+
+                CASE(GETSTATIC_CHAR_QUICK)
+                {
+                    GETSTATIC_QUICK(jchar)
+                    NEXT
+                }
+
+                CASE(GETSTATIC_SHORT_QUICK)
+                {
+                    GETSTATIC_QUICK(jshort)
+                    NEXT
+                }
+
+                CASE(GETSTATIC_INT_QUICK)
+                {
+                    GETSTATIC_QUICK(jint)
+                    NEXT
+                }
+
+                CASE(GETSTATIC_FLOAT_QUICK)
+                {
+                    GETSTATIC_QUICK(jfloat)
+                    NEXT
+                }
+
+                CASE(GETSTATIC_LONG_QUICK)
+                {
+                    GETSTATIC_QUICK(jlong)
+                    NEXT
+                }
+
+                CASE(GETSTATIC_DOUBLE_QUICK)
+                {
+                    GETSTATIC_QUICK(jdouble)
+                    NEXT
+                }
+
+                CASE(GETSTATIC_REF_QUICK)
+                {
+                    GETSTATIC_QUICK(Object *)
+                    NEXT
+                }
+
+                CASE(GOTO)
+                {
+                    int16_t offset = read_operand<int16_t>(code + 1);
+                    code += offset;
+                    SAFEPOINT_BRANCH(offset)
+                    BACKEDGE(offset)
+                    NEXT
+                }
+
+                CASE(GOTO_W)
+                {
+                    int32_t offset = read_operand<int32_t>(code + 1);
+                    code += offset;
+                    SAFEPOINT_BRANCH(offset)
+                    BACKEDGE(offset)
+                    NEXT
+                }
+
+                CASE(I2B)
+                {
+                    ++code;
+                    frame->push((jint) frame->pop().as_byte());
+                    NEXT
+                }
+
+                CASE(I2C)
+                {
+                    ++code;
+                    jchar value = (jchar) frame->pop().as_int();
+                    frame->push((jint) value);
+                    NEXT
                 }
 
-                case IALOAD:
+                CASE(I2D)
+                {
+                    ++code;
+                    frame->push((jdouble) frame->pop().as_int());
+                    NEXT
+                }
+
+                CASE(I2F)
+                {
+                    ++code;
+                    frame->push((jfloat) frame->pop().as_int());
+                    NEXT
+                }
+
+                CASE(I2L)
+                {
+                    ++code;
+                    frame->push((jlong) frame->pop().as_int());
+                    NEXT
+                }
+
+                CASE(I2S)
+                {
+                    ++code;
+                    jshort value = (jshort) frame->pop().as_int();
+                    frame->push((jint) value);
+                    NEXT
+                }
+
+                CASE(IADD)
+                {
+                    TADD(as_int)
+                    NEXT
+                }
+
+                CASE(IALOAD)
                 {
                     ++code;
 
@@ -1111,67 +1668,67 @@ namespace coldspot
                     error_t errorValue = array->get_value<jint>(index, &value);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(value);
-                    break;
+                    NEXT
                 }
 
-                case IAND:
+                CASE(IAND)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
                     jint value1 = frame->pop().as_int();
                     frame->push(value1 & value2);
-                    break;
+                    NEXT
                 }
 
-                case IASTORE:
+                CASE(IASTORE)
                 {
                     TASTORE
-                    break;
+                    NEXT
                 }
 
-                case ICONST_M1:
+                CASE(ICONST_M1)
                 {
                     TCONST_V(jint, -1)
-                    break;
+                    NEXT
                 }
 
-                case ICONST_0:
+                CASE(ICONST_0)
                 {
                     TCONST_V(jint, 0)
-                    break;
+                    NEXT
                 }
 
-                case ICONST_1:
+                CASE(ICONST_1)
                 {
                     TCONST_V(jint, 1)
-                    break;
+                    NEXT
                 }
 
-                case ICONST_2:
+                CASE(ICONST_2)
                 {
                     TCONST_V(jint, 2)
-                    break;
+                    NEXT
                 }
 
-                case ICONST_3:
+                CASE(ICONST_3)
                 {
                     TCONST_V(jint, 3)
-                    break;
+                    NEXT
                 }
 
-                case ICONST_4:
+                CASE(ICONST_4)
                 {
                     TCONST_V(jint, 4)
-                    break;
+                    NEXT
                 }
 
-                case ICONST_5:
+                CASE(ICONST_5)
                 {
                     TCONST_V(jint, 5)
-                    break;
+                    NEXT
                 }
 
-                case IDIV:
+                CASE(IDIV)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
@@ -1182,167 +1739,164 @@ namespace coldspot
                             CLASSNAME_ARITHMETICEXCEPTION);
                         break;
                     }
-                    frame->push(value1 / value2);
-                    break;
+                    // MIN_VALUE / -1 overflows and traps, it wraps to
+                    // MIN_VALUE
+                    frame->push(value2 == -1 ? (jint) (0 - (uint32_t) value1)
+                                             : value1 / value2);
+                    NEXT
                 }
 
-                case IF_ACMPEQ:
+                CASE(IF_ACMPEQ)
                 {
                     IF_ACMP(==)
-                    break;
+                    NEXT
                 }
 
-                case IF_ACMPNE:
+                CASE(IF_ACMPNE)
                 {
                     IF_ACMP(!=)
-                    break;
+                    NEXT
                 }
 
-                case IF_ICMPEQ:
+                CASE(IF_ICMPEQ)
                 {
                     IF_ICMP(==)
-                    break;
+                    NEXT
                 }
 
-                case IF_ICMPNE:
+                CASE(IF_ICMPNE)
                 {
                     IF_ICMP(!=)
-                    break;
+                    NEXT
                 }
 
-                case IF_ICMPLT:
+                CASE(IF_ICMPLT)
                 {
                     IF_ICMP(<)
-                    break;
+                    NEXT
                 }
 
-                case IF_ICMPGE:
+                CASE(IF_ICMPGE)
                 {
                     IF_ICMP(>=)
-                    break;
+                    NEXT
                 }
 
-                case IF_ICMPGT:
+                CASE(IF_ICMPGT)
                 {
                     IF_ICMP(>)
-                    break;
+                    NEXT
                 }
 
-                case IF_ICMPLE:
+                CASE(IF_ICMPLE)
                 {
                     IF_ICMP(<=)
-                    break;
+                    NEXT
                 }
 
-                case IFEQ:
+                CASE(IFEQ)
                 {
                     IF(==)
-                    break;
+                    NEXT
                 }
 
-                case IFNE:
+                CASE(IFNE)
                 {
                     IF(!=)
-                    break;
+                    NEXT
                 }
 
-                case IFLT:
+                CASE(IFLT)
                 {
                     IF(<)
-                    break;
+                    NEXT
                 }
 
-                case IFGE:
+                CASE(IFGE)
                 {
                     IF(>=)
-                    break;
+                    NEXT
                 }
 
-                case IFGT:
+                CASE(IFGT)
                 {
                     IF(>)
-                    break;
+                    NEXT
                 }
 
-                case IFLE:
+                CASE(IFLE)
                 {
                     IF(<=)
-                    break;
+                    NEXT
                 }
 
-                case IFNONNULL:
+                CASE(IFNONNULL)
                 {
                     IFXNULL(!=)
-                    break;
+                    NEXT
                 }
 
-                case IFNULL:
+                CASE(IFNULL)
                 {
                     IFXNULL(==)
-                    break;
+                    NEXT
                 }
 
-                case IINC:
+                CASE(IINC)
                 {
-                    Value &localVariable = frame->localVariables[*(++code)];
-                    jint value = (jbyte) * (++code);
-                    ++code;
-                    localVariable.set_value(localVariable.as_int() + value);
-                    break;
+                    TIINC
+                    NEXT
                 }
 
-                case ILOAD:
+                CASE(ILOAD)
                 {
                     TLOAD
-                    break;
+                    NEXT
                 }
 
-                case ILOAD_0:
+                CASE(ILOAD_0)
                 {
                     TLOAD_N(0)
-                    break;
+                    NEXT
                 }
 
-                case ILOAD_1:
+                CASE(ILOAD_1)
                 {
                     TLOAD_N(1)
-                    break;
+                    NEXT
                 }
 
-                case ILOAD_2:
+                CASE(ILOAD_2)
                 {
                     TLOAD_N(2)
-                    break;
+                    NEXT
                 }
 
-                case ILOAD_3:
+                CASE(ILOAD_3)
                 {
                     TLOAD_N(3)
-                    break;
+                    NEXT
                 }
 
-                case IMUL:
+                CASE(IMUL)
                 {
                     TMUL(as_int)
-                    break;
+                    NEXT
                 }
 
-                case INEG:
+                CASE(INEG)
                 {
                     ++code;
                     frame->push(-frame->pop().as_int());
-                    break;
+                    NEXT
                 }
 
-                case INSTANCEOF:
+                CASE(INSTANCEOF)
                 {
-                    uint16_t index = (*(++code) << 8) | *(++code);
-                    ++code;
-
-                    Class *checkClass;
-                    error_t errorValue = frame->clazz->get_class_from_cp(index,
-                        &checkClass);
-                    BREAK_ON_FAIL(errorValue);
+                    CacheEntry *entry = CACHE_ENTRY;
+                    RESOLVE_ENTRY(entry, get_class_from_cp, clazz)
+                    code += 3;
+                    Class *checkClass = entry->clazz;
 
                     Object *object = frame->pop().as_object();
                     if (object == 0)
@@ -1360,17 +1914,17 @@ namespace coldspot
                     {
                         frame->push((jint) 0);
                     }
-                    break;
+                    NEXT
                 }
 
-                case INVOKEDYNAMIC:
+                CASE(INVOKEDYNAMIC)
                 {
                     EXIT_FATAL("unimplemented instruction invokedynamic");
                     // TODO implement
                     return RETURN_ERROR;
                 }
 
-                case INVOKEINTERFACE:
+                CASE(INVOKEINTERFACE)
                 {
 
                     Class *invokeClass;
@@ -1379,42 +1933,16 @@ namespace coldspot
 
                     invokeClass = invokeMethod->declaring_class();
 
-                    code += 2;
-
-                    Object *object;
+                    PEEK_ARGUMENTS
 
-                    dynarray <Value> parameters(
-                        invokeMethod->parameter_types().size());
-                    errorValue = fill_parameters(frame, invokeMethod, &object,
-                        parameters);
-                    BREAK_ON_FAIL(errorValue);
-
-                    errorValue = Method::lookupInterface(&invokeClass,
+                    errorValue = lookup_cached(entry, true, &invokeClass,
                         &invokeMethod, object);
                     BREAK_ON_FAIL(errorValue);
 
-                    Value value;
-                    if (invokeMethod->isNative())
-                    {
-                        errorValue = invokeMethod->invokeNative(object,
-                            parameters, &value);
-                    }
-                    else
-                    {
-                        errorValue = invokeMethod->invokeJava(object,
-                            parameters, &value);
-                    }
-                    BREAK_ON_FAIL(errorValue);
-                    if (invokeMethod->return_type()->type != Type::TYPE_VOID)
-                    {
-                        frame->push(value);
-                    }
-
-                    SAFEPOINT
-                    break;
+                    INVOKE(5)
                 }
 
-                case INVOKESPECIAL:
+                CASE(INVOKESPECIAL)
                 {
 
                     Class *invokeClass;
@@ -1423,39 +1951,16 @@ namespace coldspot
 
                     invokeClass = invokeMethod->declaring_class();
 
-                    Object *object;
-                    dynarray <Value> parameters(
-                        invokeMethod->parameter_types().size());
-                    errorValue = fill_parameters(frame, invokeMethod, &object,
-                        parameters);
-                    BREAK_ON_FAIL(errorValue);
+                    PEEK_ARGUMENTS
 
                     errorValue = Method::lookupSpecial(&invokeClass,
                         &invokeMethod);
                     BREAK_ON_FAIL(errorValue);
 
-                    Value value;
-                    if (invokeMethod->isNative())
-                    {
-                        errorValue = invokeMethod->invokeNative(object,
-                            parameters, &value);
-                    }
-                    else
-                    {
-                        errorValue = invokeMethod->invokeJava(object,
-                            parameters, &value);
-                    }
-                    BREAK_ON_FAIL(errorValue);
-                    if (invokeMethod->return_type()->type != Type::TYPE_VOID)
-                    {
-                        frame->push(value);
-                    }
-
-                    SAFEPOINT
-                    break;
+                    INVOKE(3)
                 }
 
-                case INVOKESTATIC:
+                CASE(INVOKESTATIC)
                 {
 
                     Class *invokeClass;
@@ -1463,40 +1968,14 @@ namespace coldspot
                     FILL_INVOKE_INFO
 
                     invokeClass = invokeMethod->declaring_class();
-                    errorValue = _vm->class_loader()->initialize_class(
-                        invokeClass);
-                    BREAK_ON_FAIL(errorValue);
-
-                    Object *object;
-                    dynarray <Value> parameters(
-                        invokeMethod->parameter_types().size());
-                    errorValue = fill_parameters(frame, invokeMethod, &object,
-                        parameters);
-                    BREAK_ON_FAIL(errorValue);
-
-                    Value value;
-                    if (invokeMethod->isNative())
-                    {
-                        errorValue = invokeMethod->invokeNative(object,
-                            parameters, &value);
-                    }
-                    else
-                    {
-                        errorValue = invokeMethod->invokeJava(object,
-                            parameters, &value);
-                    }
-                    BREAK_ON_FAIL(errorValue);
+                    INITIALIZE_CLASS(invokeClass)
 
-                    if (invokeMethod->return_type()->type != Type::TYPE_VOID)
-                    {
-                        frame->push(value);
-                    }
+                    PEEK_ARGUMENTS
 
-                    SAFEPOINT
-                    break;
+                    INVOKE(3)
                 }
 
-                case INVOKEVIRTUAL:
+                CASE(INVOKEVIRTUAL)
                 {
 
                     Class *invokeClass;
@@ -1505,49 +1984,25 @@ namespace coldspot
 
                     invokeClass = invokeMethod->declaring_class();
 
-                    Object *object;
-                    dynarray <Value> parameters(
-                        invokeMethod->parameter_types().size());
-                    errorValue = fill_parameters(frame, invokeMethod, &object,
-                        parameters);
-                    BREAK_ON_FAIL(errorValue);
+                    PEEK_ARGUMENTS
 
-                    errorValue = Method::lookupVirtual(&invokeClass,
+                    errorValue = lookup_cached(entry, false, &invokeClass,
                         &invokeMethod, object);
                     BREAK_ON_FAIL(errorValue);
 
-                    Value value;
-                    if (invokeMethod->isNative())
-                    {
-                        errorValue = invokeMethod->invokeNative(object,
-                            parameters, &value);
-                    }
-                    else
-                    {
-                        errorValue = invokeMethod->invokeJava(object,
-                            parameters, &value);
-                    }
-                    BREAK_ON_FAIL(errorValue);
-
-                    if (invokeMethod->return_type()->type != Type::TYPE_VOID)
-                    {
-                        frame->push(value);
-                    }
-
-                    SAFEPOINT
-                    break;
+                    INVOKE(3)
                 }
 
-                case IOR:
+                CASE(IOR)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
                     jint value1 = frame->pop().as_int();
                     frame->push(value1 | value2);
-                    break;
+                    NEXT
                 }
 
-                case IREM:
+                CASE(IREM)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
@@ -1558,144 +2013,142 @@ namespace coldspot
                             CLASSNAME_ARITHMETICEXCEPTION);
                         break;
                     }
-                    frame->push(value1 % value2);
-                    break;
+                    // MIN_VALUE % -1 traps, any remainder of -1 is 0
+                    frame->push(value2 == -1 ? 0 : value1 % value2);
+                    NEXT
                 }
 
-                case IRETURN:
+                CASE(IRETURN)
                 {
                     TRETURN
-                    break;
+                    NEXT
                 }
 
-                case ISHL:
+                CASE(ISHL)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
                     jint value1 = frame->pop().as_int();
                     frame->push(value1 << value2);
-                    break;
+                    NEXT
                 }
 
-                case ISHR:
+                CASE(ISHR)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
                     jint value1 = frame->pop().as_int();
                     frame->push(value1 >> value2);
-                    break;
+                    NEXT
                 }
 
-                case ISTORE:
+                CASE(ISTORE)
                 {
                     TSTORE
-                    break;
+                    NEXT
                 }
 
-                case ISTORE_0:
+                CASE(ISTORE_0)
                 {
                     TSTORE_N(0)
-                    break;
+                    NEXT
                 }
 
-                case ISTORE_1:
+                CASE(ISTORE_1)
                 {
                     TSTORE_N(1)
-                    break;
+                    NEXT
                 }
 
-                case ISTORE_2:
+                CASE(ISTORE_2)
                 {
                     TSTORE_N(2)
-                    break;
+                    NEXT
                 }
 
-                case ISTORE_3:
+                CASE(ISTORE_3)
                 {
                     TSTORE_N(3)
-                    break;
+                    NEXT
                 }
 
-                case ISUB:
+                CASE(ISUB)
                 {
                     TSUB(jint, as_int)
-                    break;
+                    NEXT
                 }
 
-                case IUSHR:
+                CASE(IUSHR)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
                     jint value1 = frame->pop().as_int();
                     frame->push((jint)(((uint32_t) value1) >> value2));
-                    break;
+                    NEXT
                 }
 
-                case IXOR:
+                CASE(IXOR)
                 {
                     ++code;
                     jint value2 = frame->pop().as_int();
                     jint value1 = frame->pop().as_int();
                     jint result = value1 ^value2;
                     frame->push(result);
-                    break;
+                    NEXT
                 }
 
-                case JSR:
+                CASE(JSR)
                 {
                     uint8_t *currentCode = code;
-                    uint8_t index1 = *(++code);
-                    uint8_t index2 = *(++code);
-                    ++code;
-                    int16_t offset = (index1 << 8) | index2;
+                    int16_t offset = read_operand<int16_t>(code + 1);
+                    code += 3;
                     frame->push(
                         Value(Type::TYPE_RETURNADDRESS, CURRENT_PC(frame)));
                     code = currentCode + offset;
-                    SAFEPOINT
-                    break;
+                    SAFEPOINT_BRANCH(offset)
+                    NEXT
                 }
 
-                case JSR_W:
+                CASE(JSR_W)
                 {
                     uint8_t *currentCode = code;
-                    int32_t offset = (*(++code) << 24) | (*(++code) << 16) |
-                                     (*(++code) << 8) | *(++code);
-                    ++code;
+                    int32_t offset = read_operand<int32_t>(code + 1);
+                    code += 5;
                     frame->push(
                         Value(Type::TYPE_RETURNADDRESS, CURRENT_PC(frame)));
                     code = currentCode + offset;
-                    SAFEPOINT
-                    break;
+                    SAFEPOINT_BRANCH(offset)
+                    NEXT
                 }
 
-                case L2D:
+                CASE(L2D)
                 {
                     ++code;
                     frame->push((double) frame->pop().as_long());
-                    break;
+                    NEXT
                 }
 
-                case L2F:
+                CASE(L2F)
                 {
                     ++code;
                     frame->push((float) frame->pop().as_long());
-                    break;
+                    NEXT
                 }
 
-                case L2I:
+                CASE(L2I)
                 {
                     ++code;
                     frame->push((jint) frame->pop().as_long());
-                    break;
+                    NEXT
                 }
 
-                case LADD:
+                CASE(LADD)
                 {
                     TADD(as_long)
-                    break;
+                    NEXT
                 }
 
-                case LALOAD:
+                CASE(LALOAD)
                 {
                     ++code;
                     jint index = frame->pop().as_int();
@@ -1711,25 +2164,25 @@ namespace coldspot
                     error_t errorValue = array->get_value<jlong>(index, &value);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(value);
-                    break;
+                    NEXT
                 }
 
-                case LAND:
+                CASE(LAND)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
                     jlong value1 = frame->pop().as_long();
                     frame->push(value1 & value2);
-                    break;
+                    NEXT
                 }
 
-                case LASTORE:
+                CASE(LASTORE)
                 {
                     TASTORE
-                    break;
+                    NEXT
                 }
 
-                case LCMP:
+                CASE(LCMP)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
@@ -1748,142 +2201,61 @@ namespace coldspot
                         result = -1;
                     }
                     frame->push(result);
-                    break;
+                    NEXT
                 }
 
-                case LCONST_0:
+                CASE(LCONST_0)
                 {
                     TCONST_V(jlong, 0)
-                    break;
+                    NEXT
                 }
 
-                case LCONST_1:
+                CASE(LCONST_1)
                 {
                     TCONST_V(jlong, 1)
-                    break;
+                    NEXT
                 }
 
-                case LDC:
+                CASE(LDC)
                 {
-                    uint8_t index = *(++code);
-                    ++code;
-
-                    ConstantPoolEntry *entry = frame->clazz->class_file->constantPool[index];
-                    switch (entry->tag)
+                    CacheEntry *entry =
+                        &frame->method->cache_entries()[*(code + 1)];
+                    code += 2;
+                    if (!entry->resolved)
                     {
-                        case CP_INTEGER:
-                        {
-                            frame->push(
-                                frame->clazz->get_integer_from_cp(index));
-                            break;
-                        }
-                        case CP_FLOAT:
-                        {
-                            frame->push(frame->clazz->get_float_from_cp(index));
-                            break;
-                        }
-                        case CP_STRING:
-                        {
-                            Object *string;
-                            error_t errorValue = frame->clazz->get_string_from_cp(
-                                index, &string);
-                            BREAK_ON_FAIL(errorValue);
-                            frame->push(string);
-                            break;
-                        }
-                        case CP_CLASS:
-                        {
-                            Class *clazz;
-                            error_t errorValue = frame->clazz->get_class_from_cp(
-                                index, &clazz);
-                            BREAK_ON_FAIL(errorValue);
-                            frame->push(clazz->object);
-                            break;
-                        }
-                        default:
-                        {
-                            EXIT_FATAL(
-                                "unimplemented constant-pool-entry in ldc");
-                        }
+                        error_t errorValue = resolve_constant(frame, entry);
+                        BREAK_ON_FAIL(errorValue);
                     }
-                    break;
+                    frame->push(entry->value);
+                    NEXT
                 }
 
-                case LDC_W:
+                CASE(LDC_W)
+                CASE(LDC2_W)
                 {
-                    uint16_t index = (*(++code) << 8) | *(++code);
-                    ++code;
-
-                    ConstantPoolEntry *entry = frame->clazz->class_file->constantPool[index];
-                    switch (entry->tag)
+                    CacheEntry *entry = CACHE_ENTRY;
+                    code += 3;
+                    if (!entry->resolved)
                     {
-                        case CP_INTEGER:
-                        {
-                            frame->push(
-                                frame->clazz->get_integer_from_cp(index));
-                            break;
-                        }
-                        case CP_FLOAT:
-                        {
-                            frame->push(frame->clazz->get_float_from_cp(index));
-                            break;
-                        }
-                        case CP_STRING:
-                        {
-                            Object *string;
-                            error_t errorValue = frame->clazz->get_string_from_cp(
-                                index, &string);
-                            BREAK_ON_FAIL(errorValue);
-                            frame->push(string);
-                            break;
-                        }
-                        case CP_CLASS:
-                        {
-                            Class *clazz;
-                            error_t errorValue = frame->clazz->get_class_from_cp(
-                                index, &clazz);
-                            BREAK_ON_FAIL(errorValue);
-                            frame->push(clazz->object);
-                            break;
-                        }
-                        default:
-                        {
-                            EXIT_FATAL(
-                                "unimplemented constant-pool-entry in ldc_w");
-                        }
+                        error_t errorValue = resolve_constant(frame, entry);
+                        BREAK_ON_FAIL(errorValue);
                     }
-                    break;
+                    frame->push(entry->value);
+                    NEXT
                 }
 
-                case LDC2_W:
+                CASE(LDC_UNCACHED)
                 {
-                    uint16_t index = (*(++code) << 8) | *(++code);
-                    ++code;
-
-                    ConstantPoolEntry *entry = frame->clazz->class_file->constantPool[index];
-                    switch (entry->tag)
-                    {
-                        case CP_LONG:
-                        {
-                            frame->push(frame->clazz->get_long_from_cp(index));
-                            break;
-                        }
-                        case CP_DOUBLE:
-                        {
-                            frame->push(
-                                frame->clazz->get_double_from_cp(index));
-                            break;
-                        }
-                        default:
-                        {
-                            EXIT_FATAL(
-                                "unimplemented constant-pool-entry in ldc2_w");
-                        }
-                    }
-                    break;
+                    CacheEntry entry;
+                    entry.index = *(code + 1);
+                    code += 2;
+                    error_t errorValue = resolve_constant(frame, &entry);
+                    BREAK_ON_FAIL(errorValue);
+                    frame->push(entry.value);
+                    NEXT
                 }
 
-                case LDIV:
+                CASE(LDIV)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
@@ -1894,108 +2266,91 @@ namespace coldspot
                             CLASSNAME_ARITHMETICEXCEPTION);
                         break;
                     }
-                    frame->push(value1 / value2);
-                    break;
+                    // MIN_VALUE / -1 overflows and traps, it wraps to
+                    // MIN_VALUE
+                    frame->push(value2 == -1 ? (jlong) (0 - (uint64_t) value1)
+                                             : value1 / value2);
+                    NEXT
                 }
 
-                case LLOAD:
+                CASE(LLOAD)
                 {
                     TLOAD
-                    break;
+                    NEXT
                 }
 
-                case LLOAD_0:
+                CASE(LLOAD_0)
                 {
                     TLOAD_N(0)
-                    break;
+                    NEXT
                 }
 
-                case LLOAD_1:
+                CASE(LLOAD_1)
                 {
                     TLOAD_N(1)
-                    break;
+                    NEXT
                 }
 
-                case LLOAD_2:
+                CASE(LLOAD_2)
                 {
                     TLOAD_N(2)
-                    break;
+                    NEXT
                 }
 
-                case LLOAD_3:
+                CASE(LLOAD_3)
                 {
                     TLOAD_N(3)
-                    break;
+                    NEXT
                 }
 
-                case LMUL:
+                CASE(LMUL)
                 {
                     TMUL(as_long)
-                    break;
+                    NEXT
                 }
 
-                case LNEG:
+                CASE(LNEG)
                 {
                     ++code;
                     frame->push(-frame->pop().as_long());
-                    break;
+                    NEXT
                 }
 
-                case LOOKUPSWITCH:
+                CASE(LOOKUPSWITCH)
                 {
-                    uint32_t beginProgramCounter = CURRENT_PC(frame);
-                    ++code;
-
-                    uint32_t programCounter = CURRENT_PC(frame);
-                    programCounter = (programCounter + 3) & ~0x03;
-                    code = &frame->method->code()[programCounter];
-
-                    int32_t defaultValue =
-                        (*code << 24) | (*(++code) << 16) | (*(++code) << 8) |
-                        *(++code);
+                    // Operands are 4-byte aligned
+                    uint32_t padding = 3 - CURRENT_PC(frame) % 4;
+                    uint8_t *operands = code + 1 + padding;
 
-                    int32_t pairCount = (*(++code) << 24) | (*(++code) << 16) |
-                                        (*(++code) << 8) | *(++code);
+                    int32_t offset = read_operand<int32_t>(operands);
+                    int32_t pairCount = read_operand<int32_t>(operands + 4);
 
-                    jint keyValue = frame->pop().as_int();
+                    jint key = frame->pop().as_int();
 
-                    int32_t offsetValue = defaultValue;
-
-                    for (int32_t i = 0; i < pairCount; ++i)
+                    uint8_t *pair = operands + 8;
+                    for (int32_t i = 0; i < pairCount; ++i, pair += 8)
                     {
-                        int32_t matchValue =
-                            (*(++code) << 24) | (*(++code) << 16) |
-                            (*(++code) << 8) | *(++code);
-
-                        if (matchValue == keyValue)
+                        if (read_operand<int32_t>(pair) == key)
                         {
-                            offsetValue =
-                                (*(++code) << 24) | (*(++code) << 16) |
-                                (*(++code) << 8) | *(++code);
+                            offset = read_operand<int32_t>(pair + 4);
                             break;
                         }
-                        else
-                        {
-                            code += 4;
-                        }
                     }
 
-                    code = &frame->method->code()[beginProgramCounter +
-                                                  offsetValue];
-
-                    break;
+                    code += offset;
+                    NEXT
                 }
 
-                case LOR:
+                CASE(LOR)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
                     jlong value1 = frame->pop().as_long();
                     frame->push(value1 | value2);
-                    break;
+                    NEXT
                 }
 
-                case LREM:
+                CASE(LREM)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
@@ -2006,89 +2361,90 @@ namespace coldspot
                             CLASSNAME_ARITHMETICEXCEPTION);
                         break;
                     }
-                    frame->push(value1 % value2);
-                    break;
+                    // MIN_VALUE % -1 traps, any remainder of -1 is 0
+                    frame->push(value2 == -1 ? 0 : value1 % value2);
+                    NEXT
                 }
 
-                case LRETURN:
+                CASE(LRETURN)
                 {
                     TRETURN
-                    break;
+                    NEXT
                 }
 
-                case LSHL:
+                CASE(LSHL)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
                     jlong value1 = frame->pop().as_long();
                     frame->push(value1 << value2);
-                    break;
+                    NEXT
                 }
 
-                case LSHR:
+                CASE(LSHR)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
                     jlong value1 = frame->pop().as_long();
                     frame->push(value1 >> value2);
-                    break;
+                    NEXT
                 }
 
-                case LSTORE:
+                CASE(LSTORE)
                 {
                     TSTORE
-                    break;
+                    NEXT
                 }
 
-                case LSTORE_0:
+                CASE(LSTORE_0)
                 {
                     TSTORE_N(0)
-                    break;
+                    NEXT
                 }
 
-                case LSTORE_1:
+                CASE(LSTORE_1)
                 {
                     TSTORE_N(1)
-                    break;
+                    NEXT
                 }
 
-                case LSTORE_2:
+                CASE(LSTORE_2)
                 {
                     TSTORE_N(2)
-                    break;
+                    NEXT
                 }
 
-                case LSTORE_3:
+                CASE(LSTORE_3)
                 {
                     TSTORE_N(3)
-                    break;
+                    NEXT
                 }
 
-                case LSUB:
+                CASE(LSUB)
                 {
                     TSUB(jlong, as_long)
-                    break;
+                    NEXT
                 }
 
-                case LUSHR:
+                CASE(LUSHR)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
                     jlong value1 = frame->pop().as_long();
                     frame->push((jlong)(((uint64_t) value1) >> value2));
-                    break;
+                    NEXT
                 }
 
-                case LXOR:
+                CASE(LXOR)
                 {
                     ++code;
                     jlong value2 = frame->pop().as_long();
                     jlong value1 = frame->pop().as_long();
                     frame->push(value1 ^ value2);
-                    break;
+                    NEXT
                 }
 
-                case MONITORENTER:
+                CASE(MONITORENTER)
                 {
                     ++code;
                     Object *object = frame->pop().as_object();
@@ -2098,11 +2454,11 @@ namespace coldspot
                             CLASSNAME_NULLPOINTEREXCEPTION);
                         break;
                     }
-                    object->ensure_monitor()->enter();
-                    break;
+                    object->monitor_enter();
+                    NEXT
                 }
 
-                case MONITOREXIT:
+                CASE(MONITOREXIT)
                 {
                     ++code;
                     Object *object = frame->pop().as_object();
@@ -2112,52 +2468,49 @@ namespace coldspot
                             CLASSNAME_NULLPOINTEREXCEPTION);
                         break;
                     }
-                    object->ensure_monitor()->exit();
-                    break;
+                    error_t errorValue = object->monitor_exit();
+                    BREAK_ON_FAIL(errorValue);
+                    NEXT
                 }
 
-                case MULTIANEWARRAY:
+                CASE(MULTIANEWARRAY)
                 {
-                    uint8_t index1 = *(++code);
-                    uint8_t index2 = *(++code);
-                    uint8_t dimensions = *(++code);
-                    ++code;
+                    CacheEntry *entry = CACHE_ENTRY;
+                    uint8_t dimensions = *(code + 3);
+                    code += 4;
                     fixed_stack <jint> sizes;
                     sizes.init(dimensions);
+                    bool negativeSize = false;
                     for (uint8_t i = 0; i < dimensions; ++i)
                     {
                         jint size = frame->pop().as_int();
-                        if (size < 0)
-                        {
-                            THROW_WITH_RETURN_ON_UNWIND(
-                                CLASSNAME_NEGATIVEARRAYSIZEEXCEPTION);
-                            break;
-                        }
+                        negativeSize |= size < 0;
                         sizes.push(size);
                     }
-                    uint64_t classIndex = (index1 << 8) | index2;
-                    Class *clazz;
-                    error_t errorValue = frame->clazz->get_class_from_cp(
-                        classIndex, &clazz);
-                    BREAK_ON_FAIL(errorValue);
+                    if (negativeSize)
+                    {
+                        THROW_WITH_RETURN_ON_UNWIND(
+                            CLASSNAME_NEGATIVEARRAYSIZEEXCEPTION);
+                        break;
+                    }
+                    RESOLVE_ENTRY(entry, get_class_from_cp, clazz)
                     Array *array;
-                    errorValue = createMultiArray(clazz, sizes,
+                    error_t errorValue = createMultiArray(entry->clazz, sizes,
                         sizes.size() - 1, dimensions, &array);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(array);
+
+                    // No NEXT, computed gotos would skip the destructor of sizes
                     break;
                 }
 
-                case NEW:
+                CASE(NEW)
                 {
-                    uint16_t classIndex = (*(++code) << 8) | *(++code);
-                    ++code;
-
-                    Class *clazz;
-                    error_t errorValue = frame->clazz->get_class_from_cp(
-                        classIndex, &clazz);
-                    BREAK_ON_FAIL(errorValue);
+                    CacheEntry *entry = CACHE_ENTRY;
+                    RESOLVE_ENTRY(entry, get_class_from_cp, clazz)
+                    code += 3;
 
+                    Class *clazz = entry->clazz;
                     if (clazz->is_abstract())
                     {
                         THROW_WITH_RETURN_ON_UNWIND(
@@ -2165,23 +2518,22 @@ namespace coldspot
                         break;
                     }
 
-                    errorValue = _vm->class_loader()->initialize_class(clazz);
-                    BREAK_ON_FAIL(errorValue);
+                    INITIALIZE_CLASS(clazz)
 
                     Object *object;
-                    errorValue = _vm->memory_manager()->allocate_object(clazz,
+                    error_t errorValue = _vm->memory_manager()->allocate_object(clazz,
                         &object);
                     BREAK_ON_FAIL(errorValue);
 
                     frame->push(object);
-                    break;
+                    NEXT
                 }
 
-                case NEWARRAY:
+                CASE(NEWARRAY)
                 {
                     uint8_t type = *(++code);
                     ++code;
-                    Value countValue = frame->pop();
+                    Slot countValue = frame->pop();
                     jint count = countValue.as_int();
                     if (count < 0)
                     {
@@ -2226,44 +2578,37 @@ namespace coldspot
                         countValue.as_int(), &array);
                     BREAK_ON_FAIL(errorValue);
                     frame->push(array);
-                    break;
+                    NEXT
                 }
 
-                case NOP:
+                CASE(NOP)
                 {
                     ++code;
-                    break;
+                    NEXT
                 }
 
-                case POP:
+                CASE(POP)
                 {
                     ++code;
                     frame->pop();
-                    break;
+                    NEXT
                 }
 
-                case POP2:
+                CASE(POP2)
                 {
                     ++code;
-                    Value value = frame->pop();
-                    if (value.type() != Type::TYPE_LONG &&
-                        value.type() != Type::TYPE_DOUBLE)
-                    {
-                        frame->pop();
-                    }
-                    break;
+                    frame->pop();
+                    frame->pop();
+                    NEXT
                 }
 
-                case PUTFIELD:
+                CASE(PUTFIELD)
                 {
+                    CacheEntry *entry = CACHE_ENTRY;
+                    RESOLVE_ENTRY(entry, get_field_from_cp, field)
+                    code += 3;
 
-                    uint16_t fieldIndex = (*(++code) << 8) | *(++code);
-                    ++code;
-
-                    Field *field;
-                    error_t errorValue = frame->clazz->get_field_from_cp(
-                        fieldIndex, &field);
-                    BREAK_ON_FAIL(errorValue);
+                    Field *field = entry->field;
 
                     if (field->is_static())
                     {
@@ -2272,7 +2617,7 @@ namespace coldspot
                         break;
                     }
 
-                    Value value = frame->pop();
+                    Slot value = frame->pop();
                     Object *object = frame->pop().as_object();
                     if (object == 0)
                     {
@@ -2281,24 +2626,86 @@ namespace coldspot
                         break;
                     }
 
-                    field->set(object, value);
-                    break;
+                    field->set(object, to_value(value, field->type()->type));
+
+                    // Use the quick instruction on further executions
+                    entry->offset = field->offset();
+                    rewrite_instruction(code - 3,
+                        Translator::quick_field_instruction(
+                            PUTFIELD_BYTE_QUICK, field->type()->type));
+                    NEXT
                 }
 
-                case PUTSTATIC:
+                CASE(PUTFIELD_BYTE_QUICK)
                 {
+                    PUTFIELD_QUICK(jbyte, as_byte)
+                    NEXT
+                }
 
-                    uint64_t fieldIndex = (*(++code) << 8) | *(++code);
-                    ++code;
+                CASE(PUTFIELD_CHAR_QUICK)
+                {
+                    PUTFIELD_QUICK(jchar, as_char)
+                    NEXT
+                }
 
-                    Field *field;
-                    error_t errorValue = frame->clazz->get_field_from_cp(
-                        fieldIndex, &field);
-                    BREAK_ON_FAIL(errorValue);
+                CASE(PUTFIELD_SHORT_QUICK)
+                {
+                    PUTFIELD_QUICK(jshort, as_short)
+                    NEXT
+                }
 
-                    errorValue = _vm->class_loader()->initialize_class(
-                        field->declaring_class());
-                    BREAK_ON_FAIL(errorValue);
+                CASE(PUTFIELD_INT_QUICK)
+                {
+                    PUTFIELD_QUICK(jint, as_int)
+                    NEXT
+                }
+
+                CASE(PUTFIELD_FLOAT_QUICK)
+                {
+                    PUTFIELD_QUICK(jfloat, as_float)
+                    NEXT
+                }
+
+                CASE(PUTFIELD_LONG_QUICK)
+                {
+                    PUTFIELD_QUICK(jlong, as_long)
+                    NEXT
+                }
+
+                CASE(PUTFIELD_DOUBLE_QUICK)
+                {
+                    PUTFIELD_QUICK(jdouble, as_double)
+                    NEXT
+                }
+
+                CASE(PUTFIELD_REF_QUICK)
+                {
+                    jint offset = CACHE_ENTRY->offset;
+                    code += 3;
+                    Slot value = frame->pop();
+                    Object *object = frame->pop().as_object();
+                    if (object == 0)
+                    {
+                        THROW_WITH_RETURN_ON_UNWIND(
+                            CLASSNAME_NULLPOINTEREXCEPTION);
+                        break;
+                    }
+
+                    Object **field = (Object **) (object->memory() + offset);
+                    HeapSpace::pre_write_barrier(*field);
+                    *field = value.as_object();
+                    HeapSpace::write_barrier(object);
+                    NEXT
+                }
+
+                CASE(PUTSTATIC)
+                {
+                    CacheEntry *entry = CACHE_ENTRY;
+                    RESOLVE_ENTRY(entry, get_field_from_cp, field)
+
+                    Field *field = entry->field;
+                    INITIALIZE_CLASS(field->declaring_class())
+                    code += 3;
 
                     if (!field->is_static())
                     {
@@ -2307,29 +2714,97 @@ namespace coldspot
                         break;
                     }
 
-                    field->set_static(frame->pop());
-                    break;
+                    field->set_static(
+                        to_value(frame->pop(), field->type()->type));
+
+                    // Use the quick instruction on further executions,
+                    // once the initialization of the class is complete
+                    Class *declaringClass = field->declaring_class();
+                    if (declaringClass->is_initialized())
+                    {
+                        entry->address = declaringClass->static_memory +
+                                         field->offset();
+                        rewrite_instruction(code - 3,
+                            Translator::quick_field_instruction(
+                                PUTSTATIC_BYTE_QUICK, field->type()->type));
+                    }
+                    NEXT
+                }
+
+                CASE(PUTSTATIC_BYTE_QUICK)
+                {
+                    PUTSTATIC_QUICK(jbyte, as_byte)
+                    NEXT
+                }
+
+                CASE(PUTSTATIC_CHAR_QUICK)
+                {
+                    PUTSTATIC_QUICK(jchar, as_char)
+                    NEXT
+                }
+
+                CASE(PUTSTATIC_SHORT_QUICK)
+                {
+                    PUTSTATIC_QUICK(jshort, as_short)
+                    NEXT
+                }
+
+                CASE(PUTSTATIC_INT_QUICK)
+                {
+                    PUTSTATIC_QUICK(jint, as_int)
+                    NEXT
                 }
 
-                case RET:
+                CASE(PUTSTATIC_FLOAT_QUICK)
+                {
+                    PUTSTATIC_QUICK(jfloat, as_float)
+                    NEXT
+                }
+
+                CASE(PUTSTATIC_LONG_QUICK)
+                {
+                    PUTSTATIC_QUICK(jlong, as_long)
+                    NEXT
+                }
+
+                CASE(PUTSTATIC_DOUBLE_QUICK)
+                {
+                    PUTSTATIC_QUICK(jdouble, as_double)
+                    NEXT
+                }
+
+                CASE(PUTSTATIC_REF_QUICK)
+                {
+                    PUTSTATIC_QUICK(Object *, as_object)
+                    NEXT
+                }
+
+                CASE(RET)
                 {
                     uint32_t programCounter = frame->localVariables[*(++code)].as_return_addr();
                     code = &frame->method->code()[programCounter];
-                    break;
+                    NEXT
                 }
 
-                case RETURN:
+                CASE(RETURN)
                 {
                     if (frame->method->is_synchronized())
                     {
-                        frame->callee()->ensure_monitor()->exit();
+                        frame->callee()->monitor_exit();
                     }
 
-                    _frames.pop();
-                    return RETURN_OK;
+                    pop_frame();
+                    if (frame == initialFrame)
+                    {
+                        return RETURN_OK;
+                    }
+
+                    frame = (Frame *) _frames.peek();
+                    SAFEPOINT
+                    continue;
                 }
 
-                case SALOAD:
+                CASE(SALOAD)
                 {
                     ++code;
 
@@ -2348,83 +2823,64 @@ namespace coldspot
                     BREAK_ON_FAIL(errorValue);
 
                     frame->push(value.as_int());
-                    break;
+                    NEXT
                 }
 
-                case SASTORE:
+                CASE(SASTORE)
                 {
                     TASTORE // TODO truncate int
-                    break;
+                    NEXT
                 }
 
-                case SIPUSH:
+                CASE(SIPUSH)
                 {
-                    jshort value = (*(++code) << 8) | *(++code);
-                    ++code;
+                    jshort value = read_operand<int16_t>(code + 1);
+                    code += 3;
                     frame->push((jint) value);
-                    break;
+                    NEXT
                 }
 
-                case SWAP:
+                CASE(SWAP)
                 {
                     ++code;
-                    Value value1 = frame->pop();
-                    Value value2 = frame->pop();
+                    Slot value1 = frame->pop();
+                    Slot value2 = frame->pop();
                     frame->push(value1);
                     frame->push(value2);
-                    break;
+                    NEXT
                 }
 
-                case TABLESWITCH:
+                CASE(TABLESWITCH)
                 {
-                    uint32_t beginProgramCounter = CURRENT_PC(frame);
-                    ++code;
-
-                    uint32_t programCounter = CURRENT_PC(frame);
-                    programCounter = (programCounter + 3) & ~0x03;
-                    code = &frame->method->code()[programCounter];
-
-                    int32_t defaultValue =
-                        (*code << 24) | (*(++code) << 16) | (*(++code) << 8) |
-                        *(++code);
-
-                    int32_t lowValue = (*(++code) << 24) | (*(++code) << 16) |
-                                       (*(++code) << 8) | *(++code);
+                    // Operands are 4-byte aligned
+                    uint32_t padding = 3 - CURRENT_PC(frame) % 4;
+                    uint8_t *operands = code + 1 + padding;
 
-                    int32_t highValue = (*(++code) << 24) | (*(++code) << 16) |
-                                        (*(++code) << 8) | *(++code);
+                    int32_t offset = read_operand<int32_t>(operands);
+                    int32_t low = read_operand<int32_t>(operands + 4);
+                    int32_t high = read_operand<int32_t>(operands + 8);
 
                     jint index = frame->pop().as_int();
-
-                    if (index < lowValue || index > highValue)
-                    {
-                        programCounter = beginProgramCounter + defaultValue;
-                    }
-                    else
+                    if (index >= low && index <= high)
                     {
-                        ++code;
-                        int32_t offset = (index - lowValue) * 4;
-                        uint8_t jumpByte1 = *(code + offset);
-                        uint8_t jumpByte2 = *(code + offset + 1);
-                        uint8_t jumpByte3 = *(code + offset + 2);
-                        uint8_t jumpByte4 = *(code + offset + 3);
-                        int32_t jumpValue =
-                            (jumpByte1 << 24) | (jumpByte2 << 16) |
-                            (jumpByte3 << 8) | jumpByte4;
-                        programCounter = beginProgramCounter + jumpValue;
+                        offset = read_operand<int32_t>(
+                            operands + 12 + (index - low) * 4);
                     }
 
-                    code = &frame->method->code()[programCounter];
-
-                    break;
+                    code += offset;
+                    NEXT
                 }
 
-                case WIDE:
+                CASE(WIDE)
                 {
                     EXIT_FATAL("unimplemented instruction wide");
                 }
 
+                SUPERINSTRUCTIONS(SUPERINSTRUCTION_PAIR,
+                    SUPERINSTRUCTION_TRIPLE)
+
                 default:
+                HANDLER_LABEL(default)
                 {
                     EXIT_FATAL("unimplemented instruction");
                 }
@@ -2440,35 +2896,109 @@ namespace coldspot
     }
 
 
-    error_t Interpreter::fill_parameters(Frame *frame, Method *method,
-        Object **object, Value *parameters)
+    error_t Interpreter::resolve_constant(Frame *frame, CacheEntry *entry)
     {
-        size_t parameterSize = method->parameter_types().size();
-        while (parameterSize != 0)
-        {
-            parameters[--parameterSize] = frame->pop();
-        }
+        Class *clazz = frame->clazz;
+        uint16_t index = entry->index;
 
-        if (!method->isStatic())
+        switch (clazz->class_file->constantPool[index]->tag)
         {
-            Value objectValue = frame->pop();
-            if (objectValue.value() == 0)
+            case CP_INTEGER:
+            {
+                entry->value = clazz->get_integer_from_cp(index);
+                break;
+            }
+            case CP_FLOAT:
+            {
+                entry->value = clazz->get_float_from_cp(index);
+                break;
+            }
+            case CP_LONG:
             {
-                throw_exception(CLASSNAME_NULLPOINTEREXCEPTION);
-                return RETURN_EXCEPTION;
+                entry->value = clazz->get_long_from_cp(index);
+                break;
+            }
+            case CP_DOUBLE:
+            {
+                entry->value = clazz->get_double_from_cp(index);
+                break;
+            }
+            case CP_STRING:
+            {
+                Object *string;
+                error_t errorValue = clazz->get_string_from_cp(index, &string);
+                RETURN_ON_FAIL(errorValue);
+                entry->value = string;
+                break;
+            }
+            case CP_CLASS:
+            {
+                Class *constantClass;
+                error_t errorValue = clazz->get_class_from_cp(index,
+                    &constantClass);
+                RETURN_ON_FAIL(errorValue);
+                entry->value = constantClass->object;
+                break;
+            }
+            default:
+            {
+                EXIT_FATAL("unimplemented constant-pool-entry in ldc");
             }
-            *object = objectValue.as_object();
         }
-        else if (method->isNative())
+
+        entry->resolved = true;
+
+        return RETURN_OK;
+    }
+
+
+    error_t Interpreter::lookup_cached(CacheEntry *entry, bool interfaceCall,
+        Class **clazz, Method **method, Object *object)
+    {
+        InlineCache *cache = entry->inline_cache;
+        if (cache != 0 && object != 0)
         {
-            *object = method->declaring_class()->object;
+            Method *target = cache->lookup(object->type(),
+                _profile_inline_caches);
+            if (target != 0)
+            {
+                *clazz = target->declaring_class();
+                *method = target;
+                return RETURN_OK;
+            }
         }
-        else
+
+        error_t errorValue = interfaceCall ?
+            Method::lookupInterface(clazz, method, object) :
+            Method::lookupVirtual(clazz, method, object);
+        RETURN_ON_FAIL(errorValue);
+
+        if (cache != 0)
         {
-            *object = 0;
+            cache->update(object->type(), *method);
         }
 
         return RETURN_OK;
     }
 
+
+    error_t Interpreter::invoke_native(Method *method, Object *object,
+        Slot *arguments, Value *returnValue)
+    {
+        uint16_t first = method->isStatic() ? 0 : 1;
+
+#if defined(COLDSPOT_UNTAGGED_SLOTS)
+        // Native methods get tagged values, built from the declared types
+        auto &types = method->argument_types();
+        dynarray<Value> parameters(types.length() - first);
+        for (uint16_t i = first; i < types.length(); ++i)
+        {
+            parameters[i - first] = to_value(arguments[i], types[i]);
+        }
+        return method->invokeNative(object, parameters, returnValue);
+#else
+        return method->invokeNative(object, arguments + first, returnValue);
+#endif
+    }
+
 }
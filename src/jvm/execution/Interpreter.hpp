@@ -27,10 +27,15 @@
 #include <jvm/Value.hpp>
 
 #include "Executor.hpp"
+#include "NGramProfiler.hpp"
 
 namespace coldspot
 {
 
+    class CacheEntry;
+
+    class Class;
+
     class Frame;
 
     class Method;
@@ -39,14 +44,42 @@ namespace coldspot
     {
     public:
 
+        // Initializes the interpreter and selects the dispatch-technique.
+        Interpreter();
+
         error_t execute(Frame *initialFrame, Value *returnValue) override;
 
     private:
 
-        // Pops the parameters and the object (for non-static methods) from
-        // the stack and stores them.
-        inline error_t fill_parameters(Frame *frame, Method *method,
-            Object **object, Value *parameters);
+        // Dispatches with computed gotos instead of the switch.
+        bool _threaded;
+
+        // Counts the executed sequences of instructions (switch only).
+        bool _profile_ngrams;
+        NGramProfiler::Window _ngram_window;
+
+        // Counts the hits and misses of the inline caches.
+        bool _profile_inline_caches;
+
+        // Compiles hot methods and continues their frames in native code.
+        bool _compile;
+
+        // The interpreter loop, either with threaded or switch dispatch.
+        template<bool Threaded>
+        error_t execute_loop(Frame *initialFrame, Value *returnValue);
+
+        // Resolves the constant of a ldc-instruction into the cache-entry.
+        error_t resolve_constant(Frame *frame, CacheEntry *entry);
+
+        // Selects the target of a virtual or interface call through the
+        // inline-cache of the call-site and updates the cache on a miss.
+        inline error_t lookup_cached(CacheEntry *entry, bool interfaceCall,
+            Class **clazz, Method **method, Object *object);
+
+        // Invokes a native method with the arguments (and the object of
+        // non-static methods) on the operand-stack.
+        error_t invoke_native(Method *method, Object *object,
+            Slot *arguments, Value *returnValue);
     };
 
 }
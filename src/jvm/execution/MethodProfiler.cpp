@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    void MethodProfiler::print_statistics(ClassLoader *classLoader)
+    {
+        // Classes may be defined while the profile is printed on demand
+        classLoader->load_mutex().lock();
+
+        List<Method *> executed;
+        auto begin = classLoader->loaded_classes().begin();
+        auto end = classLoader->loaded_classes().end();
+        while (begin != end)
+        {
+            Class *clazz = begin->value;
+            for (uint16_t i = 0; i < clazz->declared_methods.length(); ++i)
+            {
+                Method *method = clazz->declared_methods[i];
+                if (method->invocation_count() != 0 ||
+                    method->backedge_count() != 0)
+                {
+                    executed.addBack(method);
+                }
+            }
+            ++begin;
+        }
+
+        classLoader->load_mutex().unlock();
+
+        uint32_t size = executed.size();
+        dynarray<Method *> methods(size);
+        dynarray<uint64_t> invocations(size);
+        dynarray<uint64_t> bytecode(size);
+
+        uint32_t index = 0;
+        for (Method *method : executed)
+        {
+            methods[index] = method;
+            invocations[index] = method->invocation_count();
+            bytecode[index++] = executed_bytecode(method);
+        }
+
+        print_top("invocations", &methods[0], &invocations[0], size);
+        print_top("bytecode", &methods[0], &bytecode[0], size);
+    }
+
+
+    uint64_t MethodProfiler::executed_bytecode(Method *method)
+    {
+        return method->invocation_count() * method->code_length() +
+               method->backedge_distance();
+    }
+
+
+    void MethodProfiler::print_top(const char *title, Method **methods,
+        const uint64_t *counts, uint32_t size)
+    {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            total += counts[i];
+        }
+        LOG_INFO("hot methods by " << title << ": " << total << " in " <<
+            size << " methods")
+
+        // Select the highest counts one after another
+        dynarray<bool> printed(size);
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            printed[i] = false;
+        }
+
+        for (uint32_t rank = 0; rank < PRINTED_METHODS; ++rank)
+        {
+            uint32_t best = size;
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                if (!printed[i] && (best == size || counts[i] > counts[best]))
+                {
+                    best = i;
+                }
+            }
+            if (best == size)
+            {
+                break;
+            }
+            printed[best] = true;
+
+            Method *method = methods[best];
+            LOG_INFO("  " << counts[best] << " " <<
+                method->declaring_class()->name.c_str() << "." <<
+                method->signature().name.c_str() <<
+                method->signature().descriptor.c_str() << " (invocations=" <<
+                method->invocation_count() << " backedges=" <<
+                method->backedge_count() << ")")
+        }
+    }
+
+}
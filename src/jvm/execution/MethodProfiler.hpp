@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_EXECUTION_METHODPROFILER_HPP_
+#define COLDSPOT_JVM_EXECUTION_METHODPROFILER_HPP_
+
+#include <cstdint>
+
+namespace coldspot
+{
+
+    class ClassLoader;
+    class Method;
+
+    // Reports the hottest methods by the counters of the interpreter.
+    // The executed bytecode of a method is estimated by its code-length
+    // per invocation and the distances of its backward branches.
+    class MethodProfiler
+    {
+    public:
+
+        // Prints the top methods by invocations and by executed bytecode.
+        static void print_statistics(ClassLoader *classLoader);
+
+    private:
+
+        static const uint32_t PRINTED_METHODS = 20;
+
+        static uint64_t executed_bytecode(Method *method);
+
+        static void print_top(const char *title, Method **methods,
+            const uint64_t *counts, uint32_t size);
+    };
+
+}
+
+#endif
@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    // Mnemonics of the bytecode-instructions.
+    static const char *const MNEMONICS[JSR_W + 1] = {
+        "nop", "aconst_null", "iconst_m1", "iconst_0", "iconst_1",
+        "iconst_2", "iconst_3", "iconst_4", "iconst_5", "lconst_0",
+        "lconst_1", "fconst_0", "fconst_1", "fconst_2", "dconst_0",
+        "dconst_1", "bipush", "sipush", "ldc", "ldc_w", "ldc2_w", "iload",
+        "lload", "fload", "dload", "aload", "iload_0", "iload_1", "iload_2",
+        "iload_3", "lload_0", "lload_1", "lload_2", "lload_3", "fload_0",
+        "fload_1", "fload_2", "fload_3", "dload_0", "dload_1", "dload_2",
+        "dload_3", "aload_0", "aload_1", "aload_2", "aload_3", "iaload",
+        "laload", "faload", "daload", "aaload", "baload", "caload", "saload",
+        "istore", "lstore", "fstore", "dstore", "astore", "istore_0",
+        "istore_1", "istore_2", "istore_3", "lstore_0", "lstore_1",
+        "lstore_2", "lstore_3", "fstore_0", "fstore_1", "fstore_2",
+        "fstore_3", "dstore_0", "dstore_1", "dstore_2", "dstore_3",
+        "astore_0", "astore_1", "astore_2", "astore_3", "iastore", "lastore",
+        "fastore", "dastore", "aastore", "bastore", "castore", "sastore",
+        "pop", "pop2", "dup", "dup_x1", "dup_x2", "dup2", "dup2_x1",
+        "dup2_x2", "swap", "iadd", "ladd", "fadd", "dadd", "isub", "lsub",
+        "fsub", "dsub", "imul", "lmul", "fmul", "dmul", "idiv", "ldiv",
+        "fdiv", "ddiv", "irem", "lrem", "frem", "drem", "ineg", "lneg",
+        "fneg", "dneg", "ishl", "lshl", "ishr", "lshr", "iushr", "lushr",
+        "iand", "land", "ior", "lor", "ixor", "lxor", "iinc", "i2l", "i2f",
+        "i2d", "l2i", "l2f", "l2d", "f2i", "f2l", "f2d", "d2i", "d2l", "d2f",
+        "i2b", "i2c", "i2s", "lcmp", "fcmpl", "fcmpg", "dcmpl", "dcmpg",
+        "ifeq", "ifne", "iflt", "ifge", "ifgt", "ifle", "if_icmpeq",
+        "if_icmpne", "if_icmplt", "if_icmpge", "if_icmpgt", "if_icmple",
+        "if_acmpeq", "if_acmpne", "goto", "jsr", "ret", "tableswitch",
+        "lookupswitch", "ireturn", "lreturn", "freturn", "dreturn",
+        "areturn", "return", "getstatic", "putstatic", "getfield",
+        "putfield", "invokevirtual", "invokespecial", "invokestatic",
+        "invokeinterface", "invokedynamic", "new", "newarray", "anewarray",
+        "arraylength", "athrow", "checkcast", "instanceof", "monitorenter",
+        "monitorexit", "wide", "multianewarray", "ifnull", "ifnonnull",
+        "goto_w", "jsr_w"
+    };
+
+
+    std::atomic<uint64_t> NGramProfiler::_pairs[256 * 256];
+    std::atomic<uint32_t> NGramProfiler::_triple_keys[TRIPLE_SLOTS];
+    std::atomic<uint64_t> NGramProfiler::_triple_counts[TRIPLE_SLOTS];
+
+
+    void NGramProfiler::record(Window *window, Frame *frame)
+    {
+        const uint8_t *bytecode = frame->method->bytecode();
+        uint32_t pc = CURRENT_PC(frame);
+        uint8_t instruction = bytecode[pc];
+
+        // Start over after branches, invokes and returns
+        if (window->frame != frame || window->next_pc != pc)
+        {
+            window->size = 0;
+        }
+
+        if (window->size >= 1)
+        {
+            increment(_pairs[(window->instructions[1] << 8) | instruction]);
+        }
+        if (window->size >= 2)
+        {
+            count_triple((window->instructions[0] << 16) |
+                (window->instructions[1] << 8) | instruction);
+        }
+
+        window->instructions[0] = window->instructions[1];
+        window->instructions[1] = instruction;
+        if (window->size < 2)
+        {
+            ++window->size;
+        }
+        window->frame = frame;
+        window->next_pc = pc + Translator::instruction_length(bytecode, pc);
+    }
+
+
+    void NGramProfiler::count_triple(uint32_t key)
+    {
+        uint32_t slot = (key * 2654435761u) >> 16;
+        for (uint32_t i = 0; i < TRIPLE_SLOTS; ++i)
+        {
+            auto &slotKey = _triple_keys[(slot + i) & (TRIPLE_SLOTS - 1)];
+            uint32_t current = slotKey.load(std::memory_order_relaxed);
+            if (current == 0 && slotKey.compare_exchange_strong(current,
+                key + 1, std::memory_order_relaxed))
+            {
+                current = key + 1;
+            }
+            if (current == key + 1)
+            {
+                increment(_triple_counts[(slot + i) & (TRIPLE_SLOTS - 1)]);
+                return;
+            }
+        }
+    }
+
+
+    void NGramProfiler::print_statistics()
+    {
+        dynarray<uint32_t> keys(TRIPLE_SLOTS);
+        dynarray<uint64_t> counts(TRIPLE_SLOTS);
+
+        uint32_t size = 0;
+        for (uint32_t i = 0; i < 256 * 256; ++i)
+        {
+            uint64_t count = _pairs[i].load(std::memory_order_relaxed);
+            if (count != 0)
+            {
+                keys[size] = i;
+                counts[size++] = count;
+            }
+        }
+        print_top("pairs", 2, &keys[0], &counts[0], size);
+
+        size = 0;
+        for (uint32_t i = 0; i < TRIPLE_SLOTS; ++i)
+        {
+            uint32_t key = _triple_keys[i].load(std::memory_order_relaxed);
+            if (key != 0)
+            {
+                keys[size] = key - 1;
+                counts[size++] =
+                    _triple_counts[i].load(std::memory_order_relaxed);
+            }
+        }
+        print_top("triples", 3, &keys[0], &counts[0], size);
+    }
+
+
+    void NGramProfiler::print_top(const char *title, uint32_t length,
+        const uint32_t *keys, const uint64_t *counts, uint32_t size)
+    {
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            total += counts[i];
+        }
+        LOG_INFO("bytecode " << title << ": " << total << " executed, " <<
+            size << " distinct")
+
+        // Select the highest counts one after another
+        dynarray<bool> printed(size);
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            printed[i] = false;
+        }
+
+        for (uint32_t rank = 0; rank < PRINTED_SEQUENCES; ++rank)
+        {
+            uint32_t best = size;
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                if (!printed[i] && (best == size || counts[i] > counts[best]))
+                {
+                    best = i;
+                }
+            }
+            if (best == size)
+            {
+                break;
+            }
+            printed[best] = true;
+
+            StringBuilder builder;
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                uint8_t instruction =
+                    (uint8_t) (keys[best] >> ((length - 1 - i) * 8));
+                if (i != 0)
+                {
+                    builder << " ";
+                }
+                if (instruction <= JSR_W)
+                {
+                    builder << MNEMONICS[instruction];
+                }
+                else
+                {
+                    builder << (int) instruction;
+                }
+            }
+
+            LOG_INFO("  " << counts[best] << " " << builder.str().c_str())
+        }
+    }
+
+}
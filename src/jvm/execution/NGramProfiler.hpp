@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_EXECUTION_NGRAMPROFILER_HPP_
+#define COLDSPOT_JVM_EXECUTION_NGRAMPROFILER_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+namespace coldspot
+{
+
+    class Frame;
+
+    // Counts the pairs and triples of instructions, that are executed one
+    // after another, to select the superinstructions from a workload.
+    // Sequences with a branch between their instructions are not counted,
+    // because they can not be replaced by a superinstruction. Counters are
+    // updated without read-modify-write, so concurrent updates may get lost.
+    class NGramProfiler
+    {
+    public:
+
+        // The recently executed instructions of a thread.
+        class Window
+        {
+        public:
+
+            Frame *frame;
+            uint32_t next_pc;
+            uint8_t size;
+            uint8_t instructions[2];
+
+            Window() : frame(0), next_pc(0), size(0) { }
+        };
+
+        // Records the instruction at the current program-counter.
+        static void record(Window *window, Frame *frame);
+
+        // Prints the most frequent pairs and triples.
+        static void print_statistics();
+
+    private:
+
+        static const uint32_t TRIPLE_SLOTS = 1 << 16;
+        static const uint32_t PRINTED_SEQUENCES = 32;
+
+        static std::atomic<uint64_t> _pairs[256 * 256];
+
+        // Open addressing by the instructions, keys are stored incremented,
+        // so that 0 marks a free slot
+        static std::atomic<uint32_t> _triple_keys[TRIPLE_SLOTS];
+        static std::atomic<uint64_t> _triple_counts[TRIPLE_SLOTS];
+
+        static void increment(std::atomic<uint64_t> &counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        }
+
+        static void count_triple(uint32_t key);
+
+        // Prints the sequences with the highest counts.
+        static void print_top(const char *title, uint32_t length,
+            const uint32_t *keys, const uint64_t *counts, uint32_t size);
+    };
+
+}
+
+#endif
@@ -0,0 +1,1375 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    // Kinds of local-variables and operands
+    static const uint8_t KIND_UNKNOWN = 0;
+    static const uint8_t KIND_INT = 1;
+    static const uint8_t KIND_WIDE = 2;
+    static const uint8_t KIND_REFERENCE = 3;
+    static const uint8_t KIND_VOID = 4;
+    static const uint8_t KIND_MASK = 0x07;
+
+    // Marks local-variables stored since the entry of a subroutine
+    static const uint8_t KIND_STORED = 0x80;
+
+    // Index of program-counters inside of instructions and
+    // subroutine of ret-instructions, that are not known
+    static const uint32_t NO_INSTRUCTION = 0xFFFFFFFF;
+
+
+    // Returns the kind of the type at the begin of a descriptor.
+    static uint8_t descriptor_kind(char type)
+    {
+        switch (type)
+        {
+            case 'J':
+            case 'D':
+                return KIND_WIDE;
+            case 'L':
+            case '[':
+                return KIND_REFERENCE;
+            case 'V':
+                return KIND_VOID;
+            default:
+                return KIND_INT;
+        }
+    }
+
+
+    StackAnalyzer::StackAnalyzer(Method *method, uint8_t *code)
+        : _method(method), _bytecode(method->bytecode()), _code(code),
+          _length(method->code_length()),
+          _locals_count(method->locals_count()),
+          _operands_count(method->operands_count()),
+          _width(method->locals_count() + method->operands_count()),
+          _instructions(0), _stack_size(0), _failed(false)
+    {
+    }
+
+
+    error_t StackAnalyzer::analyze()
+    {
+        error_t errorValue = find_instructions();
+        RETURN_ON_FAIL(errorValue);
+
+        find_subroutines();
+
+        _kinds.init(_instructions * _width);
+        _stack_sizes.init(_instructions);
+        _queued.init(_instructions);
+        _worklist.init(_instructions);
+        _current.init(_width);
+        for (uint32_t i = 0; i < _instructions; ++i)
+        {
+            _stack_sizes[i] = -1;
+        }
+
+        // The arguments are the first local-variables,
+        // long and double need two of them
+        auto &argumentTypes = _method->argument_types();
+        uint32_t local = 0;
+        for (uint16_t i = 0; i < argumentTypes.length(); ++i)
+        {
+            Type type = argumentTypes[i];
+            if (type == TYPE_LONG || type == TYPE_DOUBLE)
+            {
+                store(local, KIND_WIDE);
+                local += 2;
+            }
+            else
+            {
+                store(local++, type == TYPE_REFERENCE ? KIND_REFERENCE
+                                                      : KIND_INT);
+            }
+        }
+
+        merge(0, &_current[0], 0);
+
+        // Process the instructions until their states are stable
+        while (!_failed && !_worklist.empty())
+        {
+            uint32_t index = _worklist.pop();
+            _queued[index] = false;
+            process(index);
+        }
+
+        if (_failed)
+        {
+            return RETURN_ERROR;
+        }
+
+        return RETURN_OK;
+    }
+
+
+    int32_t StackAnalyzer::stack_size(uint32_t pc)
+    {
+        if (pc >= _length || _indices[pc] == NO_INSTRUCTION)
+        {
+            return -1;
+        }
+        return _stack_sizes[_indices[pc]];
+    }
+
+
+    error_t StackAnalyzer::find_instructions()
+    {
+        _indices.init(_length);
+        for (uint32_t pc = 0; pc < _length; ++pc)
+        {
+            _indices[pc] = NO_INSTRUCTION;
+        }
+
+        uint32_t jsrCount = 0;
+        uint32_t retCount = 0;
+        uint32_t pc = 0;
+        while (pc < _length)
+        {
+            if (_bytecode[pc] == JSR || _bytecode[pc] == JSR_W)
+            {
+                ++jsrCount;
+            }
+            else if (is_ret(pc))
+            {
+                ++retCount;
+            }
+
+            _indices[pc] = _instructions++;
+            pc += Translator::instruction_length(_bytecode, pc);
+        }
+
+        // The last instruction must end with the code
+        if (pc != _length)
+        {
+            return RETURN_ERROR;
+        }
+
+        _pcs.init(_instructions);
+        _jsrs.init(jsrCount);
+        _rets.init(retCount);
+        for (pc = 0; pc < _length;
+             pc += Translator::instruction_length(_bytecode, pc))
+        {
+            _pcs[_indices[pc]] = pc;
+
+            if (_bytecode[pc] == JSR || _bytecode[pc] == JSR_W)
+            {
+                _jsrs.push(pc);
+            }
+            else if (is_ret(pc))
+            {
+                _rets.push(pc);
+            }
+        }
+
+        return RETURN_OK;
+    }
+
+
+    void StackAnalyzer::find_subroutines()
+    {
+        _subroutines.init(_instructions);
+        for (uint32_t i = 0; i < _instructions; ++i)
+        {
+            _subroutines[i] = NO_INSTRUCTION;
+        }
+
+        // Last subroutine, that reached each instruction
+        SmartArray<uint32_t, uint32_t> visits;
+        visits.init(_instructions);
+
+        fixed_stack<uint32_t> pending;
+        pending.init(_instructions);
+
+        // The ret-instructions reachable from the entry of a subroutine
+        // belong to it, nested subroutines are skipped
+        for (uint32_t i = 0; i < _jsrs.size(); ++i)
+        {
+            uint32_t subroutine = jsr_target(_jsrs.get(i));
+            if (subroutine >= _length ||
+                _indices[subroutine] == NO_INSTRUCTION ||
+                visits[_indices[subroutine]] == subroutine + 1)
+            {
+                continue;
+            }
+
+            auto visit = [&](uint32_t pc)
+            {
+                if (pc < _length && _indices[pc] != NO_INSTRUCTION &&
+                    visits[_indices[pc]] != subroutine + 1)
+                {
+                    visits[_indices[pc]] = subroutine + 1;
+                    pending.push(_indices[pc]);
+                }
+            };
+
+            visit(subroutine);
+            while (!pending.empty())
+            {
+                uint32_t index = pending.pop();
+                uint32_t pc = _pcs[index];
+
+                if (is_ret(pc))
+                {
+                    // Rets shared by several subroutines get an invalid one
+                    _subroutines[index] =
+                        _subroutines[index] == NO_INSTRUCTION ? subroutine
+                                                              : _length;
+                }
+                else if (for_each_target(pc, visit))
+                {
+                    visit(pc + Translator::instruction_length(_bytecode, pc));
+                }
+            }
+        }
+    }
+
+
+    void StackAnalyzer::process(uint32_t index)
+    {
+        uint32_t pc = _pcs[index];
+        memcpy(&_current[0], &_kinds[index * _width], _width);
+        _stack_size = (uint32_t) _stack_sizes[index];
+
+        merge_handlers(pc);
+        execute(pc);
+        if (_failed)
+        {
+            return;
+        }
+
+        if (_bytecode[pc] == JSR || _bytecode[pc] == JSR_W)
+        {
+            merge_jsr(pc);
+        }
+        else if (is_ret(pc))
+        {
+            merge_ret(pc);
+        }
+        else if (for_each_target(pc, [this](uint32_t target)
+            {
+                merge(target, &_current[0], _stack_size);
+            }))
+        {
+            merge(pc + Translator::instruction_length(_bytecode, pc),
+                &_current[0], _stack_size);
+        }
+    }
+
+
+    void StackAnalyzer::merge(uint32_t pc, const uint8_t *kinds,
+        uint32_t stackSize)
+    {
+        if (pc >= _length || _indices[pc] == NO_INSTRUCTION)
+        {
+            _failed = true;
+            return;
+        }
+
+        uint32_t index = _indices[pc];
+        uint8_t *state = &_kinds[index * _width];
+        bool changed = false;
+
+        if (_stack_sizes[index] < 0)
+        {
+            memcpy(state, kinds, _locals_count + stackSize);
+            _stack_sizes[index] = stackSize;
+            changed = true;
+        }
+        else if ((uint32_t) _stack_sizes[index] != stackSize)
+        {
+            _failed = true;
+            return;
+        }
+        else
+        {
+            // Different kinds are unknown afterwards
+            for (uint32_t i = 0; i < _locals_count + stackSize; ++i)
+            {
+                uint8_t kind = state[i] & KIND_MASK;
+                if (kind != (kinds[i] & KIND_MASK))
+                {
+                    kind = KIND_UNKNOWN;
+                }
+
+                uint8_t merged = kind | ((state[i] | kinds[i]) & KIND_STORED);
+                if (merged != state[i])
+                {
+                    state[i] = merged;
+                    changed = true;
+                }
+            }
+        }
+
+        if (changed && !_queued[index])
+        {
+            _queued[index] = true;
+            _worklist.push(index);
+        }
+    }
+
+
+    void StackAnalyzer::merge_handlers(uint32_t pc)
+    {
+        for (auto handler : _method->exception_handlers())
+        {
+            if (pc < handler->startPc || pc >= handler->endPc)
+            {
+                continue;
+            }
+
+            if (_operands_count == 0)
+            {
+                _failed = true;
+                return;
+            }
+
+            // The handler starts with the exception as only operand
+            uint8_t operand = _current[_locals_count];
+            _current[_locals_count] = KIND_REFERENCE;
+            merge(handler->handlerPc, &_current[0], 1);
+            _current[_locals_count] = operand;
+        }
+    }
+
+
+    void StackAnalyzer::merge_jsr(uint32_t pc)
+    {
+        // Stores are tracked from the entry of the subroutine
+        uint32_t subroutine = jsr_target(pc);
+        for (uint32_t i = 0; i < _locals_count; ++i)
+        {
+            _current[i] &= ~KIND_STORED;
+        }
+        merge(subroutine, &_current[0], _stack_size);
+
+        // The returns of the subroutine continue after this jsr
+        for (uint32_t i = 0; i < _rets.size(); ++i)
+        {
+            uint32_t index = _indices[_rets.get(i)];
+            if (_stack_sizes[index] >= 0 && !_queued[index] &&
+                (_subroutines[index] == subroutine ||
+                 _subroutines[index] >= _length))
+            {
+                _queued[index] = true;
+                _worklist.push(index);
+            }
+        }
+    }
+
+
+    void StackAnalyzer::merge_ret(uint32_t pc)
+    {
+        uint32_t subroutine = _subroutines[_indices[pc]];
+        dynarray<uint8_t> state(_width);
+        memcpy(state, &_current[0], _width);
+
+        for (uint32_t i = 0; i < _jsrs.size(); ++i)
+        {
+            uint32_t jsr = _jsrs.get(i);
+            uint32_t index = _indices[jsr];
+            if (_stack_sizes[index] < 0 ||
+                (subroutine < _length && jsr_target(jsr) != subroutine))
+            {
+                continue;
+            }
+
+            // Local-variables not stored by the subroutine
+            // keep their kinds from the jsr
+            const uint8_t *caller = &_kinds[index * _width];
+            for (uint32_t j = 0; j < _locals_count; ++j)
+            {
+                state[j] = (_current[j] & KIND_STORED) ? _current[j]
+                                                       : caller[j];
+            }
+
+            merge(jsr + Translator::instruction_length(_bytecode, jsr),
+                state, _stack_size);
+        }
+    }
+
+
+    template<typename F>
+    bool StackAnalyzer::for_each_target(uint32_t pc, F function)
+    {
+        const uint8_t *operands = &_bytecode[pc + 1];
+
+        switch (_bytecode[pc])
+        {
+            case IFEQ:
+            case IFNE:
+            case IFLT:
+            case IFGE:
+            case IFGT:
+            case IFLE:
+            case IF_ICMPEQ:
+            case IF_ICMPNE:
+            case IF_ICMPLT:
+            case IF_ICMPGE:
+            case IF_ICMPGT:
+            case IF_ICMPLE:
+            case IF_ACMPEQ:
+            case IF_ACMPNE:
+            case IFNULL:
+            case IFNONNULL:
+            {
+                function(pc + (int16_t) read_bytecode_u16(operands));
+                return true;
+            }
+
+            case GOTO:
+            {
+                function(pc + (int16_t) read_bytecode_u16(operands));
+                return false;
+            }
+
+            case GOTO_W:
+            {
+                function(pc + read_bytecode_s32(operands));
+                return false;
+            }
+
+            case TABLESWITCH:
+            {
+                const uint8_t *aligned = &_bytecode[(pc + 4) & ~0x03];
+                int32_t low = read_bytecode_s32(aligned + 4);
+                int32_t high = read_bytecode_s32(aligned + 8);
+                function(pc + read_bytecode_s32(aligned));
+                for (int32_t i = 0; i < high - low + 1; ++i)
+                {
+                    function(pc + read_bytecode_s32(aligned + 12 + i * 4));
+                }
+                return false;
+            }
+
+            case LOOKUPSWITCH:
+            {
+                const uint8_t *aligned = &_bytecode[(pc + 4) & ~0x03];
+                int32_t pairs = read_bytecode_s32(aligned + 4);
+                function(pc + read_bytecode_s32(aligned));
+                for (int32_t i = 0; i < pairs; ++i)
+                {
+                    function(pc + read_bytecode_s32(aligned + 12 + i * 8));
+                }
+                return false;
+            }
+
+            case IRETURN:
+            case LRETURN:
+            case FRETURN:
+            case DRETURN:
+            case ARETURN:
+            case RETURN:
+            case ATHROW:
+            case RET:
+            {
+                return false;
+            }
+
+            case WIDE:
+            {
+                return operands[0] != RET;
+            }
+
+            default:
+            {
+                // Subroutines return to the next instruction of the jsr
+                return true;
+            }
+        }
+    }
+
+
+    uint32_t StackAnalyzer::jsr_target(uint32_t pc)
+    {
+        const uint8_t *operands = &_bytecode[pc + 1];
+        if (_bytecode[pc] == JSR_W)
+        {
+            return pc + read_bytecode_s32(operands);
+        }
+        return pc + (int16_t) read_bytecode_u16(operands);
+    }
+
+
+    bool StackAnalyzer::is_ret(uint32_t pc)
+    {
+        return _bytecode[pc] == RET ||
+               (_bytecode[pc] == WIDE && _bytecode[pc + 1] == RET);
+    }
+
+
+    void StackAnalyzer::execute(uint32_t pc)
+    {
+        const uint8_t *operands = &_bytecode[pc + 1];
+        uint8_t instruction = _bytecode[pc];
+
+        switch (instruction)
+        {
+            case NOP:
+            case GOTO:
+            case GOTO_W:
+            case RETURN:
+            {
+                break;
+            }
+
+            case ACONST_NULL:
+            case NEW:
+            {
+                push(KIND_REFERENCE);
+                break;
+            }
+
+            case ICONST_M1:
+            case ICONST_0:
+            case ICONST_1:
+            case ICONST_2:
+            case ICONST_3:
+            case ICONST_4:
+            case ICONST_5:
+            case FCONST_0:
+            case FCONST_1:
+            case FCONST_2:
+            case BIPUSH:
+            case SIPUSH:
+            {
+                push(KIND_INT);
+                break;
+            }
+
+            case LCONST_0:
+            case LCONST_1:
+            case DCONST_0:
+            case DCONST_1:
+            {
+                push(KIND_WIDE);
+                break;
+            }
+
+            case LDC:
+            case LDC_W:
+            case LDC2_W:
+            {
+                uint16_t index = instruction == LDC ? operands[0]
+                                                    : read_bytecode_u16(
+                                                        operands);
+                uint8_t kind = constant_kind(index);
+                if (kind == KIND_VOID ||
+                    (kind == KIND_WIDE) != (instruction == LDC2_W))
+                {
+                    _failed = true;
+                    break;
+                }
+                push(kind);
+                break;
+            }
+
+            case ILOAD:
+            case FLOAD:
+            {
+                load(operands[0], KIND_INT);
+                break;
+            }
+
+            case LLOAD:
+            case DLOAD:
+            {
+                load(operands[0], KIND_WIDE);
+                break;
+            }
+
+            case ALOAD:
+            {
+                load(operands[0], KIND_REFERENCE);
+                break;
+            }
+
+            case ILOAD_0:
+            case ILOAD_1:
+            case ILOAD_2:
+            case ILOAD_3:
+            {
+                load(instruction - ILOAD_0, KIND_INT);
+                break;
+            }
+
+            case FLOAD_0:
+            case FLOAD_1:
+            case FLOAD_2:
+            case FLOAD_3:
+            {
+                load(instruction - FLOAD_0, KIND_INT);
+                break;
+            }
+
+            case LLOAD_0:
+            case LLOAD_1:
+            case LLOAD_2:
+            case LLOAD_3:
+            {
+                load(instruction - LLOAD_0, KIND_WIDE);
+                break;
+            }
+
+            case DLOAD_0:
+            case DLOAD_1:
+            case DLOAD_2:
+            case DLOAD_3:
+            {
+                load(instruction - DLOAD_0, KIND_WIDE);
+                break;
+            }
+
+            case ALOAD_0:
+            case ALOAD_1:
+            case ALOAD_2:
+            case ALOAD_3:
+            {
+                load(instruction - ALOAD_0, KIND_REFERENCE);
+                break;
+            }
+
+            case IALOAD:
+            case FALOAD:
+            case BALOAD:
+            case CALOAD:
+            case SALOAD:
+            {
+                pop(2);
+                push(KIND_INT);
+                break;
+            }
+
+            case LALOAD:
+            case DALOAD:
+            {
+                pop(2);
+                push(KIND_WIDE);
+                break;
+            }
+
+            case AALOAD:
+            {
+                pop(2);
+                push(KIND_REFERENCE);
+                break;
+            }
+
+            case ISTORE:
+            case FSTORE:
+            case ASTORE:
+            {
+                store(operands[0], pop());
+                break;
+            }
+
+            case LSTORE:
+            case DSTORE:
+            {
+                pop();
+                store(operands[0], KIND_WIDE);
+                break;
+            }
+
+            case ISTORE_0:
+            case ISTORE_1:
+            case ISTORE_2:
+            case ISTORE_3:
+            {
+                pop();
+                store(instruction - ISTORE_0, KIND_INT);
+                break;
+            }
+
+            case FSTORE_0:
+            case FSTORE_1:
+            case FSTORE_2:
+            case FSTORE_3:
+            {
+                pop();
+                store(instruction - FSTORE_0, KIND_INT);
+                break;
+            }
+
+            case LSTORE_0:
+            case LSTORE_1:
+            case LSTORE_2:
+            case LSTORE_3:
+            {
+                pop();
+                store(instruction - LSTORE_0, KIND_WIDE);
+                break;
+            }
+
+            case DSTORE_0:
+            case DSTORE_1:
+            case DSTORE_2:
+            case DSTORE_3:
+            {
+                pop();
+                store(instruction - DSTORE_0, KIND_WIDE);
+                break;
+            }
+
+            case ASTORE_0:
+            case ASTORE_1:
+            case ASTORE_2:
+            case ASTORE_3:
+            {
+                // Also stores return-addresses of subroutines
+                store(instruction - ASTORE_0, pop());
+                break;
+            }
+
+            case IASTORE:
+            case LASTORE:
+            case FASTORE:
+            case DASTORE:
+            case AASTORE:
+            case BASTORE:
+            case CASTORE:
+            case SASTORE:
+            {
+                pop(3);
+                break;
+            }
+
+            case POP:
+            case MONITORENTER:
+            case MONITOREXIT:
+            case IFEQ:
+            case IFNE:
+            case IFLT:
+            case IFGE:
+            case IFGT:
+            case IFLE:
+            case IFNULL:
+            case IFNONNULL:
+            case TABLESWITCH:
+            case LOOKUPSWITCH:
+            case IRETURN:
+            case LRETURN:
+            case FRETURN:
+            case DRETURN:
+            case ARETURN:
+            case ATHROW:
+            {
+                pop();
+                break;
+            }
+
+            case IF_ICMPEQ:
+            case IF_ICMPNE:
+            case IF_ICMPLT:
+            case IF_ICMPGE:
+            case IF_ICMPGT:
+            case IF_ICMPLE:
+            case IF_ACMPEQ:
+            case IF_ACMPNE:
+            {
+                pop(2);
+                break;
+            }
+
+            // Long and double are single operands, so the instructions
+            // on them are rewritten into the ones moving single operands
+            case POP2:
+            {
+                if (pop() == KIND_WIDE)
+                {
+                    _code[pc] = POP;
+                }
+                else
+                {
+                    pop();
+                    _code[pc] = POP2;
+                }
+                break;
+            }
+
+            case DUP:
+            {
+                uint8_t top1 = pop();
+                push(top1);
+                push(top1);
+                break;
+            }
+
+            case DUP_X1:
+            {
+                uint8_t top1 = pop();
+                uint8_t top2 = pop();
+                push(top1);
+                push(top2);
+                push(top1);
+                break;
+            }
+
+            case DUP_X2:
+            {
+                uint8_t top1 = pop();
+                uint8_t top2 = pop();
+                if (top2 == KIND_WIDE)
+                {
+                    _code[pc] = DUP_X1;
+                    push(top1);
+                    push(top2);
+                    push(top1);
+                }
+                else
+                {
+                    uint8_t top3 = pop();
+                    _code[pc] = DUP_X2;
+                    push(top1);
+                    push(top3);
+                    push(top2);
+                    push(top1);
+                }
+                break;
+            }
+
+            case DUP2:
+            {
+                uint8_t top1 = pop();
+                if (top1 == KIND_WIDE)
+                {
+                    _code[pc] = DUP;
+                    push(top1);
+                    push(top1);
+                }
+                else
+                {
+                    uint8_t top2 = pop();
+                    _code[pc] = DUP2;
+                    push(top2);
+                    push(top1);
+                    push(top2);
+                    push(top1);
+                }
+                break;
+            }
+
+            case DUP2_X1:
+            {
+                uint8_t top1 = pop();
+                uint8_t top2 = pop();
+                if (top1 == KIND_WIDE)
+                {
+                    _code[pc] = DUP_X1;
+                    push(top1);
+                    push(top2);
+                    push(top1);
+                }
+                else
+                {
+                    uint8_t top3 = pop();
+                    _code[pc] = DUP2_X1;
+                    push(top2);
+                    push(top1);
+                    push(top3);
+                    push(top2);
+                    push(top1);
+                }
+                break;
+            }
+
+            case DUP2_X2:
+            {
+                uint8_t top1 = pop();
+                uint8_t top2 = pop();
+                if (top1 == KIND_WIDE && top2 == KIND_WIDE)
+                {
+                    _code[pc] = DUP_X1;
+                    push(top1);
+                    push(top2);
+                    push(top1);
+                }
+                else if (top1 == KIND_WIDE)
+                {
+                    uint8_t top3 = pop();
+                    _code[pc] = DUP_X2;
+                    push(top1);
+                    push(top3);
+                    push(top2);
+                    push(top1);
+                }
+                else
+                {
+                    uint8_t top3 = pop();
+                    if (top3 == KIND_WIDE)
+                    {
+                        _code[pc] = DUP2_X1;
+                        push(top2);
+                        push(top1);
+                        push(top3);
+                        push(top2);
+                        push(top1);
+                    }
+                    else
+                    {
+                        uint8_t top4 = pop();
+                        _code[pc] = DUP2_X2;
+                        push(top2);
+                        push(top1);
+                        push(top4);
+                        push(top3);
+                        push(top2);
+                        push(top1);
+                    }
+                }
+                break;
+            }
+
+            case SWAP:
+            {
+                uint8_t top1 = pop();
+                uint8_t top2 = pop();
+                push(top1);
+                push(top2);
+                break;
+            }
+
+            case IADD:
+            case FADD:
+            case ISUB:
+            case FSUB:
+            case IMUL:
+            case FMUL:
+            case IDIV:
+            case FDIV:
+            case IREM:
+            case FREM:
+            case ISHL:
+            case ISHR:
+            case IUSHR:
+            case IAND:
+            case IOR:
+            case IXOR:
+            case LCMP:
+            case FCMPL:
+            case FCMPG:
+            case DCMPL:
+            case DCMPG:
+            {
+                pop(2);
+                push(KIND_INT);
+                break;
+            }
+
+            case LADD:
+            case DADD:
+            case LSUB:
+            case DSUB:
+            case LMUL:
+            case DMUL:
+            case LDIV:
+            case DDIV:
+            case LREM:
+            case DREM:
+            case LSHL:
+            case LSHR:
+            case LUSHR:
+            case LAND:
+            case LOR:
+            case LXOR:
+            {
+                pop(2);
+                push(KIND_WIDE);
+                break;
+            }
+
+            case INEG:
+            case FNEG:
+            case L2I:
+            case L2F:
+            case F2I:
+            case D2I:
+            case D2F:
+            case I2F:
+            case I2B:
+            case I2C:
+            case I2S:
+            case ARRAYLENGTH:
+            case INSTANCEOF:
+            {
+                pop();
+                push(KIND_INT);
+                break;
+            }
+
+            case LNEG:
+            case DNEG:
+            case I2L:
+            case I2D:
+            case L2D:
+            case F2L:
+            case F2D:
+            case D2L:
+            {
+                pop();
+                push(KIND_WIDE);
+                break;
+            }
+
+            case NEWARRAY:
+            case ANEWARRAY:
+            case CHECKCAST:
+            {
+                pop();
+                push(KIND_REFERENCE);
+                break;
+            }
+
+            case IINC:
+            {
+                check_local(operands[0]);
+                break;
+            }
+
+            case JSR:
+            case JSR_W:
+            {
+                push(KIND_INT);
+                break;
+            }
+
+            case RET:
+            {
+                check_local(operands[0]);
+                break;
+            }
+
+            case WIDE:
+            {
+                uint16_t index = read_bytecode_u16(operands + 1);
+                switch (operands[0])
+                {
+                    case ILOAD:
+                    case FLOAD:
+                        load(index, KIND_INT);
+                        break;
+                    case LLOAD:
+                    case DLOAD:
+                        load(index, KIND_WIDE);
+                        break;
+                    case ALOAD:
+                        load(index, KIND_REFERENCE);
+                        break;
+                    case ISTORE:
+                    case FSTORE:
+                    case ASTORE:
+                        store(index, pop());
+                        break;
+                    case LSTORE:
+                    case DSTORE:
+                        pop();
+                        store(index, KIND_WIDE);
+                        break;
+                    case IINC:
+                    case RET:
+                        check_local(index);
+                        break;
+                    default:
+                        _failed = true;
+                        break;
+                }
+                break;
+            }
+
+            case GETSTATIC:
+            case PUTSTATIC:
+            case GETFIELD:
+            case PUTFIELD:
+            {
+                const String *descriptor = member_descriptor(
+                    _method->declaring_class(), read_bytecode_u16(operands));
+                if (descriptor == 0 || descriptor->length() == 0)
+                {
+                    _failed = true;
+                    break;
+                }
+
+                uint8_t kind = descriptor_kind((*descriptor)[0]);
+                if (instruction == GETFIELD || instruction == PUTFIELD)
+                {
+                    pop();
+                }
+                if (instruction == GETSTATIC || instruction == GETFIELD)
+                {
+                    push(kind);
+                }
+                else
+                {
+                    pop();
+                }
+                break;
+            }
+
+            case INVOKEVIRTUAL:
+            case INVOKESPECIAL:
+            case INVOKESTATIC:
+            case INVOKEINTERFACE:
+            case INVOKEDYNAMIC:
+            {
+                const String *descriptor = member_descriptor(
+                    _method->declaring_class(), read_bytecode_u16(operands));
+                if (descriptor == 0)
+                {
+                    _failed = true;
+                    break;
+                }
+
+                // Every parameter is a single operand
+                const String &types = *descriptor;
+                uint32_t index = 1;
+                while (index < types.length() && types[index] != ')')
+                {
+                    while (index < types.length() && types[index] == '[')
+                    {
+                        ++index;
+                    }
+                    if (index < types.length() && types[index] == 'L')
+                    {
+                        while (index < types.length() && types[index] != ';')
+                        {
+                            ++index;
+                        }
+                    }
+                    ++index;
+                    pop();
+                }
+
+                if (instruction != INVOKESTATIC &&
+                    instruction != INVOKEDYNAMIC)
+                {
+                    pop();
+                }
+
+                if (index + 1 >= types.length())
+                {
+                    _failed = true;
+                    break;
+                }
+
+                uint8_t kind = descriptor_kind(types[index + 1]);
+                if (kind != KIND_VOID)
+                {
+                    push(kind);
+                }
+                break;
+            }
+
+            case MULTIANEWARRAY:
+            {
+                pop(operands[2]);
+                push(KIND_REFERENCE);
+                break;
+            }
+
+            default:
+            {
+                _failed = true;
+                break;
+            }
+        }
+    }
+
+
+    void StackAnalyzer::push(uint8_t kind)
+    {
+        if (_stack_size >= _operands_count)
+        {
+            _failed = true;
+            return;
+        }
+        _current[_locals_count + _stack_size++] = kind;
+    }
+
+
+    uint8_t StackAnalyzer::pop()
+    {
+        if (_stack_size == 0)
+        {
+            _failed = true;
+            return KIND_UNKNOWN;
+        }
+        return _current[_locals_count + --_stack_size];
+    }
+
+
+    void StackAnalyzer::pop(uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            pop();
+        }
+    }
+
+
+    void StackAnalyzer::check_local(uint32_t index)
+    {
+        if (index >= _locals_count)
+        {
+            _failed = true;
+        }
+    }
+
+
+    void StackAnalyzer::load(uint32_t index, uint8_t kind)
+    {
+        check_local(index);
+        push(kind);
+    }
+
+
+    void StackAnalyzer::store(uint32_t index, uint8_t kind)
+    {
+        uint32_t size = kind == KIND_WIDE ? 2 : 1;
+        if (index + size > _locals_count)
+        {
+            _failed = true;
+            return;
+        }
+
+        // Storing into the second half of a long or double destroys it
+        if (index > 0 && (_current[index - 1] & KIND_MASK) == KIND_WIDE)
+        {
+            _current[index - 1] = KIND_UNKNOWN | KIND_STORED;
+        }
+
+        _current[index] = kind | KIND_STORED;
+        if (size == 2)
+        {
+            _current[index + 1] = KIND_UNKNOWN | KIND_STORED;
+        }
+    }
+
+
+    uint8_t StackAnalyzer::constant_kind(uint16_t index)
+    {
+        Class *clazz = _method->declaring_class();
+        auto &constantPool = clazz->class_file->constantPool;
+        if (index >= constantPool.length() || constantPool[index] == 0)
+        {
+            return KIND_VOID;
+        }
+
+        switch (constantPool[index]->tag)
+        {
+            case CP_INTEGER:
+            case CP_FLOAT:
+                return KIND_INT;
+            case CP_LONG:
+            case CP_DOUBLE:
+                return KIND_WIDE;
+            case CP_STRING:
+            case CP_CLASS:
+            case CP_METHODTYPE:
+            case CP_METHODHANDLE:
+                return KIND_REFERENCE;
+            default:
+                return KIND_VOID;
+        }
+    }
+
+
+    const String *StackAnalyzer::member_descriptor(Class *clazz,
+        uint16_t index)
+    {
+        auto &constantPool = clazz->class_file->constantPool;
+        if (index >= constantPool.length() || constantPool[index] == 0)
+        {
+            return 0;
+        }
+
+        ConstantPoolEntry *entry = constantPool[index];
+        uint16_t nameAndTypeIndex;
+        switch (entry->tag)
+        {
+            case CP_FIELDREF:
+                nameAndTypeIndex =
+                    ((FieldrefInfoEntry *) entry)->nameAndTypeIndex;
+                break;
+            case CP_METHODREF:
+                nameAndTypeIndex =
+                    ((MethodrefInfoEntry *) entry)->nameAndTypeIndex;
+                break;
+            case CP_INTERFACEMETHODREF:
+                nameAndTypeIndex =
+                    ((InterfaceMethodrefInfoEntry *) entry)->nameAndTypeIndex;
+                break;
+            case CP_INVOKEDYNAMIC:
+                nameAndTypeIndex =
+                    ((InvokeDynamicInfoEntry *) entry)->nameAndTypeIndex;
+                break;
+            default:
+                return 0;
+        }
+
+        if (nameAndTypeIndex >= constantPool.length() ||
+            constantPool[nameAndTypeIndex] == 0 ||
+            constantPool[nameAndTypeIndex]->tag != CP_NAMEANDTYPE)
+        {
+            return 0;
+        }
+
+        auto nameAndType =
+            (NameAndTypeInfoEntry *) constantPool[nameAndTypeIndex];
+        return &clazz->get_utf8_from_cp(nameAndType->descriptorIndex);
+    }
+
+
+    void StackAnalyzer::build_reference_maps()
+    {
+#if defined(COLDSPOT_UNTAGGED_SLOTS)
+        // One bit per local-variable and operand before each instruction
+        uint16_t mapSize = (uint16_t) ((_width + 7) / 8);
+        uint8_t *maps = new uint8_t[_length * mapSize]();
+
+        for (uint32_t i = 0; i < _instructions; ++i)
+        {
+            if (_stack_sizes[i] < 0)
+            {
+                continue;
+            }
+
+            const uint8_t *kinds = &_kinds[i * _width];
+            uint8_t *map = &maps[_pcs[i] * mapSize];
+            uint32_t count = _locals_count + (uint32_t) _stack_sizes[i];
+            for (uint32_t j = 0; j < count; ++j)
+            {
+                if ((kinds[j] & KIND_MASK) == KIND_REFERENCE)
+                {
+                    map[j / 8] |= 1 << (j % 8);
+                }
+            }
+        }
+
+        _method->set_reference_maps(maps, mapSize);
+#endif
+    }
+
+}
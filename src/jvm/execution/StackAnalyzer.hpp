@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_EXECUTION_STACKANALYZER_HPP_
+#define COLDSPOT_JVM_EXECUTION_STACKANALYZER_HPP_
+
+#include <cstdint>
+
+#include <jvm/common/fixed_stack.hpp>
+#include <jvm/common/SmartArray.hpp>
+#include <jvm/common/String.hpp>
+#include <jvm/Error.hpp>
+
+namespace coldspot
+{
+
+    class Class;
+    class Method;
+
+    // Computes the kinds of the local-variables and operands before each
+    // instruction of a method by abstract interpretation of its bytecode.
+    // The interpreter holds long and double in a single operand, so the
+    // pop2- and dup-instructions on them are rewritten into the variants,
+    // that move single operands. With untagged slots, the reference-maps
+    // of the method are built from the kinds.
+    class StackAnalyzer
+    {
+    public:
+
+        StackAnalyzer(Method *method, uint8_t *code);
+
+        // Analyzes the bytecode and rewrites the translated code.
+        // Fails if the operands of the bytecode can not be tracked.
+        error_t analyze();
+
+        // Returns the count of operands before the instruction at the
+        // program-counter, -1 if no instruction starts there or it is
+        // unreachable.
+        int32_t stack_size(uint32_t pc);
+
+        // Builds the reference-maps of the method (untagged slots only).
+        void build_reference_maps();
+
+        // Returns the descriptor of a field-, method- or invoke-dynamic-
+        // reference in the constant-pool, 0 if the reference is invalid.
+        static const String *member_descriptor(Class *clazz, uint16_t index);
+
+    private:
+
+        Method *_method;
+        const uint8_t *_bytecode;
+        uint8_t *_code;
+        uint32_t _length;
+
+        // Local-variables and operands of each state
+        uint16_t _locals_count;
+        uint16_t _operands_count;
+        uint32_t _width;
+
+        // Index of the instruction at each program-counter and vice versa
+        SmartArray<uint32_t, uint32_t> _indices;
+        SmartArray<uint32_t, uint32_t> _pcs;
+        uint32_t _instructions;
+
+        // Kinds and operand-count before each instruction
+        SmartArray<uint8_t, uint32_t> _kinds;
+        SmartArray<int32_t, uint32_t> _stack_sizes;
+
+        // Instructions, whose state changed
+        fixed_stack<uint32_t> _worklist;
+        SmartArray<bool, uint32_t> _queued;
+
+        // Jsr- and ret-instructions, with the subroutine of each ret
+        fixed_stack<uint32_t> _jsrs;
+        fixed_stack<uint32_t> _rets;
+        SmartArray<uint32_t, uint32_t> _subroutines;
+
+        // State of the instruction in process
+        SmartArray<uint8_t, uint32_t> _current;
+        uint32_t _stack_size;
+        bool _failed;
+
+        // Indexes the instructions and the subroutines.
+        error_t find_instructions();
+        void find_subroutines();
+
+        // Processes the instruction and merges its state into the successors.
+        void process(uint32_t index);
+        void execute(uint32_t pc);
+        void merge(uint32_t pc, const uint8_t *kinds, uint32_t stackSize);
+        void merge_handlers(uint32_t pc);
+        void merge_jsr(uint32_t pc);
+        void merge_ret(uint32_t pc);
+
+        // Calls the function with the branch-targets of the instruction
+        // and returns if it can continue with the next instruction.
+        template<typename F>
+        bool for_each_target(uint32_t pc, F function);
+        uint32_t jsr_target(uint32_t pc);
+        bool is_ret(uint32_t pc);
+
+        // Operations on the state in process.
+        void push(uint8_t kind);
+        uint8_t pop();
+        void pop(uint32_t count);
+        void check_local(uint32_t index);
+        void load(uint32_t index, uint8_t kind);
+        void store(uint32_t index, uint8_t kind);
+
+        // Kinds of constants of the constant-pool.
+        uint8_t constant_kind(uint16_t index);
+    };
+
+}
+
+#endif
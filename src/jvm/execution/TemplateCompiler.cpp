@@ -0,0 +1,886 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+#include <jvm/Global.hpp>
+
+// Objects and arrays have a vtable, but gcc and clang lay out their members
+// like standard-layout classes.
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+
+// Displacements of the members, accessed by the templates.
+#define FRAME_OFFSET(member) ((int32_t) offsetof(Frame, member))
+#define SLOT_VALUE_OFFSET ((int32_t) offsetof(Slot, _value))
+#define SLOT_TYPE_OFFSET ((int32_t) offsetof(Value, _type))
+#define OBJECT_MEMORY_OFFSET ((int32_t) offsetof(Object, _memory))
+#define ARRAY_LENGTH_OFFSET ((int32_t) offsetof(Array, _length))
+
+// Registers, that hold the frame during the execution of the templates.
+#define FRAME_REGISTER RBX
+#define LOCALS_REGISTER R12
+#define OPERANDS_REGISTER R13
+#define POLL_REGISTER R14
+
+// Minimum size of the executable chunks.
+#define CODE_CHUNK_SIZE (1024 * 1024)
+
+namespace coldspot
+{
+
+    // Types of the quick field-instructions, in the order of their opcodes.
+    static const Type QUICK_TYPES[8] = {
+        TYPE_BYTE, TYPE_CHAR, TYPE_SHORT, TYPE_INT, TYPE_FLOAT, TYPE_LONG,
+        TYPE_DOUBLE, TYPE_REFERENCE
+    };
+
+    Mutex TemplateCompiler::_mutex;
+    uint8_t *TemplateCompiler::_memory = 0;
+    uint32_t TemplateCompiler::_memory_left = 0;
+
+    void CompiledMethod::run(Frame *frame)
+    {
+        typedef void (*Prologue)(Frame *, const uint8_t *, const bool *);
+
+        uint32_t entry = _entries[CURRENT_PC(frame)];
+        if (entry == NO_ENTRY)
+        {
+            return;
+        }
+
+        ((Prologue) _code)(frame, _code + entry,
+            reinterpret_cast<const bool *>(&_safepoint_poll));
+    }
+
+    void TemplateCompiler::compile(Method *method)
+    {
+#if TEMPLATE_COMPILER_AVAILABLE
+        _mutex.lock();
+
+        if (method->compiled_method() == 0)
+        {
+            // The analyzer rewrites the code it analyzes
+            uint32_t codeLength = method->code_length();
+            dynarray<uint8_t> code(codeLength);
+            memcpy(code, method->bytecode(), codeLength);
+
+            StackAnalyzer analyzer(method, code);
+            if (analyzer.analyze() == RETURN_OK)
+            {
+                TemplateCompiler compiler(method, &analyzer);
+                CompiledMethod *compiled = compiler.translate();
+                if (compiled != 0)
+                {
+                    LOG_DEBUG_VERBOSE(Execute, "compiled '"
+                        << method->signature().name.c_str() << "' to "
+                        << compiler._assembler.size() << " bytes")
+                    method->set_compiled_method(compiled);
+                }
+            }
+        }
+
+        _mutex.unlock();
+#endif
+    }
+
+    TemplateCompiler::TemplateCompiler(Method *method,
+        StackAnalyzer *analyzer) : _method(method), _code(method->code()),
+                                   _analyzer(analyzer)
+    {
+        _entries.init(method->code_length());
+        _exits.init(method->code_length());
+    }
+
+    CompiledMethod *TemplateCompiler::translate()
+    {
+        uint32_t codeLength = _method->code_length();
+        for (uint32_t pc = 0; pc < codeLength; ++pc)
+        {
+            _entries[pc] = CompiledMethod::NO_ENTRY;
+            _exits[pc] = CompiledMethod::NO_ENTRY;
+        }
+
+        // Prologue: void (Frame *frame, const uint8_t *entry,
+        //                 const bool *poll)
+        _assembler.push(RBX);
+        _assembler.push(RBP);
+        _assembler.push(R12);
+        _assembler.push(R13);
+        _assembler.push(R14);
+        _assembler.move64(FRAME_REGISTER, RDI);
+        _assembler.load64(LOCALS_REGISTER, FRAME_REGISTER,
+            FRAME_OFFSET(localVariables));
+        _assembler.load64(OPERANDS_REGISTER, FRAME_REGISTER,
+            FRAME_OFFSET(operands));
+        _assembler.move64(POLL_REGISTER, RDX);
+        _assembler.jmp(RSI);
+
+        // Unreached instructions have no template. Every template falls
+        // through to a reached instruction or jumps.
+        for (uint32_t pc = 0; pc < codeLength; ++pc)
+        {
+            int32_t depth = _analyzer->stack_size(pc);
+            if (depth >= 0)
+            {
+                _entries[pc] = _assembler.size();
+                emit_template(pc, (uint32_t) depth);
+            }
+        }
+
+        emit_exits();
+
+        for (Jump &jump : _jumps)
+        {
+            uint32_t target = jump.exit ? _exits[jump.pc] : _entries[jump.pc];
+            if (target == CompiledMethod::NO_ENTRY)
+            {
+                return 0;
+            }
+            _assembler.patch_jump(jump.position, target);
+        }
+
+        // Copy the code into executable memory
+        uint32_t size = _assembler.size();
+        if (size > _memory_left)
+        {
+            uint32_t chunkSize = size > CODE_CHUNK_SIZE ? size
+                                                        : CODE_CHUNK_SIZE;
+            uint8_t *chunk = (uint8_t *) System::allocateExecutable(chunkSize);
+            if (chunk == 0)
+            {
+                return 0;
+            }
+            _memory = chunk;
+            _memory_left = chunkSize;
+        }
+
+        uint8_t *code = _memory;
+        memcpy(code, _assembler.buffer(), size);
+        _memory += size;
+        _memory_left -= size;
+
+        CompiledMethod *compiled = new CompiledMethod(code, codeLength);
+        for (uint32_t pc = 0; pc < codeLength; ++pc)
+        {
+            compiled->entries()[pc] = _entries[pc];
+        }
+
+        return compiled;
+    }
+
+    void TemplateCompiler::emit_template(uint32_t pc, uint32_t depth)
+    {
+        X86Assembler &a = _assembler;
+
+        uint8_t instruction = _code[pc];
+        const uint8_t *operands = _code + pc + 1;
+
+        // The cache-entries of quick instructions were written
+        // before their opcodes
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Superinstructions start with their first instruction
+        if (instruction >= ALOAD_0_GETFIELD_INT)
+        {
+            instruction = _method->bytecode()[pc];
+        }
+
+        switch (instruction)
+        {
+            case NOP:
+                break;
+
+            case ACONST_NULL:
+                store_immediate(OPERANDS_REGISTER, depth, 0, TYPE_REFERENCE);
+                break;
+
+            case ICONST_M1:
+            case ICONST_0:
+            case ICONST_1:
+            case ICONST_2:
+            case ICONST_3:
+            case ICONST_4:
+            case ICONST_5:
+                store_immediate(OPERANDS_REGISTER, depth,
+                    instruction - ICONST_0, TYPE_INT);
+                break;
+
+            case LCONST_0:
+            case LCONST_1:
+                store_immediate(OPERANDS_REGISTER, depth,
+                    instruction - LCONST_0, TYPE_LONG);
+                break;
+
+            case FCONST_0:
+            case FCONST_1:
+            case FCONST_2:
+            {
+                static const int32_t bits[3] = {
+                    0, 0x3F800000, 0x40000000
+                };
+                store_immediate(OPERANDS_REGISTER, depth,
+                    bits[instruction - FCONST_0], TYPE_FLOAT);
+                break;
+            }
+
+            case DCONST_0:
+            case DCONST_1:
+                a.move_immediate64(RAX,
+                    instruction == DCONST_0 ? 0 : 0x3FF0000000000000);
+                store(OPERANDS_REGISTER, depth, RAX, TYPE_DOUBLE);
+                break;
+
+            case BIPUSH:
+                store_immediate(OPERANDS_REGISTER, depth,
+                    (jbyte) operands[0], TYPE_INT);
+                break;
+
+            case SIPUSH:
+                store_immediate(OPERANDS_REGISTER, depth,
+                    read_operand<int16_t>(operands), TYPE_INT);
+                break;
+
+            case ILOAD:
+            case LLOAD:
+            case FLOAD:
+            case DLOAD:
+            case ALOAD:
+                copy(OPERANDS_REGISTER, depth, LOCALS_REGISTER, operands[0]);
+                break;
+
+            case ILOAD_0: case ILOAD_1: case ILOAD_2: case ILOAD_3:
+            case LLOAD_0: case LLOAD_1: case LLOAD_2: case LLOAD_3:
+            case FLOAD_0: case FLOAD_1: case FLOAD_2: case FLOAD_3:
+            case DLOAD_0: case DLOAD_1: case DLOAD_2: case DLOAD_3:
+            case ALOAD_0: case ALOAD_1: case ALOAD_2: case ALOAD_3:
+                copy(OPERANDS_REGISTER, depth, LOCALS_REGISTER,
+                    (instruction - ILOAD_0) % 4);
+                break;
+
+            case ISTORE:
+            case LSTORE:
+            case FSTORE:
+            case DSTORE:
+            case ASTORE:
+                copy(LOCALS_REGISTER, operands[0], OPERANDS_REGISTER,
+                    depth - 1);
+                break;
+
+            case ISTORE_0: case ISTORE_1: case ISTORE_2: case ISTORE_3:
+            case LSTORE_0: case LSTORE_1: case LSTORE_2: case LSTORE_3:
+            case FSTORE_0: case FSTORE_1: case FSTORE_2: case FSTORE_3:
+            case DSTORE_0: case DSTORE_1: case DSTORE_2: case DSTORE_3:
+            case ASTORE_0: case ASTORE_1: case ASTORE_2: case ASTORE_3:
+                copy(LOCALS_REGISTER, (instruction - ISTORE_0) % 4,
+                    OPERANDS_REGISTER, depth - 1);
+                break;
+
+            case POP:
+            case POP2:
+                break;
+
+            case DUP:
+                copy(OPERANDS_REGISTER, depth, OPERANDS_REGISTER, depth - 1);
+                break;
+
+            case DUP_X1:
+                copy(OPERANDS_REGISTER, depth, OPERANDS_REGISTER, depth - 1);
+                copy(OPERANDS_REGISTER, depth - 1,
+                    OPERANDS_REGISTER, depth - 2);
+                copy(OPERANDS_REGISTER, depth - 2, OPERANDS_REGISTER, depth);
+                break;
+
+            case DUP2:
+                copy(OPERANDS_REGISTER, depth, OPERANDS_REGISTER, depth - 2);
+                copy(OPERANDS_REGISTER, depth + 1,
+                    OPERANDS_REGISTER, depth - 1);
+                break;
+
+            case SWAP:
+            {
+                int32_t first = (depth - 2) * sizeof(Slot);
+                int32_t second = (depth - 1) * sizeof(Slot);
+                a.load64(RAX, OPERANDS_REGISTER, first + SLOT_VALUE_OFFSET);
+                a.load64(RCX, OPERANDS_REGISTER, second + SLOT_VALUE_OFFSET);
+                a.store64(OPERANDS_REGISTER, first + SLOT_VALUE_OFFSET, RCX);
+                a.store64(OPERANDS_REGISTER, second + SLOT_VALUE_OFFSET, RAX);
+#if !defined(COLDSPOT_UNTAGGED_SLOTS)
+                a.load32(RAX, OPERANDS_REGISTER, first + SLOT_TYPE_OFFSET);
+                a.load32(RCX, OPERANDS_REGISTER, second + SLOT_TYPE_OFFSET);
+                a.store32(OPERANDS_REGISTER, first + SLOT_TYPE_OFFSET, RCX);
+                a.store32(OPERANDS_REGISTER, second + SLOT_TYPE_OFFSET, RAX);
+#endif
+                break;
+            }
+
+            case IADD:
+            case ISUB:
+            case IMUL:
+            case IAND:
+            case IOR:
+            case IXOR:
+            case ISHL:
+            case ISHR:
+            case IUSHR:
+            case LADD:
+            case LSUB:
+            case LMUL:
+            case LAND:
+            case LOR:
+            case LXOR:
+            case LSHL:
+            case LSHR:
+            case LUSHR:
+            {
+                // Long variants follow their int variants
+                bool wide = (instruction - IADD) % 2 == 1;
+                bool shift = instruction >= ISHL && instruction <= LUSHR;
+
+                if (wide)
+                {
+                    load(RAX, OPERANDS_REGISTER, depth - 2);
+                }
+                else
+                {
+                    load32(RAX, OPERANDS_REGISTER, depth - 2);
+                }
+                if (wide && !shift)
+                {
+                    load(RCX, OPERANDS_REGISTER, depth - 1);
+                }
+                else
+                {
+                    load32(RCX, OPERANDS_REGISTER, depth - 1);
+                }
+
+                switch (instruction)
+                {
+                    case IADD: case LADD: a.add(wide, RAX, RCX); break;
+                    case ISUB: case LSUB: a.sub(wide, RAX, RCX); break;
+                    case IMUL: case LMUL: a.imul(wide, RAX, RCX); break;
+                    case IAND: case LAND: a.and_(wide, RAX, RCX); break;
+                    case IOR: case LOR: a.or_(wide, RAX, RCX); break;
+                    case IXOR: case LXOR: a.xor_(wide, RAX, RCX); break;
+                    case ISHL: case LSHL: a.shl(wide, RAX); break;
+                    case ISHR: case LSHR: a.sar(wide, RAX); break;
+                    default: a.shr(wide, RAX); break;
+                }
+
+                if (wide)
+                {
+                    store(OPERANDS_REGISTER, depth - 2, RAX, TYPE_LONG);
+                }
+                else
+                {
+                    a.sign_extend32(RAX, RAX);
+                    store(OPERANDS_REGISTER, depth - 2, RAX, TYPE_INT);
+                }
+                break;
+            }
+
+            case IDIV:
+            case IREM:
+            case LDIV:
+            case LREM:
+            {
+                // Division by zero throws, the interpreter handles it
+                bool wide = instruction == LDIV || instruction == LREM;
+                if (wide)
+                {
+                    load(RAX, OPERANDS_REGISTER, depth - 2);
+                    load(RCX, OPERANDS_REGISTER, depth - 1);
+                }
+                else
+                {
+                    load32(RAX, OPERANDS_REGISTER, depth - 2);
+                    load32(RCX, OPERANDS_REGISTER, depth - 1);
+                }
+                a.test(wide, RCX, RCX);
+                exit_at(a.jcc(CONDITION_EQUAL), pc);
+
+                // MIN_VALUE / -1 traps in idiv, the quotient of -1 is the
+                // wrapping negation and the remainder is 0
+                a.cmp_immediate(wide, RCX, -1);
+                uint32_t divide = a.jcc(CONDITION_NOT_EQUAL);
+                a.neg(wide, RAX);
+                a.xor_(false, RDX, RDX);
+                uint32_t done = a.jmp();
+                a.patch_jump(divide, a.size());
+                a.idiv(wide, RCX);
+                a.patch_jump(done, a.size());
+
+                X86Register result =
+                    instruction == IDIV || instruction == LDIV ? RAX : RDX;
+                if (!wide)
+                {
+                    a.sign_extend32(result, result);
+                }
+                store(OPERANDS_REGISTER, depth - 2, result,
+                    wide ? TYPE_LONG : TYPE_INT);
+                break;
+            }
+
+            case INEG:
+                load32(RAX, OPERANDS_REGISTER, depth - 1);
+                a.neg(false, RAX);
+                a.sign_extend32(RAX, RAX);
+                store(OPERANDS_REGISTER, depth - 1, RAX, TYPE_INT);
+                break;
+
+            case LNEG:
+                load(RAX, OPERANDS_REGISTER, depth - 1);
+                a.neg(true, RAX);
+                store(OPERANDS_REGISTER, depth - 1, RAX, TYPE_LONG);
+                break;
+
+            case IINC:
+            {
+                uint8_t index = operands[0];
+                load32(RAX, LOCALS_REGISTER, index);
+                a.add_immediate(false, RAX, (jbyte) operands[1]);
+                a.sign_extend32(RAX, RAX);
+                store(LOCALS_REGISTER, index, RAX, TYPE_INT);
+                break;
+            }
+
+            case I2L:
+                load32(RAX, OPERANDS_REGISTER, depth - 1);
+                a.sign_extend32(RAX, RAX);
+                store(OPERANDS_REGISTER, depth - 1, RAX, TYPE_LONG);
+                break;
+
+            case L2I:
+            case I2B:
+            case I2C:
+            case I2S:
+                load32(RAX, OPERANDS_REGISTER, depth - 1);
+                if (instruction == I2B)
+                {
+                    a.sign_extend8(RAX, RAX);
+                }
+                else if (instruction == I2C)
+                {
+                    a.zero_extend16(RAX, RAX);
+                }
+                else if (instruction == I2S)
+                {
+                    a.sign_extend16(RAX, RAX);
+                }
+                a.sign_extend32(RAX, RAX);
+                store(OPERANDS_REGISTER, depth - 1, RAX, TYPE_INT);
+                break;
+
+            case LCMP:
+                load(RAX, OPERANDS_REGISTER, depth - 2);
+                load(RCX, OPERANDS_REGISTER, depth - 1);
+                a.cmp(true, RAX, RCX);
+                a.setcc(CONDITION_GREATER, RDX);
+                a.setcc(CONDITION_LESS, RCX);
+                a.sub8(RDX, RCX);
+                a.sign_extend8(RDX, RDX);
+                store(OPERANDS_REGISTER, depth - 2, RDX, TYPE_INT);
+                break;
+
+            case IFEQ:
+            case IFNE:
+            case IFLT:
+            case IFGE:
+            case IFGT:
+            case IFLE:
+            case IF_ICMPEQ:
+            case IF_ICMPNE:
+            case IF_ICMPLT:
+            case IF_ICMPGE:
+            case IF_ICMPGT:
+            case IF_ICMPLE:
+            {
+                static const X86Condition conditions[6] = {
+                    CONDITION_EQUAL, CONDITION_NOT_EQUAL, CONDITION_LESS,
+                    CONDITION_GREATER_EQUAL, CONDITION_GREATER,
+                    CONDITION_LESS_EQUAL
+                };
+
+                if (instruction <= IFLE)
+                {
+                    load32(RAX, OPERANDS_REGISTER, depth - 1);
+                    a.test(false, RAX, RAX);
+                }
+                else
+                {
+                    load32(RAX, OPERANDS_REGISTER, depth - 2);
+                    load32(RCX, OPERANDS_REGISTER, depth - 1);
+                    a.cmp(false, RAX, RCX);
+                }
+                branch(pc, read_operand<int16_t>(operands),
+                    conditions[(instruction - IFEQ) % 6], true);
+                break;
+            }
+
+            case IF_ACMPEQ:
+            case IF_ACMPNE:
+                load(RAX, OPERANDS_REGISTER, depth - 2);
+                load(RCX, OPERANDS_REGISTER, depth - 1);
+                a.cmp(true, RAX, RCX);
+                branch(pc, read_operand<int16_t>(operands),
+                    instruction == IF_ACMPEQ ? CONDITION_EQUAL
+                                             : CONDITION_NOT_EQUAL, true);
+                break;
+
+            case IFNULL:
+            case IFNONNULL:
+                load(RAX, OPERANDS_REGISTER, depth - 1);
+                a.test(true, RAX, RAX);
+                branch(pc, read_operand<int16_t>(operands),
+                    instruction == IFNULL ? CONDITION_EQUAL
+                                          : CONDITION_NOT_EQUAL, true);
+                break;
+
+            case GOTO:
+                branch(pc, read_operand<int16_t>(operands),
+                    CONDITION_EQUAL, false);
+                break;
+
+            case GOTO_W:
+                branch(pc, read_operand<int32_t>(operands),
+                    CONDITION_EQUAL, false);
+                break;
+
+            case GETSTATIC_BYTE_QUICK: case GETSTATIC_CHAR_QUICK:
+            case GETSTATIC_SHORT_QUICK: case GETSTATIC_INT_QUICK:
+            case GETSTATIC_FLOAT_QUICK: case GETSTATIC_LONG_QUICK:
+            case GETSTATIC_DOUBLE_QUICK: case GETSTATIC_REF_QUICK:
+            {
+                CacheEntry *entry = &_method->cache_entries()[
+                    read_operand<uint16_t>(operands)];
+                Type type = QUICK_TYPES[instruction - GETSTATIC_BYTE_QUICK];
+                a.move_immediate64(RCX, (uint64_t) entry->address);
+                load_typed(RAX, RCX, 0, type);
+                store(OPERANDS_REGISTER, depth, RAX, type);
+                break;
+            }
+
+            case PUTSTATIC_BYTE_QUICK: case PUTSTATIC_CHAR_QUICK:
+            case PUTSTATIC_SHORT_QUICK: case PUTSTATIC_INT_QUICK:
+            case PUTSTATIC_FLOAT_QUICK: case PUTSTATIC_LONG_QUICK:
+            case PUTSTATIC_DOUBLE_QUICK: case PUTSTATIC_REF_QUICK:
+            {
+                CacheEntry *entry = &_method->cache_entries()[
+                    read_operand<uint16_t>(operands)];
+                Type type = QUICK_TYPES[instruction - PUTSTATIC_BYTE_QUICK];
+                load(RAX, OPERANDS_REGISTER, depth - 1);
+                a.move_immediate64(RCX, (uint64_t) entry->address);
+                store_typed(RCX, 0, RAX, type);
+                break;
+            }
+
+            case GETFIELD_BYTE_QUICK: case GETFIELD_CHAR_QUICK:
+            case GETFIELD_SHORT_QUICK: case GETFIELD_INT_QUICK:
+            case GETFIELD_FLOAT_QUICK: case GETFIELD_LONG_QUICK:
+            case GETFIELD_DOUBLE_QUICK: case GETFIELD_REF_QUICK:
+            {
+                CacheEntry *entry = &_method->cache_entries()[
+                    read_operand<uint16_t>(operands)];
+                Type type = QUICK_TYPES[instruction - GETFIELD_BYTE_QUICK];
+                load(RAX, OPERANDS_REGISTER, depth - 1);
+                null_check(RAX, pc);
+                a.load64(RAX, RAX, OBJECT_MEMORY_OFFSET);
+                load_typed(RAX, RAX, entry->offset, type);
+                store(OPERANDS_REGISTER, depth - 1, RAX, type);
+                break;
+            }
+
+            case PUTFIELD_BYTE_QUICK: case PUTFIELD_CHAR_QUICK:
+            case PUTFIELD_SHORT_QUICK: case PUTFIELD_INT_QUICK:
+            case PUTFIELD_FLOAT_QUICK: case PUTFIELD_LONG_QUICK:
+            case PUTFIELD_DOUBLE_QUICK: case PUTFIELD_REF_QUICK:
+            {
+                CacheEntry *entry = &_method->cache_entries()[
+                    read_operand<uint16_t>(operands)];
+                Type type = QUICK_TYPES[instruction - PUTFIELD_BYTE_QUICK];
+                if (type == TYPE_REFERENCE)
+                {
+                    // The interpreter records the overwritten reference
+                    // while a concurrent marking is active
+                    a.move_immediate64(RDX, (uint64_t) &_satb_active);
+                    a.cmp_memory8_zero(RDX, 0);
+                    exit_at(a.jcc(CONDITION_NOT_EQUAL), pc);
+                }
+                load(RCX, OPERANDS_REGISTER, depth - 2);
+                null_check(RCX, pc);
+                if (type == TYPE_REFERENCE)
+                {
+                    write_barrier(RCX);
+                }
+                load(RAX, OPERANDS_REGISTER, depth - 1);
+                a.load64(RCX, RCX, OBJECT_MEMORY_OFFSET);
+                store_typed(RCX, entry->offset, RAX, type);
+                break;
+            }
+
+            case ARRAYLENGTH:
+                load(RAX, OPERANDS_REGISTER, depth - 1);
+                null_check(RAX, pc);
+                a.load32(RAX, RAX, ARRAY_LENGTH_OFFSET);
+                store(OPERANDS_REGISTER, depth - 1, RAX, TYPE_INT);
+                break;
+
+            case IALOAD:
+            case LALOAD:
+            case FALOAD:
+            case DALOAD:
+            case AALOAD:
+            case BALOAD:
+            case CALOAD:
+            case SALOAD:
+            case IASTORE:
+            case LASTORE:
+            case FASTORE:
+            case DASTORE:
+            case BASTORE:
+            case CASTORE:
+            case SASTORE:
+            {
+                // Types and the log2 of the sizes of the components
+                static const Type types[8] = {
+                    TYPE_INT, TYPE_LONG, TYPE_FLOAT, TYPE_DOUBLE,
+                    TYPE_REFERENCE, TYPE_BYTE, TYPE_CHAR, TYPE_SHORT
+                };
+                static const uint8_t shifts[8] = { 2, 3, 2, 3, 3, 0, 1, 1 };
+
+                bool isStore = instruction >= IASTORE;
+                uint32_t kind = instruction - (isStore ? IASTORE : IALOAD);
+                uint32_t array = depth - (isStore ? 3 : 2);
+
+                load(RAX, OPERANDS_REGISTER, array);
+                load32(RCX, OPERANDS_REGISTER, array + 1);
+                null_check(RAX, pc);
+                a.cmp_memory32(RCX, RAX, ARRAY_LENGTH_OFFSET);
+                exit_at(a.jcc(CONDITION_ABOVE_EQUAL), pc);
+                a.load64(RAX, RAX, OBJECT_MEMORY_OFFSET);
+                a.shl_immediate(true, RCX, shifts[kind]);
+                a.add(true, RAX, RCX);
+
+                if (isStore)
+                {
+                    load(RDX, OPERANDS_REGISTER, depth - 1);
+                    store_typed(RAX, 0, RDX, types[kind]);
+                }
+                else
+                {
+                    // Small components are pushed as int
+                    load_typed(RAX, RAX, 0, types[kind]);
+                    store(OPERANDS_REGISTER, array, RAX,
+                        kind < 5 ? types[kind] : TYPE_INT);
+                }
+                break;
+            }
+
+            default:
+                // Left to the interpreter
+                exit_at(a.jmp(), pc);
+                break;
+        }
+    }
+
+    void TemplateCompiler::emit_exits()
+    {
+        for (Jump &jump : _jumps)
+        {
+            if (!jump.exit || _exits[jump.pc] != CompiledMethod::NO_ENTRY)
+            {
+                continue;
+            }
+
+            _exits[jump.pc] = _assembler.size();
+            _assembler.move_immediate64(RAX,
+                (uint64_t) (_method->code() + jump.pc));
+            _assembler.store64(FRAME_REGISTER, FRAME_OFFSET(currentCode), RAX);
+            _assembler.store_immediate16(FRAME_REGISTER,
+                FRAME_OFFSET(operandsCount),
+                (uint16_t) _analyzer->stack_size(jump.pc));
+            _assembler.pop(R14);
+            _assembler.pop(R13);
+            _assembler.pop(R12);
+            _assembler.pop(RBP);
+            _assembler.pop(RBX);
+            _assembler.ret();
+        }
+    }
+
+    void TemplateCompiler::jump_to(uint32_t position, uint32_t pc)
+    {
+        _jumps.addBack(Jump{position, pc, false});
+    }
+
+    void TemplateCompiler::exit_at(uint32_t position, uint32_t pc)
+    {
+        _jumps.addBack(Jump{position, pc, true});
+    }
+
+    void TemplateCompiler::branch(uint32_t pc, int32_t offset,
+        X86Condition condition, bool conditional)
+    {
+        uint32_t target = pc + offset;
+        if (offset > 0)
+        {
+            jump_to(conditional ? _assembler.jcc(condition)
+                                : _assembler.jmp(), target);
+            return;
+        }
+
+        // Backward branches poll the safepoint, the interpreter
+        // continues at the target if a suspension was requested
+        uint32_t skip = 0;
+        if (conditional)
+        {
+            // Inverse of the condition
+            skip = _assembler.jcc((X86Condition) (condition ^ 1));
+        }
+        _assembler.cmp_memory8_zero(POLL_REGISTER, 0);
+        exit_at(_assembler.jcc(CONDITION_NOT_EQUAL), target);
+        jump_to(_assembler.jmp(), target);
+        if (conditional)
+        {
+            _assembler.patch_jump(skip, _assembler.size());
+        }
+    }
+
+    void TemplateCompiler::load(X86Register reg, X86Register base,
+        uint32_t index)
+    {
+        _assembler.load64(reg, base, index * sizeof(Slot) + SLOT_VALUE_OFFSET);
+    }
+
+    void TemplateCompiler::load32(X86Register reg, X86Register base,
+        uint32_t index)
+    {
+        _assembler.load32(reg, base, index * sizeof(Slot) + SLOT_VALUE_OFFSET);
+    }
+
+    void TemplateCompiler::store(X86Register base, uint32_t index,
+        X86Register reg, Type type)
+    {
+        _assembler.store64(base, index * sizeof(Slot) + SLOT_VALUE_OFFSET,
+            reg);
+#if !defined(COLDSPOT_UNTAGGED_SLOTS)
+        _assembler.store_immediate32(base,
+            index * sizeof(Slot) + SLOT_TYPE_OFFSET, type);
+#endif
+    }
+
+    void TemplateCompiler::store_immediate(X86Register base, uint32_t index,
+        int32_t immediate, Type type)
+    {
+        _assembler.store_immediate64(base,
+            index * sizeof(Slot) + SLOT_VALUE_OFFSET, immediate);
+#if !defined(COLDSPOT_UNTAGGED_SLOTS)
+        _assembler.store_immediate32(base,
+            index * sizeof(Slot) + SLOT_TYPE_OFFSET, type);
+#endif
+    }
+
+    void TemplateCompiler::copy(X86Register toBase, uint32_t toIndex,
+        X86Register fromBase, uint32_t fromIndex)
+    {
+        load(RAX, fromBase, fromIndex);
+        _assembler.store64(toBase, toIndex * sizeof(Slot) + SLOT_VALUE_OFFSET,
+            RAX);
+#if !defined(COLDSPOT_UNTAGGED_SLOTS)
+        _assembler.load32(RAX, fromBase,
+            fromIndex * sizeof(Slot) + SLOT_TYPE_OFFSET);
+        _assembler.store32(toBase, toIndex * sizeof(Slot) + SLOT_TYPE_OFFSET,
+            RAX);
+#endif
+    }
+
+    void TemplateCompiler::load_typed(X86Register reg, X86Register base,
+        int32_t displacement, Type type)
+    {
+        switch (type)
+        {
+            case TYPE_BOOLEAN:
+            case TYPE_BYTE:
+                _assembler.load_sign_extend8(reg, base, displacement);
+                break;
+            case TYPE_CHAR:
+                _assembler.load_zero_extend16(reg, base, displacement);
+                break;
+            case TYPE_SHORT:
+                _assembler.load_sign_extend16(reg, base, displacement);
+                break;
+            case TYPE_INT:
+                _assembler.load_sign_extend32(reg, base, displacement);
+                break;
+            case TYPE_FLOAT:
+                _assembler.load32(reg, base, displacement);
+                break;
+            default:
+                _assembler.load64(reg, base, displacement);
+                break;
+        }
+    }
+
+    void TemplateCompiler::store_typed(X86Register base, int32_t displacement,
+        X86Register reg, Type type)
+    {
+        switch (type)
+        {
+            case TYPE_BOOLEAN:
+            case TYPE_BYTE:
+                _assembler.store8(base, displacement, reg);
+                break;
+            case TYPE_CHAR:
+            case TYPE_SHORT:
+                _assembler.store16(base, displacement, reg);
+                break;
+            case TYPE_INT:
+            case TYPE_FLOAT:
+                _assembler.store32(base, displacement, reg);
+                break;
+            default:
+                _assembler.store64(base, displacement, reg);
+                break;
+        }
+    }
+
+    void TemplateCompiler::null_check(X86Register reg, uint32_t pc)
+    {
+        _assembler.test(true, reg, reg);
+        exit_at(_assembler.jcc(CONDITION_EQUAL), pc);
+    }
+
+
+    void TemplateCompiler::write_barrier(X86Register reg)
+    {
+        X86Assembler &a = _assembler;
+
+        // Index of the card in the region
+        a.move64(RDX, reg);
+        a.shr_immediate(true, RDX, HeapRegion::CARD_SHIFT);
+        a.and_immediate(true, RDX, HeapRegion::CARDS - 1);
+
+        // Start of the region
+        a.move64(RSI, reg);
+        a.and_immediate(true, RSI, -(int32_t) HeapRegion::SIZE);
+
+        a.add(true, RDX, RSI);
+        a.store_immediate8(RDX, HeapRegion::CARDS_OFFSET,
+            HeapRegion::CARD_DIRTY);
+    }
+
+}
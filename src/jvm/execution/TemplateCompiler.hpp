@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_EXECUTION_TEMPLATECOMPILER_HPP_
+#define COLDSPOT_JVM_EXECUTION_TEMPLATECOMPILER_HPP_
+
+#include <cstdint>
+
+#include <jvm/common/List.hpp>
+#include <jvm/common/SmartArray.hpp>
+#include <jvm/Error.hpp>
+#include <jvm/Type.hpp>
+
+#include "X86Assembler.hpp"
+
+// The template-compiler generates x86-64 code with the System V calling
+// convention and needs executable memory.
+#if defined(__x86_64__) && defined(__linux__)
+#define TEMPLATE_COMPILER_AVAILABLE 1
+#else
+#define TEMPLATE_COMPILER_AVAILABLE 0
+#endif
+
+namespace coldspot
+{
+
+    class Frame;
+    class Method;
+    class Mutex;
+    class StackAnalyzer;
+
+    // Native code of a method. It can be entered at every reachable
+    // instruction and executes the frame until it reaches an instruction,
+    // that is left to the interpreter. The local-variables and operands
+    // stay in the frame, so the interpreter continues where the native
+    // code returned.
+    class CompiledMethod
+    {
+    public:
+
+        static const uint32_t NO_ENTRY = 0xFFFFFFFF;
+
+        CompiledMethod(uint8_t *code, uint32_t codeLength) : _code(code)
+        {
+            _entries.init(codeLength);
+        }
+
+        // Executes the frame from its current instruction, if it is an
+        // entry. Returns with the program-counter and operands of the next
+        // instruction to interpret.
+        void run(Frame *frame);
+
+        // Getters.
+        SmartArray<uint32_t, uint32_t> &entries() { return _entries; }
+
+    private:
+
+        // Prologue, followed by the templates of the instructions
+        uint8_t *_code;
+
+        // Offset of the template of each instruction into the code
+        SmartArray<uint32_t, uint32_t> _entries;
+    };
+
+    // Baseline compiler, that translates each instruction of a hot method
+    // into a fixed machine-code template. Instructions, that need the
+    // runtime (invocations, allocations, returns, resolution and exceptions)
+    // are left to the interpreter, the template returns to it instead.
+    class TemplateCompiler
+    {
+    public:
+
+        static const uint32_t INVOCATION_THRESHOLD = 1000;
+        static const uint32_t BACKEDGE_THRESHOLD = 10000;
+
+        // Compiles the method, if it was not tried before.
+        static void compile(Method *method);
+
+    private:
+
+        // Serializes compilations and the allocation of executable memory
+        static Mutex _mutex;
+        static uint8_t *_memory;
+        static uint32_t _memory_left;
+
+        Method *_method;
+        const uint8_t *_code;
+        StackAnalyzer *_analyzer;
+        X86Assembler _assembler;
+
+        // Templates and their pending jumps, each to an instruction or
+        // to the exit of an instruction
+        SmartArray<uint32_t, uint32_t> _entries;
+        SmartArray<uint32_t, uint32_t> _exits;
+
+        class Jump
+        {
+        public:
+
+            uint32_t position;
+            uint32_t pc;
+            bool exit;
+
+            // Each jump has its own position.
+            bool operator==(const Jump &other) const
+            {
+                return position == other.position;
+            }
+        };
+
+        List<Jump> _jumps;
+
+        TemplateCompiler(Method *method, StackAnalyzer *analyzer);
+
+        // Emits the templates and returns the native code, 0 if the
+        // method can not be compiled.
+        CompiledMethod *translate();
+
+        // Emits the template of the instruction at the program-counter.
+        void emit_template(uint32_t pc, uint32_t depth);
+
+        // Emits the exits, that store the current instruction and
+        // operand-count into the frame and return to the interpreter.
+        void emit_exits();
+
+        // Adds a jump to the instruction or its exit.
+        void jump_to(uint32_t position, uint32_t pc);
+        void exit_at(uint32_t position, uint32_t pc);
+
+        // Emits a branch to the target, conditional unless the
+        // condition is 0. Backward branches poll the safepoint.
+        void branch(uint32_t pc, int32_t offset, X86Condition condition,
+            bool conditional);
+
+        // Moves of local-variables and operands.
+        void load(X86Register reg, X86Register base, uint32_t index);
+        void load32(X86Register reg, X86Register base, uint32_t index);
+        void store(X86Register base, uint32_t index, X86Register reg,
+            Type type);
+        void store_immediate(X86Register base, uint32_t index,
+            int32_t immediate, Type type);
+        void copy(X86Register toBase, uint32_t toIndex,
+            X86Register fromBase, uint32_t fromIndex);
+
+        // Loads and stores a value of the type at the address.
+        void load_typed(X86Register reg, X86Register base,
+            int32_t displacement, Type type);
+        void store_typed(X86Register base, int32_t displacement,
+            X86Register reg, Type type);
+
+        // Emits a jump to the exit of the instruction,
+        // if the register holds null.
+        void null_check(X86Register reg, uint32_t pc);
+
+        // Dirties the card of the object in the register, like
+        // HeapSpace::write_barrier. Rdx and rsi are overwritten.
+        void write_barrier(X86Register reg);
+    };
+
+}
+
+#endif
@@ -0,0 +1,398 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    // Length of each instruction, 0 for instructions with variable length.
+    static const uint8_t INSTRUCTION_LENGTHS[256] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0
+        2, 3, 2, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,  // 16
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 32
+        1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1,  // 48
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 64
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 80
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 96
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 112
+        1, 1, 1, 1, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 128
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3, 3,  // 144
+        3, 3, 3, 3, 3, 3, 3, 3, 3, 2, 0, 0, 1, 1, 1, 1,  // 160
+        1, 1, 3, 3, 3, 3, 3, 3, 3, 5, 5, 3, 2, 3, 1, 1,  // 176
+        3, 3, 1, 1, 0, 4, 3, 3, 5, 5, 0, 0, 0, 0, 0, 0,  // 192
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 208
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 224
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 240
+    };
+
+
+    Mutex Translator::_mutex;
+
+
+    error_t Translator::translate(Method *method)
+    {
+        _mutex.lock();
+
+        // Another thread could have translated the method meanwhile
+        if (method->code() != 0)
+        {
+            RETURN_UNLOCK(RETURN_OK, _mutex);
+        }
+
+        const uint8_t *bytecode = method->bytecode();
+        uint32_t length = method->code_length();
+
+        uint8_t *code = new uint8_t[length];
+        memcpy(code, bytecode, length);
+
+        // Track the operands, long and double are single operands
+        StackAnalyzer analyzer(method, code);
+        if (analyzer.analyze() != RETURN_OK)
+        {
+            DELETE_ARRAY(code)
+            _mutex.unlock();
+            _current_executor->throw_exception(CLASSNAME_VERIFYERROR,
+                method->signature().name.c_str());
+            return RETURN_EXCEPTION;
+        }
+        analyzer.build_reference_maps();
+
+        // Count the instructions that reference the constant-pool,
+        // ldc is counted separately, because it has only an 8-bit index
+        uint32_t ldcCount = 0;
+        uint32_t entryCount = 0;
+        for (uint32_t pc = 0; pc < length;
+             pc += instruction_length(bytecode, pc))
+        {
+            switch (bytecode[pc])
+            {
+                case LDC:
+                    ++ldcCount;
+                    break;
+                case LDC_W:
+                case LDC2_W:
+                case GETSTATIC:
+                case PUTSTATIC:
+                case GETFIELD:
+                case PUTFIELD:
+                case INVOKEVIRTUAL:
+                case INVOKESPECIAL:
+                case INVOKESTATIC:
+                case INVOKEINTERFACE:
+                case NEW:
+                case ANEWARRAY:
+                case CHECKCAST:
+                case INSTANCEOF:
+                case MULTIANEWARRAY:
+                    ++entryCount;
+                    break;
+            }
+        }
+
+        // Ldc-entries come first, so that their indices fit into 8 bits
+        uint32_t ldcEntries = ldcCount < 256 ? ldcCount : 256;
+        auto &entries = method->cache_entries();
+        entries.init(ldcEntries + entryCount);
+
+        uint16_t nextLdcEntry = 0;
+        uint16_t nextEntry = ldcEntries;
+
+        // Rewrite the operands
+        for (uint32_t pc = 0; pc < length;
+             pc += instruction_length(bytecode, pc))
+        {
+            uint8_t *operands = &code[pc + 1];
+
+            switch (bytecode[pc])
+            {
+                case SIPUSH:
+                case IFEQ:
+                case IFNE:
+                case IFLT:
+                case IFGE:
+                case IFGT:
+                case IFLE:
+                case IF_ICMPEQ:
+                case IF_ICMPNE:
+                case IF_ICMPLT:
+                case IF_ICMPGE:
+                case IF_ICMPGT:
+                case IF_ICMPLE:
+                case IF_ACMPEQ:
+                case IF_ACMPNE:
+                case GOTO:
+                case JSR:
+                case IFNULL:
+                case IFNONNULL:
+                {
+                    write_operand<int16_t>(operands,
+                        read_bytecode_u16(operands));
+                    break;
+                }
+
+                case GOTO_W:
+                case JSR_W:
+                {
+                    write_operand<int32_t>(operands,
+                        read_bytecode_s32(operands));
+                    break;
+                }
+
+                case TABLESWITCH:
+                {
+                    uint8_t *aligned = &code[(pc + 4) & ~0x03];
+                    int32_t low = read_bytecode_s32(aligned + 4);
+                    int32_t high = read_bytecode_s32(aligned + 8);
+                    int32_t count = 3 + high - low + 1;
+                    for (int32_t i = 0; i < count; ++i)
+                    {
+                        write_operand<int32_t>(aligned + i * 4,
+                            read_bytecode_s32(aligned + i * 4));
+                    }
+                    break;
+                }
+
+                case LOOKUPSWITCH:
+                {
+                    uint8_t *aligned = &code[(pc + 4) & ~0x03];
+                    int32_t pairs = read_bytecode_s32(aligned + 4);
+                    int32_t count = 2 + pairs * 2;
+                    for (int32_t i = 0; i < count; ++i)
+                    {
+                        write_operand<int32_t>(aligned + i * 4,
+                            read_bytecode_s32(aligned + i * 4));
+                    }
+                    break;
+                }
+
+                case LDC:
+                {
+                    if (nextLdcEntry < ldcEntries)
+                    {
+                        entries[nextLdcEntry].index = operands[0];
+                        operands[0] = (uint8_t) nextLdcEntry++;
+                    }
+                    else
+                    {
+                        // Out of 8-bit indices, resolve on every execution
+                        code[pc] = LDC_UNCACHED;
+                    }
+                    break;
+                }
+
+                case LDC_W:
+                case LDC2_W:
+                case GETSTATIC:
+                case PUTSTATIC:
+                case GETFIELD:
+                case PUTFIELD:
+                case INVOKEVIRTUAL:
+                case INVOKESPECIAL:
+                case INVOKESTATIC:
+                case INVOKEINTERFACE:
+                case NEW:
+                case ANEWARRAY:
+                case CHECKCAST:
+                case INSTANCEOF:
+                case MULTIANEWARRAY:
+                {
+                    entries[nextEntry].index = read_bytecode_u16(operands);
+                    if (bytecode[pc] == INVOKEVIRTUAL ||
+                        bytecode[pc] == INVOKEINTERFACE)
+                    {
+                        entries[nextEntry].inline_cache = new InlineCache;
+                    }
+                    write_operand<uint16_t>(operands, nextEntry++);
+                    break;
+                }
+            }
+        }
+
+        // Profiles count the sequences of the plain instructions
+        if (_vm == 0 || !_vm->options()->profileNGrams)
+        {
+            fuse_superinstructions(method, code);
+        }
+
+        // Publish the translated code
+        method->set_code(code);
+
+        RETURN_UNLOCK(RETURN_OK, _mutex);
+    }
+
+
+// Replaces the first instruction, if the sequence matches.
+#define FUSE_PAIR(name, opcode, first, last) \
+  if (bytecode[pc] == first && second < length && \
+      executed_instruction(method, second) == last) { \
+    code[pc] = name; \
+    continue; \
+  }
+
+#define FUSE_TRIPLE(name, opcode, first, next, last) \
+  if (bytecode[pc] == first && third < length && bytecode[second] == next && \
+      executed_instruction(method, third) == last) { \
+    code[pc] = name; \
+    continue; \
+  }
+
+    void Translator::fuse_superinstructions(Method *method, uint8_t *code)
+    {
+        const uint8_t *bytecode = method->bytecode();
+        uint32_t length = method->code_length();
+
+        // The following instructions stay in the code, so the
+        // sequences may overlap and contain branch-targets
+        for (uint32_t pc = 0; pc < length;
+             pc += instruction_length(bytecode, pc))
+        {
+            uint32_t second = pc + instruction_length(bytecode, pc);
+            uint32_t third = second < length ?
+                second + instruction_length(bytecode, second) : length;
+
+            SUPERINSTRUCTIONS(FUSE_PAIR, FUSE_TRIPLE)
+        }
+    }
+
+
+    uint8_t Translator::executed_instruction(Method *method, uint32_t pc)
+    {
+        const uint8_t *bytecode = method->bytecode();
+
+        uint8_t byteInstruction;
+        switch (bytecode[pc])
+        {
+            case GETFIELD:
+                byteInstruction = GETFIELD_BYTE_QUICK;
+                break;
+            case PUTFIELD:
+                byteInstruction = PUTFIELD_BYTE_QUICK;
+                break;
+            case GETSTATIC:
+                byteInstruction = GETSTATIC_BYTE_QUICK;
+                break;
+            case PUTSTATIC:
+                byteInstruction = PUTSTATIC_BYTE_QUICK;
+                break;
+            default:
+                return bytecode[pc];
+        }
+
+        // Field-instructions are quickened by the type of the field
+        const String *descriptor = StackAnalyzer::member_descriptor(
+            method->declaring_class(), read_bytecode_u16(&bytecode[pc + 1]));
+        if (descriptor == 0 || descriptor->length() == 0)
+        {
+            return bytecode[pc];
+        }
+
+        switch ((*descriptor)[0])
+        {
+            case 'Z':
+                return quick_field_instruction(byteInstruction, TYPE_BOOLEAN);
+            case 'B':
+                return quick_field_instruction(byteInstruction, TYPE_BYTE);
+            case 'C':
+                return quick_field_instruction(byteInstruction, TYPE_CHAR);
+            case 'S':
+                return quick_field_instruction(byteInstruction, TYPE_SHORT);
+            case 'I':
+                return quick_field_instruction(byteInstruction, TYPE_INT);
+            case 'F':
+                return quick_field_instruction(byteInstruction, TYPE_FLOAT);
+            case 'J':
+                return quick_field_instruction(byteInstruction, TYPE_LONG);
+            case 'D':
+                return quick_field_instruction(byteInstruction, TYPE_DOUBLE);
+            default:
+                return quick_field_instruction(byteInstruction,
+                    TYPE_REFERENCE);
+        }
+    }
+
+
+    uint8_t Translator::quick_field_instruction(uint8_t byteInstruction,
+        Type type)
+    {
+        // The quick instructions of each kind are ordered by type
+        switch (type)
+        {
+            case TYPE_BOOLEAN:
+            case TYPE_BYTE:
+                return byteInstruction;
+            case TYPE_CHAR:
+                return byteInstruction + 1;
+            case TYPE_SHORT:
+                return byteInstruction + 2;
+            case TYPE_INT:
+                return byteInstruction + 3;
+            case TYPE_FLOAT:
+                return byteInstruction + 4;
+            case TYPE_LONG:
+                return byteInstruction + 5;
+            case TYPE_DOUBLE:
+                return byteInstruction + 6;
+            default:
+                return byteInstruction + 7;
+        }
+    }
+
+
+    uint32_t Translator::instruction_length(const uint8_t *code, uint32_t pc)
+    {
+        uint8_t length = INSTRUCTION_LENGTHS[code[pc]];
+        if (length != 0)
+        {
+            return length;
+        }
+
+        switch (code[pc])
+        {
+            case TABLESWITCH:
+            {
+                uint32_t aligned = (pc + 4) & ~0x03;
+                int32_t low = read_bytecode_s32(&code[aligned + 4]);
+                int32_t high = read_bytecode_s32(&code[aligned + 8]);
+                return aligned - pc + 12 + (high - low + 1) * 4;
+            }
+
+            case LOOKUPSWITCH:
+            {
+                uint32_t aligned = (pc + 4) & ~0x03;
+                int32_t pairs = read_bytecode_s32(&code[aligned + 4]);
+                return aligned - pc + 8 + pairs * 8;
+            }
+
+            case WIDE:
+            {
+                return code[pc + 1] == IINC ? 6 : 4;
+            }
+
+            default:
+            {
+                // Unknown instruction, the interpreter will fail on it
+                return 1;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_EXECUTION_TRANSLATOR_HPP_
+#define COLDSPOT_JVM_EXECUTION_TRANSLATOR_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <jvm/common/Memory.hpp>
+
+#include <jvm/Error.hpp>
+#include <jvm/Type.hpp>
+#include <jvm/Value.hpp>
+
+#include "InlineCache.hpp"
+
+namespace coldspot
+{
+
+    class Class;
+    class Field;
+    class Method;
+    class Mutex;
+
+    // Constant-pool reference of a translated instruction.
+    // Every referencing instruction owns an entry,
+    // that is resolved on the first execution of the instruction.
+    class CacheEntry
+    {
+    public:
+
+        // Index into the constant-pool
+        uint16_t index;
+
+        // Set after the members below were resolved
+        std::atomic<bool> resolved;
+
+        // Resolved reference
+        Class *clazz;
+        Field *field;
+        Method *method;
+
+        // Resolved constant of ldc-instructions
+        Value value;
+
+        // Field-offset of quick instance-field instructions and
+        // address of quick static-field instructions
+        jint offset;
+        uint8_t *address;
+
+        // Receiver-cache of virtual and interface invoke-instructions
+        InlineCache *inline_cache;
+
+        CacheEntry() : index(0), resolved(false), clazz(0), field(0),
+                       method(0), offset(0), address(0), inline_cache(0) { }
+
+        ~CacheEntry() { DELETE_OBJECT(inline_cache) }
+    };
+
+    // Translates the bytecode of a method into the instruction-stream,
+    // that is executed by the interpreter. The translated code has the same
+    // layout as the bytecode, so program-counters, exception-tables and
+    // line-numbers stay valid, but:
+    // - all operands are stored in native byte-order,
+    // - constant-pool indices are replaced by indices into the cache-entries
+    //   of the method (ldc gets an 8-bit cache-index) and
+    // - pop2- and dup-instructions on long and double operands are replaced
+    //   by the ones moving single operands and
+    // - the first instruction of each sequence with a superinstruction is
+    //   replaced by the superinstruction.
+    class Translator
+    {
+    public:
+
+        // Translates the method, if it is not translated yet.
+        static error_t translate(Method *method);
+
+        // Returns the quick field-instruction for the field-type,
+        // based on the byte-variant of the instruction.
+        static uint8_t quick_field_instruction(uint8_t byteInstruction,
+            Type type);
+
+        // Returns the length of the bytecode-instruction
+        // at the program-counter.
+        static uint32_t instruction_length(const uint8_t *code, uint32_t pc);
+
+    private:
+
+        // Serializes translations
+        static Mutex _mutex;
+
+        // Replaces the first instruction of the sequences in the code,
+        // for which a superinstruction exists.
+        static void fuse_superinstructions(Method *method, uint8_t *code);
+
+        // Returns the instruction, that executes the bytecode-instruction
+        // at the program-counter after its first execution.
+        static uint8_t executed_instruction(Method *method, uint32_t pc);
+    };
+
+    // Replaces an instruction of translated code. Other threads may execute
+    // the instruction concurrently, so everything the new instruction
+    // reads must be written before.
+    inline void rewrite_instruction(uint8_t *code, uint8_t instruction)
+    {
+        std::atomic_thread_fence(std::memory_order_release);
+        *code = instruction;
+    }
+
+    // Reads a big-endian operand of the bytecode.
+    inline uint16_t read_bytecode_u16(const uint8_t *code)
+    {
+        return (code[0] << 8) | code[1];
+    }
+
+    inline int32_t read_bytecode_s32(const uint8_t *code)
+    {
+        return (code[0] << 24) | (code[1] << 16) | (code[2] << 8) | code[3];
+    }
+
+    // Reads a native-endian operand of translated code.
+    template<typename T>
+    inline T read_operand(const uint8_t *code)
+    {
+        T value;
+        memcpy(&value, code, sizeof(T));
+        return value;
+    }
+
+    // Writes a native-endian operand into translated code.
+    template<typename T>
+    inline void write_operand(uint8_t *code, T value)
+    {
+        memcpy(code, &value, sizeof(T));
+    }
+
+}
+
+#endif
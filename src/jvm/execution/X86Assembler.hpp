@@ -0,0 +1,445 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_EXECUTION_X86ASSEMBLER_HPP_
+#define COLDSPOT_JVM_EXECUTION_X86ASSEMBLER_HPP_
+
+#include <cstdint>
+#include <cstring>
+
+#include <jvm/common/Memory.hpp>
+
+namespace coldspot
+{
+
+    // General purpose registers of x86-64.
+    enum X86Register
+    {
+        RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+        R8, R9, R10, R11, R12, R13, R14, R15
+    };
+
+    // Condition codes of jcc and setcc.
+    enum X86Condition
+    {
+        CONDITION_EQUAL = 0x4,
+        CONDITION_NOT_EQUAL = 0x5,
+        CONDITION_ABOVE_EQUAL = 0x3,
+        CONDITION_LESS = 0xC,
+        CONDITION_GREATER_EQUAL = 0xD,
+        CONDITION_LESS_EQUAL = 0xE,
+        CONDITION_GREATER = 0xF
+    };
+
+    // Emits the x86-64 instructions used by the template-compiler into a
+    // growing buffer. Memory operands are always encoded as base-register
+    // with a 32-bit displacement.
+    class X86Assembler
+    {
+    public:
+
+        X86Assembler() : _buffer(new uint8_t[256]), _size(0), _capacity(256)
+        {
+        }
+
+        ~X86Assembler() { DELETE_ARRAY(_buffer) }
+
+        X86Assembler(const X86Assembler &other) = delete;
+        X86Assembler &operator=(const X86Assembler &other) = delete;
+
+        // Getters.
+        const uint8_t *buffer() const { return _buffer; }
+        uint32_t size() const { return _size; }
+
+        // Overwrites the 32-bit displacement of a jump at the position.
+        void patch_jump(uint32_t position, uint32_t target)
+        {
+            int32_t displacement = (int32_t) (target - (position + 4));
+            memcpy(&_buffer[position], &displacement, 4);
+        }
+
+        // Moves between registers and memory.
+        void load64(X86Register reg, X86Register base, int32_t displacement)
+        {
+            memory(true, 0x8B, reg, base, displacement);
+        }
+
+        void load32(X86Register reg, X86Register base, int32_t displacement)
+        {
+            memory(false, 0x8B, reg, base, displacement);
+        }
+
+        void load_sign_extend32(X86Register reg, X86Register base,
+            int32_t displacement)
+        {
+            memory(true, 0x63, reg, base, displacement);
+        }
+
+        void load_sign_extend16(X86Register reg, X86Register base,
+            int32_t displacement)
+        {
+            memory(true, 0x0FBF, reg, base, displacement);
+        }
+
+        void load_zero_extend16(X86Register reg, X86Register base,
+            int32_t displacement)
+        {
+            memory(true, 0x0FB7, reg, base, displacement);
+        }
+
+        void load_sign_extend8(X86Register reg, X86Register base,
+            int32_t displacement)
+        {
+            memory(true, 0x0FBE, reg, base, displacement);
+        }
+
+        void store64(X86Register base, int32_t displacement, X86Register reg)
+        {
+            memory(true, 0x89, reg, base, displacement);
+        }
+
+        void store32(X86Register base, int32_t displacement, X86Register reg)
+        {
+            memory(false, 0x89, reg, base, displacement);
+        }
+
+        void store16(X86Register base, int32_t displacement, X86Register reg)
+        {
+            emit(0x66);
+            memory(false, 0x89, reg, base, displacement);
+        }
+
+        // Only the low bytes of rax, rcx, rdx and rbx are addressable
+        void store8(X86Register base, int32_t displacement, X86Register reg)
+        {
+            memory(false, 0x88, reg, base, displacement);
+        }
+
+        // Stores the sign-extended immediate into a quad-word.
+        void store_immediate64(X86Register base, int32_t displacement,
+            int32_t immediate)
+        {
+            memory(true, 0xC7, RAX, base, displacement);
+            emit32(immediate);
+        }
+
+        void store_immediate32(X86Register base, int32_t displacement,
+            int32_t immediate)
+        {
+            memory(false, 0xC7, RAX, base, displacement);
+            emit32(immediate);
+        }
+
+        void store_immediate8(X86Register base, int32_t displacement,
+            uint8_t immediate)
+        {
+            memory(false, 0xC6, RAX, base, displacement);
+            emit(immediate);
+        }
+
+        void store_immediate16(X86Register base, int32_t displacement,
+            int16_t immediate)
+        {
+            emit(0x66);
+            memory(false, 0xC7, RAX, base, displacement);
+            emit(immediate & 0xFF);
+            emit((immediate >> 8) & 0xFF);
+        }
+
+        void move_immediate64(X86Register reg, uint64_t immediate)
+        {
+            emit(0x48 | ((reg & 8) >> 3));
+            emit(0xB8 | (reg & 7));
+            emit32((uint32_t) immediate);
+            emit32((uint32_t) (immediate >> 32));
+        }
+
+        void move64(X86Register destination, X86Register source)
+        {
+            registers(true, 0x89, source, destination);
+        }
+
+        // Extensions between registers.
+        void sign_extend32(X86Register destination, X86Register source)
+        {
+            registers(true, 0x63, destination, source);
+        }
+
+        void sign_extend16(X86Register destination, X86Register source)
+        {
+            registers(false, 0x0FBF, destination, source);
+        }
+
+        void zero_extend16(X86Register destination, X86Register source)
+        {
+            registers(false, 0x0FB7, destination, source);
+        }
+
+        void sign_extend8(X86Register destination, X86Register source)
+        {
+            registers(true, 0x0FBE, destination, source);
+        }
+
+        // Arithmetic on registers, 32- or 64-bit wide.
+        void add(bool wide, X86Register destination, X86Register source)
+        {
+            registers(wide, 0x01, source, destination);
+        }
+
+        void sub(bool wide, X86Register destination, X86Register source)
+        {
+            registers(wide, 0x29, source, destination);
+        }
+
+        void sub8(X86Register destination, X86Register source)
+        {
+            registers(false, 0x28, source, destination);
+        }
+
+        void and_(bool wide, X86Register destination, X86Register source)
+        {
+            registers(wide, 0x21, source, destination);
+        }
+
+        void or_(bool wide, X86Register destination, X86Register source)
+        {
+            registers(wide, 0x09, source, destination);
+        }
+
+        void xor_(bool wide, X86Register destination, X86Register source)
+        {
+            registers(wide, 0x31, source, destination);
+        }
+
+        void imul(bool wide, X86Register destination, X86Register source)
+        {
+            registers(wide, 0x0FAF, destination, source);
+        }
+
+        // Divides rdx:rax by the register, quotient in rax, remainder in rdx.
+        void idiv(bool wide, X86Register divisor)
+        {
+            // cdq or cqo
+            if (wide)
+            {
+                emit(0x48);
+            }
+            emit(0x99);
+            registers(wide, 0xF7, (X86Register) 7, divisor);
+        }
+
+        void neg(bool wide, X86Register reg)
+        {
+            registers(wide, 0xF7, (X86Register) 3, reg);
+        }
+
+        // Shifts by cl.
+        void shl(bool wide, X86Register reg)
+        {
+            registers(wide, 0xD3, (X86Register) 4, reg);
+        }
+
+        void shr(bool wide, X86Register reg)
+        {
+            registers(wide, 0xD3, (X86Register) 5, reg);
+        }
+
+        void sar(bool wide, X86Register reg)
+        {
+            registers(wide, 0xD3, (X86Register) 7, reg);
+        }
+
+        void shl_immediate(bool wide, X86Register reg, uint8_t count)
+        {
+            registers(wide, 0xC1, (X86Register) 4, reg);
+            emit(count);
+        }
+
+        void shr_immediate(bool wide, X86Register reg, uint8_t count)
+        {
+            registers(wide, 0xC1, (X86Register) 5, reg);
+            emit(count);
+        }
+
+        // The immediate is sign-extended to a quad-word.
+        void and_immediate(bool wide, X86Register reg, int32_t immediate)
+        {
+            registers(wide, 0x81, (X86Register) 4, reg);
+            emit32(immediate);
+        }
+
+        void add_immediate(bool wide, X86Register reg, int32_t immediate)
+        {
+            registers(wide, 0x81, (X86Register) 0, reg);
+            emit32(immediate);
+        }
+
+        // Comparisons.
+        void cmp(bool wide, X86Register first, X86Register second)
+        {
+            registers(wide, 0x39, second, first);
+        }
+
+        void cmp_immediate(bool wide, X86Register reg, int8_t immediate)
+        {
+            registers(wide, 0x83, (X86Register) 7, reg);
+            emit((uint8_t) immediate);
+        }
+
+        void cmp_memory32(X86Register reg, X86Register base, int32_t displacement)
+        {
+            memory(false, 0x3B, reg, base, displacement);
+        }
+
+        void cmp_memory8_zero(X86Register base, int32_t displacement)
+        {
+            memory(false, 0x80, (X86Register) 7, base, displacement);
+            emit(0);
+        }
+
+        void test(bool wide, X86Register first, X86Register second)
+        {
+            registers(wide, 0x85, second, first);
+        }
+
+        void setcc(X86Condition condition, X86Register reg)
+        {
+            registers(false, 0x0F90 | condition, RAX, reg);
+        }
+
+        // Jumps with a 32-bit displacement, returning its position.
+        uint32_t jmp()
+        {
+            emit(0xE9);
+            return emit_displacement();
+        }
+
+        uint32_t jcc(X86Condition condition)
+        {
+            emit(0x0F);
+            emit(0x80 | condition);
+            return emit_displacement();
+        }
+
+        void jmp(X86Register reg)
+        {
+            registers(false, 0xFF, (X86Register) 4, reg);
+        }
+
+        // Stack and returns.
+        void push(X86Register reg)
+        {
+            if (reg & 8)
+            {
+                emit(0x41);
+            }
+            emit(0x50 | (reg & 7));
+        }
+
+        void pop(X86Register reg)
+        {
+            if (reg & 8)
+            {
+                emit(0x41);
+            }
+            emit(0x58 | (reg & 7));
+        }
+
+        void ret()
+        {
+            emit(0xC3);
+        }
+
+    private:
+
+        uint8_t *_buffer;
+        uint32_t _size;
+        uint32_t _capacity;
+
+        void emit(uint8_t byte)
+        {
+            if (_size == _capacity)
+            {
+                uint8_t *buffer = new uint8_t[_capacity * 2];
+                memcpy(buffer, _buffer, _size);
+                DELETE_ARRAY(_buffer)
+                _buffer = buffer;
+                _capacity *= 2;
+            }
+            _buffer[_size++] = byte;
+        }
+
+        void emit32(uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                emit((uint8_t) (value >> (i * 8)));
+            }
+        }
+
+        uint32_t emit_displacement()
+        {
+            uint32_t position = _size;
+            emit32(0);
+            return position;
+        }
+
+        // Emits the rex-prefix, if needed, and the one- or two-byte opcode.
+        void prefix_opcode(bool wide, uint16_t opcode, uint8_t reg,
+            uint8_t rm)
+        {
+            uint8_t rex = 0x40 | (wide ? 0x08 : 0) | ((reg & 8) >> 1) |
+                          ((rm & 8) >> 3);
+            if (rex != 0x40)
+            {
+                emit(rex);
+            }
+            if (opcode > 0xFF)
+            {
+                emit(opcode >> 8);
+            }
+            emit(opcode & 0xFF);
+        }
+
+        void registers(bool wide, uint16_t opcode, X86Register reg, X86Register rm)
+        {
+            prefix_opcode(wide, opcode, reg, rm);
+            emit(0xC0 | ((reg & 7) << 3) | (rm & 7));
+        }
+
+        void memory(bool wide, uint16_t opcode, X86Register reg, X86Register base,
+            int32_t displacement)
+        {
+            prefix_opcode(wide, opcode, reg, base);
+            emit(0x80 | ((reg & 7) << 3) | (base & 7));
+
+            // Rsp and r12 as base need a sib-byte
+            if ((base & 7) == 4)
+            {
+                emit(0x24);
+            }
+            emit32((uint32_t) displacement);
+        }
+    };
+
+}
+
+#endif
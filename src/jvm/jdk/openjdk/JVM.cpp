@@ -82,7 +82,7 @@ JNIEXPORT void JNICALL JVM_MonitorWait(JNIEnv *env, jobject obj, jlong ms)
 {
   if (obj)
   {
-    obj->ensure_monitor()->wait(ms);
+    obj->monitor_wait(ms);
   }
 }
 
@@ -91,7 +91,7 @@ JNIEXPORT void JNICALL JVM_MonitorNotify(JNIEnv *env, jobject obj)
 {
   if (obj)
   {
-    obj->ensure_monitor()->notify();
+    obj->monitor_notify();
   }
 }
 
@@ -100,7 +100,7 @@ JNIEXPORT void JNICALL JVM_MonitorNotifyAll(JNIEnv *env, jobject obj)
 {
   if (obj)
   {
-    obj->ensure_monitor()->notify_all();
+    obj->monitor_notify_all();
   }
 }
 
@@ -255,8 +255,7 @@ JNIEXPORT jlong JNICALL JVM_MaxMemory()
 
 JNIEXPORT jint JNICALL JVM_ActiveProcessorCount()
 {
-  LOG_ERROR("ignoring JVM_ActiveProcessorCount")
-  return 0;
+  return (jint) System::processorCount();
 }
 
 
@@ -444,7 +443,18 @@ JNIEXPORT void JNICALL JVM_Yield(JNIEnv *env, jclass threadClass)
 
 JNIEXPORT void JNICALL JVM_Sleep(JNIEnv *env, jclass threadClass, jlong millis)
 {
-  System::sleep(millis);
+  if (millis < 0)
+  {
+    _current_executor->throw_exception(CLASSNAME_ILLEGALARGUMENTEXCEPTION,
+      "timeout value is negative");
+    return;
+  }
+
+  if (!_current_thread->sleep(millis))
+  {
+    _current_executor->throw_exception(CLASSNAME_INTERRUPTEDEXCEPTION,
+      "sleep interrupted");
+  }
 }
 
 
@@ -471,15 +481,24 @@ JNIEXPORT jint JNICALL JVM_CountStackFrames(JNIEnv *env, jobject threadObj)
 
 JNIEXPORT void JNICALL JVM_Interrupt(JNIEnv *env, jobject thread)
 {
-  LOG_ERROR("ignoring JVM_Interrupt")
+  VMThread *vmThread = VMThread::from_object(thread);
+  if (vmThread != 0)
+  {
+    vmThread->interrupt();
+  }
 }
 
 
 JNIEXPORT jboolean JNICALL JVM_IsInterrupted(JNIEnv *env, jobject thread,
   jboolean clearInterrupted)
 {
-  LOG_ERROR("ignoring JVM_IsInterrupted")
-  return false;
+  VMThread *vmThread = VMThread::from_object(thread);
+  if (vmThread == 0)
+  {
+    return false;
+  }
+
+  return vmThread->is_interrupted(clearInterrupted);
 }
 
 
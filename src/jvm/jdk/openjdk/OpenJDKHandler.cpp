@@ -322,8 +322,8 @@ namespace coldspot
                                        {(char *) "putOrderedInt",          (char *) "(Ljava/lang/Object;JI)V",                                                                         (void *) &Unsafe_putInt_object},
                                        {(char *) "putOrderedLong",         (char *) "(Ljava/lang/Object;JJ)V",                                                                         (void *) &Unsafe_putLong_object},
 
-                                       {(char *) "unpark",                 (char *) "(Ljava/lang/Object;)V",                                                                           (void *) 0},
-                                       {(char *) "park",                   (char *) "(ZJ)V",                                                                                           (void *) 0},
+                                       {(char *) "unpark",                 (char *) "(Ljava/lang/Object;)V",                                                                           (void *) &Unsafe_unpark},
+                                       {(char *) "park",                   (char *) "(ZJ)V",                                                                                           (void *) &Unsafe_park},
                                        {(char *) "getLoadAverage",         (char *) "([DI)I",                                                                                          (void *) 0},};
     env->RegisterNatives(unsafeClass, unsafeMethods,
       METHOD_COUNT(unsafeMethods));
@@ -64,15 +64,53 @@ void set_value(jobject object, jlong offset, T value)
 }
 
 
+template<typename T>
+T *value_address(jobject object, jlong offset)
+{
+  if (static_bit_set(offset))
+  {
+    return (T *) (Class::from_class_object(object)->static_memory +
+                  (offset & ~STATIC_BIT));
+  }
+  else
+  {
+    return (T *) (object->memory() + offset);
+  }
+}
+
+
 template<typename T>
 jboolean Unsafe_compareAndSwap(jobject obj, jlong offset, T expected, T x)
 {
-  if (get_value<T>(obj, offset) == expected)
+  bool swapped = __atomic_compare_exchange_n(value_address<T>(obj, offset),
+    &expected, x, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+  return swapped ? JNI_TRUE : JNI_FALSE;
+}
+
+
+// References of objects need the barriers of the collector, the previous
+// value is the expected one if the swap succeeds
+template<>
+jboolean Unsafe_compareAndSwap<jobject>(jobject obj, jlong offset,
+  jobject expected, jobject x)
+{
+  bool field = !static_bit_set(offset);
+  if (field)
   {
-    set_value(obj, offset, x);
+    HeapSpace::pre_write_barrier(expected);
   }
 
-  return JNI_TRUE;
+  bool swapped = __atomic_compare_exchange_n(
+    value_address<jobject>(obj, offset), &expected, x, false,
+    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+
+  if (swapped && field)
+  {
+    HeapSpace::write_barrier(obj);
+  }
+
+  return swapped ? JNI_TRUE : JNI_FALSE;
 }
 
 
@@ -260,7 +298,7 @@ void Unsafe_ensureClassInitialized(JNIEnv *env, jobject self, jclass classObj)
   {
     Class *clazz = Class::from_class_object(classObj);
 
-    if (!clazz->initialized)
+    if (!clazz->is_initialized())
     {
       _vm->class_loader()->initialize_class(clazz);
     }
@@ -270,9 +308,9 @@ void Unsafe_ensureClassInitialized(JNIEnv *env, jobject self, jclass classObj)
 
 void Unsafe_monitorEnter(JNIEnv *env, jobject self, jobject obj)
 {
-  if (obj == 0)
+  if (obj != 0)
   {
-    obj->ensure_monitor()->enter();
+    obj->monitor_enter();
   }
 }
 
@@ -281,7 +319,7 @@ void Unsafe_monitorExit(JNIEnv *env, jobject self, jobject obj)
 {
   if (obj != 0)
   {
-    obj->ensure_monitor()->exit();
+    obj->monitor_exit();
   }
 }
 
@@ -293,7 +331,7 @@ jboolean Unsafe_tryMonitorEnter(JNIEnv *env, jobject self, jobject obj)
     LOG_WARN("Unsafe_tryMonitorEnter - invalid parameter")
   }
 
-  return obj->ensure_monitor()->try_enter();
+  return obj->monitor_try_enter();
 }
 
 
@@ -306,6 +344,30 @@ void Unsafe_throwException(JNIEnv *env, jobject self, jthrowable exception)
 }
 
 
+void Unsafe_park(JNIEnv *env, jobject self, jboolean absolute, jlong time)
+{
+  // Parked threads execute a native frame and are not runnable,
+  // so they do not delay the suspension for the garbage collector
+  _current_thread->park(absolute, time);
+}
+
+
+void Unsafe_unpark(JNIEnv *env, jobject self, jobject threadObj)
+{
+  if (threadObj == 0)
+  {
+    return;
+  }
+
+  // Threads that are not started yet have nothing to wake
+  VMThread *thread = VMThread::from_object(threadObj);
+  if (thread != 0)
+  {
+    thread->unpark();
+  }
+}
+
+
     #define COMPARE_AND_SWAP(name, type) \
     jboolean Unsafe_compareAndSwap##name(JNIEnv *env, jobject self, jobject obj, \
       jlong offset, type expected, type x) \
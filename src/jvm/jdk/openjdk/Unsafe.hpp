@@ -116,6 +116,9 @@ jboolean Unsafe_tryMonitorEnter(JNIEnv *env, jobject self, jobject obj);
 
 void Unsafe_throwException(JNIEnv *env, jobject self, jthrowable exception);
 
+void Unsafe_park(JNIEnv *env, jobject self, jboolean absolute, jlong time);
+void Unsafe_unpark(JNIEnv *env, jobject self, jobject threadObj);
+
 jboolean Unsafe_compareAndSwapObject(JNIEnv *env, jobject self, jobject obj,
     jlong offset, jobject expected, jobject x);
 jboolean Unsafe_compareAndSwapInt(JNIEnv *env, jobject self, jobject obj,
@@ -1368,7 +1368,7 @@ jobject obj
 if (obj != 0)
 {
 obj->
-ensure_monitor() -> enter();
+monitor_enter();
 return 0;
 }
 
@@ -1384,7 +1384,7 @@ jobject obj
 {
 if (obj != 0)
 {
-error_t errorValue = obj->ensure_monitor()->exit();
+error_t errorValue = obj->monitor_exit();
 if (errorValue == RETURN_OK)
 {
 return
@@ -1693,7 +1693,7 @@ JavaVMInitArgs *initArgs = (JavaVMInitArgs *) v_args;
 // Iterate options
 for (
 jint i = 0;
-i < 0; ++i)
+i<initArgs->nOptions; ++i)
 {
 // Current option and skip '-'
 char *option = ++initArgs->options[i].optionString;
@@ -1712,6 +1712,62 @@ strcmp(option,
 {
 options->
 verboseExecute = true;
+}
+else if (
+strcmp(option,
+"interp:threaded") == 0)
+{
+options->
+threadedInterpreter = true;
+}
+else if (
+strcmp(option,
+"interp:switch") == 0)
+{
+options->
+threadedInterpreter = false;
+}
+else if (
+strcmp(option,
+"int") == 0)
+{
+options->
+interpretOnly = true;
+}
+else if (
+strcmp(option,
+"prof") == 0)
+{
+options->
+profileMethods = true;
+}
+else if (
+strcmp(option,
+"prof:inlinecaches") == 0)
+{
+options->
+profileInlineCaches = true;
+}
+else if (
+strcmp(option,
+"prof:ngrams") == 0)
+{
+options->
+profileNGrams = true;
+}
+else if (
+strncmp(option,
+"X:ParallelGCThreads=", 20) == 0)
+{
+options->
+parallelGCThreads = (uint32_t) atoi(option + 20);
+}
+else if (
+strcmp(option,
+"X:+UseConcMarkSweepGC") == 0)
+{
+options->
+concurrentGC = true;
 }}
 // Set system property
 else if (option[0] == 'D')
@@ -1804,3 +1860,11 @@ nVMs = 1;
 return
 JNI_OK;
 }
+
+
+jint JNICALL
+ColdSpot_PrintProfile(JNIEnv *env)
+{
+MethodProfiler::print_statistics(_vm->class_loader());
+return JNI_OK;
+}
@@ -939,6 +939,11 @@ void *args ) ;
 jint JNICALL
 JNI_GetCreatedJavaVMs(JavaVM * * , jsize , jsize * ) ;
 
+// Prints the profile of the hot methods (see -Xprof) on demand,
+// for native code of applications and embedders.
+jint JNICALL
+ColdSpot_PrintProfile(JNIEnv *env);
+
 }
 
 #endif
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    ConcurrentGarbageCollector::ConcurrentGarbageCollector(
+        HeapSpace *heap_space) : SimpleGarbageCollector(heap_space, 1),
+                                 _worker(0, 0)
+    {
+    }
+
+
+    void ConcurrentGarbageCollector::collectGarbage()
+    {
+        initial_mark();
+
+        // Mark while the threads are running, take the recorded objects of
+        // full queues along
+        drain_worker();
+        SatbQueue::drain_global(_worker);
+        drain_worker();
+
+        remark();
+
+        // Release or finalize unused objects
+        sweep();
+
+        // Remove all finalized objects
+        removeFinalizedObjects();
+
+        // Threads may create large regions at any time, so the space of
+        // released objects is made available again in a short pause
+        auto &threads = _vm->threads();
+        threads.lock();
+        _vm->suspend_vm_threads();
+
+        _heap_space->reclaim_regions();
+
+        _vm->resume_vm_threads();
+        threads.unlock();
+
+        _regions.clear();
+    }
+
+
+    bool ConcurrentGarbageCollector::is_live(Object *object)
+    {
+        return HeapSpace::is_marked(object) ||
+               !HeapRegion::of(object)->is_old(object);
+    }
+
+
+    void ConcurrentGarbageCollector::initial_mark()
+    {
+        HeapSpace &heapSpace = *_heap_space;
+        auto &threads = _vm->threads();
+
+        // Prevent creating or deleting threads during the pause
+        threads.lock();
+
+        // Suspend all threads
+        _vm->suspend_vm_threads();
+
+        heapSpace.clear_marks();
+
+        // Objects allocated from now on are young and survive the cycle
+        heapSpace.promote();
+
+        heapSpace.mutex().lock();
+        for (auto region : heapSpace.regions())
+        {
+            _regions.addBack(region);
+        }
+        heapSpace.mutex().unlock();
+
+        // Threads record the references they overwrite from now on
+        _satb_active.store(true);
+
+        // Only the roots are marked in the pause
+        List<RootTask *> tasks;
+        add_root_tasks(tasks);
+        for (auto task : tasks)
+        {
+            task->scan(_worker);
+            delete task;
+        }
+
+        // Resume all threads
+        _vm->resume_vm_threads();
+
+        threads.unlock();
+    }
+
+
+    void ConcurrentGarbageCollector::remark()
+    {
+        auto &threads = _vm->threads();
+
+        // Prevent creating or deleting threads during the pause
+        threads.lock();
+
+        // Suspend all threads
+        _vm->suspend_vm_threads();
+
+        // Everything recorded was reachable at the initial mark. The
+        // stopped threads handed their queues to the global list, native
+        // code records into it until the marking is complete.
+        bool drained;
+        do
+        {
+            drained = SatbQueue::drain_global(_worker);
+            drain_worker();
+        }
+        while (drained);
+
+        _satb_active.store(false);
+
+        // Delete threads that are terminated
+        deleteTerminatedVMThreads();
+
+        // Resume all threads
+        _vm->resume_vm_threads();
+
+        threads.unlock();
+    }
+
+
+    void ConcurrentGarbageCollector::sweep()
+    {
+        auto &target = _vm->finalizer_thread()->finalizer()->in_objects();
+
+        // Unmarked old objects are unreachable, nobody else touches them
+        List<Object *> finalizable;
+        for (auto region : _regions)
+        {
+            for (Object *object = region->first_old_object(); object != 0;
+                 object = region->next_old_object(object))
+            {
+                if (!HeapSpace::is_marked(object) && !object->finalizing() &&
+                    object->type()->finalizable)
+                {
+                    finalizable.addBack(object);
+                }
+            }
+        }
+
+        // Objects stay in place until the finalizer is done, so do the
+        // objects they reference. The finalizer takes them afterwards.
+        target.lock();
+        for (auto object : finalizable)
+        {
+            object->set_finalizing(true);
+            _worker.mark(object);
+            target->addBack(object);
+        }
+        drain_worker();
+        target.unlock();
+
+        // Release the other unused objects
+        for (auto region : _regions)
+        {
+            Object *object = region->first_old_object();
+            while (object != 0)
+            {
+                Object *next = region->next_old_object(object);
+                if (!HeapSpace::is_marked(object) && !object->finalizing())
+                {
+                    _vm->memory_manager()->release_object(object);
+                }
+                object = next;
+            }
+        }
+    }
+
+
+    void ConcurrentGarbageCollector::drain_worker()
+    {
+        while (true)
+        {
+            _worker.drain();
+
+            if (!_worker.take_overflow())
+            {
+                break;
+            }
+
+            // Dropped objects are marked, but their references may not
+            for (auto region : _regions)
+            {
+                for (Object *object = region->first_old_object(); object != 0;
+                     object = region->next_old_object(object))
+                {
+                    if (HeapSpace::is_marked(object))
+                    {
+                        scan_references(object, _worker);
+                    }
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_MEMORY_CONCURRENTGARBAGECOLLECTOR_HPP_
+#define COLDSPOT_JVM_MEMORY_CONCURRENTGARBAGECOLLECTOR_HPP_
+
+#include "ParallelMarker.hpp"
+#include "SimpleGarbageCollector.hpp"
+
+namespace coldspot
+{
+
+    class HeapRegion;
+
+    // Marks and sweeps the whole heap-space while the threads are running.
+    // Only the roots are marked in a pause (initial mark), the threads
+    // record the references they overwrite afterwards, so everything
+    // reachable at that time is marked (snapshot-at-the-beginning). A
+    // second pause marks the recorded objects (remark). Objects allocated
+    // meanwhile lie above the old top of their region and survive.
+    class ConcurrentGarbageCollector : public SimpleGarbageCollector
+    {
+    public:
+
+        ConcurrentGarbageCollector(HeapSpace *heap_space);
+
+        void collectGarbage() override;
+
+    protected:
+
+        bool is_live(Object *object) override;
+
+    private:
+
+        // Takes the snapshot and marks the roots.
+        void initial_mark();
+
+        // Marks the recorded objects and the remaining grey ones.
+        void remark();
+
+        // Releases the unmarked old objects, objects with a finalize-method
+        // are handed to the finalizer instead.
+        void sweep();
+
+        // Scans the grey objects, the marked old objects are scanned again
+        // after grey objects were dropped.
+        void drain_worker();
+
+        GCWorker _worker;
+
+        // Regions of the snapshot, later regions hold only young objects
+        List<HeapRegion *> _regions;
+    };
+
+}
+
+#endif
@@ -43,6 +43,7 @@ namespace coldspot
         // Getters.
         Lockable <List<Object *>> &in_objects() { return _in_objects; }
         Lockable <List<Object *>> &out_objects() { return _out_objects; }
+        List<Object *> &current_objects() { return _current_objects; }
 
     protected:
 
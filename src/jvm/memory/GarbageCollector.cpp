@@ -24,77 +24,98 @@
 namespace coldspot
 {
 
-    error_t GarbageCollector::mark_unused(Object *object)
+    void GarbageCollector::mark(Object *object)
     {
-        if (object != 0 && object->used())
+        if (object != 0 && HeapSpace::try_mark(object))
         {
-            object->set_used(false);
+            _mark_stack.push(object);
         }
-
-        return RETURN_OK;
     }
 
 
     error_t GarbageCollector::mark_used(Object *object)
     {
-        if (object != 0 && !object->used())
-        {
-            object->set_used(true);
+        mark(object);
+        drain();
 
-            // Mark class-loader
-            mark_used(object->type()->class_loader);
+        return RETURN_OK;
+    }
 
-            // Mark class-object
-            mark_used(object->type()->object);
 
-            auto &declared_fields = object->type()->declared_fields;
+    template<typename Marker>
+    void GarbageCollector::scan_references(Object *object, Marker &marker)
+    {
+        Class *type = object->type();
 
-            for (uint16_t i = 0; i < declared_fields.length(); ++i)
-            {
-                auto declared_field = declared_fields[i];
+        // Mark class-loader
+        marker.mark(type->class_loader);
 
-                if (!declared_field->type()->is_primitive())
-                {
-                    Object *value = declared_field->get<Object *>(object);
-                    error_t error_value = mark_used(value);
-                    RETURN_ON_FAIL(error_value);
-                }
-            }
+        // Mark class-object
+        marker.mark(type->object);
+
+        // Mark the reference fields of the whole hierarchy
+        uint8_t *memory = object->memory();
+        auto &offsets = type->reference_offsets;
+        for (uint16_t i = 0; i < offsets.length(); ++i)
+        {
+            marker.mark(*(Object **) (memory + offsets[i]));
+        }
 
-            // Special handling for arrays
-            if (object->type()->is_array())
+        // Mark the elements of arrays of references
+        if (type->reference_array)
+        {
+            Object **elements = (Object **) memory;
+            jint length = static_cast<Array *>(object)->length();
+            for (jint i = 0; i < length; ++i)
             {
-                return mark_array_used(static_cast<Array *>(object));
+                marker.mark(elements[i]);
             }
         }
-
-        return RETURN_OK;
     }
 
+    template void GarbageCollector::scan_references<GarbageCollector>(
+        Object *object, GarbageCollector &marker);
+    template void GarbageCollector::scan_references<GCWorker>(
+        Object *object, GCWorker &marker);
 
-    error_t GarbageCollector::mark_array_used(Array *array)
-    {
-        Class *clazz = array->type();
 
-        if (!clazz->component_type->is_primitive())
+    void GarbageCollector::rescan_marked()
+    {
+        _heap_space->mutex().lock();
+        for (auto region : _heap_space->regions())
         {
-            jint length = array->length();
-
-            for (jint i = 0; i < length; ++i)
+            for (Object *object = region->first_object(); object != 0;
+                 object = region->next_object(object))
             {
-                Object *value;
-                error_t errorValue = array->get_value<Object *>(i, &value);
-                RETURN_ON_FAIL(errorValue);
-
-                if (value != 0)
+                if (HeapSpace::is_marked(object))
                 {
-                    errorValue = mark_used(value);
-                    RETURN_ON_FAIL(errorValue);
+                    scan_references(object, *this);
                 }
             }
         }
+        _heap_space->mutex().unlock();
+    }
 
-        return RETURN_OK;
+
+    void GarbageCollector::drain()
+    {
+        do
+        {
+            while (!_mark_stack.empty())
+            {
+                scan_references(_mark_stack.pop(), *this);
+            }
+
+            if (!_mark_stack.take_overflow())
+            {
+                break;
+            }
+
+            // Dropped objects are marked, but their references may not,
+            // so all marked objects are scanned again
+            rescan_marked();
+        }
+        while (true);
     }
 
 }
@@ -24,6 +24,8 @@
 
 #include <jvm/Error.hpp>
 
+#include "MarkStack.hpp"
+
 namespace coldspot
 {
 
@@ -31,12 +33,16 @@ namespace coldspot
 
     class FinalizerThread;
 
+    class HeapSpace;
+
     class Object;
 
     class GarbageCollector
     {
     public:
 
+        GarbageCollector(HeapSpace *heap_space) : _heap_space(heap_space) { }
+
         virtual ~GarbageCollector()
         {
         }
@@ -48,22 +54,34 @@ namespace coldspot
         // but the finalizer
         virtual void collectGarbageForExit() = 0;
 
-    protected:
+        // Marks the objects referenced by the object through the marker.
+        template<typename Marker>
+        static void scan_references(Object *object, Marker &marker);
 
-        // Marks the object and all dependent objects as unused
-        // (super-object, fields, etc.).
-        error_t mark_unused(Object *object);
+    protected:
 
         // Marks the object and all dependent objects as used
         // (super-object, fields, etc.).
         error_t mark_used(Object *object);
 
+        // Pushes the references of all marked objects of the heap-space,
+        // after references of some of them were dropped.
+        void rescan_marked();
+
+        // Scans until the mark stack is empty. After an overflow the
+        // marked objects of the heap-space are scanned again.
+        void drain();
+
+        HeapSpace *_heap_space;
+
     private:
 
-        // Marks the array-object as used.
-        // If the component-type of the array-object is a reference-type,
-        // all fields will be also marked as used.
-        error_t mark_array_used(Array *array);
+        // Marks the object and pushes it for scanning.
+        inline void mark(Object *object);
+
+
+        // Objects that are marked but not scanned yet
+        MarkStack _mark_stack;
     };
 
 }
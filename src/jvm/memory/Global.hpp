@@ -22,11 +22,17 @@
 #ifndef COLDSPOT_JVM_MEMORY_GLOBAL_HPP_
 #define COLDSPOT_JVM_MEMORY_GLOBAL_HPP_
 
+#include "ConcurrentGarbageCollector.hpp"
 #include "Finalizer.hpp"
 #include "GarbageCollector.hpp"
+#include "HeapSpace.hpp"
+#include "MarkStack.hpp"
 #include "MemoryManager.hpp"
 #include "ObjectAllocator.hpp"
+#include "ParallelMarker.hpp"
+#include "SatbQueue.hpp"
 #include "SimpleFinalizer.hpp"
 #include "SimpleGarbageCollector.hpp"
+#include "WorkStealingDeque.hpp"
 
 #endif
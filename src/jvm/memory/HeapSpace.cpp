@@ -0,0 +1,517 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    // Unused memory is zeroed, a zero where the next object would start
+    // marks the end of the objects in a region
+    static bool is_allocated(const uint8_t *memory)
+    {
+        return *(const uintptr_t *) memory != 0;
+    }
+
+
+    static_assert(sizeof(HeapRegion) <= HeapRegion::CARDS_OFFSET,
+        "the header of a region overlaps its cards");
+
+
+    HeapRegion::HeapRegion(uint8_t *start, uint32_t size, uint32_t mark_words,
+        uint32_t reserved) : start(start), top(start), end(start + size),
+                             old_top(start), recorded_top(start),
+                             allocating(false), large(false),
+                             _cards((uint8_t *) this + CARDS_OFFSET),
+                             _marks((std::atomic<uint64_t> *) (_cards + CARDS)),
+                             _mark_words(mark_words), _reserved(reserved)
+    {
+        // The bitmap words live in the memory of the region
+        for (uint32_t i = 0; i < _mark_words; ++i)
+        {
+            new(&_marks[i]) std::atomic<uint64_t>(0);
+        }
+    }
+
+
+    HeapRegion *HeapRegion::create(uint32_t size, bool large)
+    {
+        // The bitmap of a large region has to cover only its object
+        uint32_t mark_words = large ? 1 : SIZE / 8 / 64;
+        uint32_t header = CARDS_OFFSET + CARDS + mark_words * 8;
+        uint32_t reserved = large ? header + size : SIZE;
+
+        uint8_t *memory = (uint8_t *) System::allocateAligned(reserved, SIZE);
+        if (memory == 0)
+        {
+            return 0;
+        }
+
+        return new(memory) HeapRegion(memory + header, reserved - header,
+            mark_words, reserved);
+    }
+
+
+    void HeapRegion::destroy(HeapRegion *region)
+    {
+        System::releaseAligned(region, region->_reserved);
+    }
+
+
+    void HeapRegion::clear_marks()
+    {
+        for (uint32_t i = 0; i < _mark_words; ++i)
+        {
+            _marks[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+
+    void HeapRegion::clear_marks(const uint8_t *from, const uint8_t *to)
+    {
+        uint32_t bit = (from - start) >> 3;
+        uint32_t last = (to - start) >> 3;
+        while (bit < last)
+        {
+            uint32_t shift = bit & 63;
+            uint32_t count = std::min(64 - shift, last - bit);
+            uint64_t mask = count == 64 ? ~(uint64_t) 0
+                                        : (((uint64_t) 1 << count) - 1) << shift;
+            _marks[bit >> 6].fetch_and(~mask, std::memory_order_relaxed);
+            bit += count;
+        }
+    }
+
+
+    void HeapRegion::trim()
+    {
+        uint8_t *last = start;
+        for (Object *object = first_object(); object != 0;
+             object = next_object(object))
+        {
+            last = (uint8_t *) object + HeapSpace::object_size(object);
+        }
+
+        if (last == top)
+        {
+            return;
+        }
+
+        // Buffers hand out zeroed memory, a stale mark would stop the
+        // marking at a new object
+        memset(last, 0, top - last);
+        clear_marks(last, top);
+        top = last;
+        if (old_top > top)
+        {
+            old_top = top;
+        }
+        if (recorded_top > top)
+        {
+            recorded_top = top;
+        }
+    }
+
+
+    bool HeapRegion::has_dirty_cards() const
+    {
+        if (old_top == start)
+        {
+            return false;
+        }
+
+        // Only the start of a large object lies in the first SIZE bytes
+        uint8_t *limit = (uint8_t *) this + SIZE;
+        if (old_top < limit)
+        {
+            limit = old_top;
+        }
+
+        uint32_t first = card_index((Object *) start);
+        uint32_t last = card_index((Object *) (limit - 1));
+        for (uint32_t i = first; i <= last; ++i)
+        {
+            if (_cards[i] != CARD_CLEAN)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    void HeapRegion::promote()
+    {
+        old_top = top;
+        memset(_cards, CARD_CLEAN, CARDS);
+    }
+
+
+    Object *HeapRegion::object_from(uint8_t *memory,
+        const uint8_t *limit) const
+    {
+        if (memory >= limit || !is_allocated(memory))
+        {
+            return 0;
+        }
+
+        Object *object = (Object *) memory;
+        if (object->type() == 0)
+        {
+            return next_object(object, limit);
+        }
+
+        return object;
+    }
+
+
+    Object *HeapRegion::next_object(Object *object, const uint8_t *limit) const
+    {
+        uint8_t *memory = (uint8_t *) object;
+        do
+        {
+            memory += HeapSpace::object_size((Object *) memory);
+            if (memory >= limit || !is_allocated(memory))
+            {
+                return 0;
+            }
+        }
+        while (((Object *) memory)->type() == 0);
+
+        return (Object *) memory;
+    }
+
+
+    Object *HeapRegion::first_object() const
+    {
+        return object_from(start, top);
+    }
+
+
+    Object *HeapRegion::first_young_object() const
+    {
+        return object_from(old_top, top);
+    }
+
+
+    Object *HeapRegion::next_object(Object *object) const
+    {
+        return next_object(object, top);
+    }
+
+
+    Object *HeapRegion::first_old_object() const
+    {
+        return object_from(start, old_top);
+    }
+
+
+    Object *HeapRegion::next_old_object(Object *object) const
+    {
+        return next_object(object, old_top);
+    }
+
+
+    Object *HeapRegion::first_recorded_object() const
+    {
+        return object_from(start, recorded_top);
+    }
+
+
+    Object *HeapRegion::first_young_recorded_object() const
+    {
+        return object_from(old_top, recorded_top);
+    }
+
+
+    Object *HeapRegion::next_recorded_object(Object *object) const
+    {
+        return next_object(object, recorded_top);
+    }
+
+
+    bool HeapRegion::is_empty() const
+    {
+        return first_object() == 0;
+    }
+
+
+    HeapSpace::~HeapSpace()
+    {
+        for (auto region : _regions)
+        {
+            for (Object *object = region->first_object(); object != 0;)
+            {
+                Object *next = region->next_object(object);
+                object->~Object();
+                object = next;
+            }
+
+            HeapRegion::destroy(region);
+        }
+
+        for (auto region : _free_regions)
+        {
+            HeapRegion::destroy(region);
+        }
+    }
+
+
+    uint32_t HeapSpace::object_size(const Object *object)
+    {
+        Class *type = object->type();
+        uint32_t header = type != 0 && type->is_array() ? sizeof(Array)
+                                                        : sizeof(Object);
+
+        return align(header + object->memory_size());
+    }
+
+
+    void HeapSpace::release(Object *object, uint32_t size)
+    {
+        // The filler keeps the region walkable
+        Object *filler = new(object) Object(0);
+        filler->set_memory_size(size - sizeof(Object));
+    }
+
+
+    void HeapSpace::clear_marks()
+    {
+        _mutex.lock();
+
+        for (auto region : _regions)
+        {
+            region->clear_marks();
+        }
+
+        _mutex.unlock();
+    }
+
+
+    void HeapSpace::record_tops()
+    {
+        _mutex.lock();
+
+        for (auto region : _regions)
+        {
+            region->recorded_top = region->top;
+        }
+
+        _mutex.unlock();
+    }
+
+
+    void HeapSpace::promote()
+    {
+        _mutex.lock();
+
+        for (auto region : _regions)
+        {
+            region->promote();
+        }
+
+        _mutex.unlock();
+    }
+
+
+    uint64_t HeapSpace::old_bytes()
+    {
+        _mutex.lock();
+
+        uint64_t bytes = 0;
+        for (auto region : _regions)
+        {
+            bytes += region->old_top - region->start;
+        }
+
+        _mutex.unlock();
+
+        return bytes;
+    }
+
+
+    void HeapSpace::retire_tlab(Thread *thread)
+    {
+        _mutex.lock();
+
+        HeapRegion *buffer = thread->tlab();
+        if (buffer != 0)
+        {
+            buffer->allocating = false;
+            thread->set_tlab(0);
+        }
+
+        _mutex.unlock();
+    }
+
+
+    void HeapSpace::reclaim_regions()
+    {
+        _mutex.lock();
+
+        _partial_regions.clear();
+
+        auto iterator = _regions.begin();
+        while (iterator != _regions.end())
+        {
+            HeapRegion *region = *iterator;
+            if (region->allocating || (region->large && !region->is_empty()))
+            {
+                ++iterator;
+                continue;
+            }
+
+            if (!region->large)
+            {
+                region->trim();
+                if (region->top != region->start)
+                {
+                    // The free end takes a buffer, if every small object
+                    // fits into it
+                    if ((uint32_t) (region->end - region->top) >=
+                        LARGE_OBJECT_SIZE)
+                    {
+                        _partial_regions.addBack(region);
+                    }
+
+                    ++iterator;
+                    continue;
+                }
+            }
+
+            iterator = _regions.erase(iterator);
+
+            if (region->large || _free_regions.size() >= FREE_REGIONS_KEPT)
+            {
+                HeapRegion::destroy(region);
+            }
+            else
+            {
+                region->promote();
+                _free_regions.addBack(region);
+            }
+        }
+
+        _mutex.unlock();
+    }
+
+
+    uint8_t *HeapSpace::allocate_slow(Thread *thread, uint32_t size)
+    {
+        _mutex.lock();
+
+        uint8_t *memory;
+        if (size > LARGE_OBJECT_SIZE)
+        {
+            // Large objects get a region of their own
+            HeapRegion *region = HeapRegion::create(size, true);
+            if (region == 0)
+            {
+                _mutex.unlock();
+                return 0;
+            }
+
+            memory = region->start;
+            region->top = region->end;
+            region->large = true;
+            _regions.addBack(region);
+            _allocated_bytes += size;
+        }
+        else
+        {
+            HeapRegion *buffer = thread != 0 ? thread->tlab()
+                                             : _shared_buffer;
+
+            if (buffer == 0 || (uint32_t) (buffer->end - buffer->top) < size)
+            {
+                // Keep the old buffer, if there is no other
+                HeapRegion *region = acquire_region();
+                if (region == 0)
+                {
+                    _mutex.unlock();
+                    return 0;
+                }
+
+                if (buffer != 0)
+                {
+                    buffer->allocating = false;
+                }
+
+                buffer = region;
+                buffer->allocating = true;
+                _allocated_bytes += buffer->end - buffer->top;
+
+                if (thread != 0)
+                {
+                    thread->set_tlab(buffer);
+                }
+                else
+                {
+                    _shared_buffer = buffer;
+                }
+            }
+
+            memory = buffer->top;
+            buffer->top += size;
+        }
+
+        _mutex.unlock();
+
+        return memory;
+    }
+
+
+    HeapRegion *HeapSpace::acquire_region()
+    {
+        // Regions with a free end are in the list of regions already
+        if (!_partial_regions.empty())
+        {
+            HeapRegion *region = _partial_regions.front();
+            _partial_regions.erase(_partial_regions.begin());
+            return region;
+        }
+
+        HeapRegion *region;
+        if (!_free_regions.empty())
+        {
+            region = _free_regions.front();
+            _free_regions.erase(_free_regions.begin());
+        }
+        else
+        {
+            region = HeapRegion::create(REGION_SIZE, false);
+            if (region == 0)
+            {
+                return 0;
+            }
+        }
+
+        _regions.addBack(region);
+
+        return region;
+    }
+
+}
@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_MEMORY_HEAPSPACE_HPP_
+#define COLDSPOT_JVM_MEMORY_HEAPSPACE_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+#include <jvm/common/List.hpp>
+#include <jvm/thread/Mutex.hpp>
+#include <jvm/thread/Thread.hpp>
+
+#include "SatbQueue.hpp"
+
+namespace coldspot
+{
+
+    class Object;
+
+    // A contiguous chunk of the heap-space. Objects are placed one after
+    // another from the start to the top, the memory above is zeroed.
+    // Released objects stay in place as fillers, the fillers at the end are
+    // cut off, so the free end can take a buffer again.
+    //
+    // The region is aligned to its size and starts with this header, the
+    // card table and the mark bitmap, one bit for each 8 bytes of objects.
+    // The region of an object is found by masking its address.
+    //
+    // Objects below the old top survived a collection and belong to the
+    // old generation, the objects above are young.
+    class HeapRegion
+    {
+    public:
+
+        static const uint32_t SIZE = 256 * 1024;
+
+        // A card covers 512 bytes of the region, it is dirtied if a
+        // reference is stored into an object that starts on it
+        static const uint32_t CARD_SHIFT = 9;
+        static const uint32_t CARDS = SIZE >> CARD_SHIFT;
+        static const uint32_t CARDS_OFFSET = 256;
+        static const uint8_t CARD_CLEAN = 0;
+        static const uint8_t CARD_DIRTY = 1;
+
+        // Creates a region of the size, a large region holds one object
+        // of the size and may exceed the size of regions.
+        static HeapRegion *create(uint32_t size, bool large);
+
+        // Releases the memory of the region.
+        static void destroy(HeapRegion *region);
+
+        // Returns the region of an object of the heap-space.
+        static HeapRegion *of(const Object *object)
+        {
+            uintptr_t address = (uintptr_t) object;
+            return (HeapRegion *) (address & ~(uintptr_t) (SIZE - 1));
+        }
+
+        // Sets the mark of the object atomically, returns false if it was
+        // already set.
+        bool mark(const Object *object)
+        {
+            uint32_t bit = ((const uint8_t *) object - start) >> 3;
+            uint64_t mask = (uint64_t) 1 << (bit & 63);
+            std::atomic<uint64_t> &word = _marks[bit >> 6];
+
+            if ((word.load(std::memory_order_relaxed) & mask) != 0)
+            {
+                return false;
+            }
+
+            return (word.fetch_or(mask, std::memory_order_relaxed) & mask)
+                   == 0;
+        }
+
+        bool is_marked(const Object *object) const
+        {
+            uint32_t bit = ((const uint8_t *) object - start) >> 3;
+            uint64_t mask = (uint64_t) 1 << (bit & 63);
+
+            return (_marks[bit >> 6].load(std::memory_order_relaxed)
+                    & mask) != 0;
+        }
+
+        // Clears the marks of all objects of the region.
+        void clear_marks();
+
+        // Cuts the fillers above the last object off, their memory is
+        // zeroed and their marks are cleared.
+        void trim();
+
+        // Dirties the card of the object, the compiled code does the same.
+        static void dirty_card(const Object *object)
+        {
+            uint8_t *cards = (uint8_t *) of(object) + CARDS_OFFSET;
+            cards[card_index(object)] = CARD_DIRTY;
+        }
+
+        bool is_card_dirty(const Object *object) const
+        {
+            return _cards[card_index(object)] != CARD_CLEAN;
+        }
+
+        // Returns true if a card of an old object is dirty.
+        bool has_dirty_cards() const;
+
+        // Makes all objects old and cleans the cards.
+        void promote();
+
+        // Walks the objects of the region, fillers are skipped.
+        Object *first_object() const;
+        Object *next_object(Object *object) const;
+
+        // Returns the first object of the young generation.
+        Object *first_young_object() const;
+
+        // Walks the objects of the old generation only, young objects may
+        // be allocated concurrently.
+        Object *first_old_object() const;
+        Object *next_old_object(Object *object) const;
+
+        // Walks the objects below the recorded top only, threads in native
+        // code may allocate above it during a collection.
+        Object *first_recorded_object() const;
+        Object *first_young_recorded_object() const;
+        Object *next_recorded_object(Object *object) const;
+
+        bool is_old(const Object *object) const
+        {
+            return (const uint8_t *) object < old_top;
+        }
+
+        // Returns true if the region holds no objects but fillers.
+        bool is_empty() const;
+
+        uint8_t *start;
+        uint8_t *top;
+        uint8_t *end;
+        uint8_t *old_top;
+
+        // Top at the start of the running collection
+        uint8_t *recorded_top;
+
+        // Buffer of a thread (TLAB), nobody else allocates from it
+        bool allocating;
+
+        // Holds a single object that exceeds the buffers
+        bool large;
+
+    private:
+
+        HeapRegion(uint8_t *start, uint32_t size, uint32_t mark_words,
+            uint32_t reserved);
+
+        static uint32_t card_index(const Object *object)
+        {
+            return ((uintptr_t) object >> CARD_SHIFT) & (CARDS - 1);
+        }
+
+        // Returns the first object at or above the memory and below the
+        // limit.
+        Object *object_from(uint8_t *memory, const uint8_t *limit) const;
+
+        // Returns the object after the object and below the limit.
+        Object *next_object(Object *object, const uint8_t *limit) const;
+
+        // Clears the marks of the objects between the addresses.
+        void clear_marks(const uint8_t *from, const uint8_t *to);
+
+        uint8_t *_cards;
+        std::atomic<uint64_t> *_marks;
+        uint32_t _mark_words;
+
+        // Bytes of the memory, including the header
+        uint32_t _reserved;
+    };
+
+    // The heap-space is carved into regions, threads bump-allocate from
+    // their own region without synchronization. Only the refill of a
+    // buffer and large objects take the lock.
+    //
+    // Objects are never moved, so a survivor keeps its region alive. The
+    // free end of a region is reused, but the fillers below its last
+    // survivor are not until the region is empty. In the worst case each
+    // scattered survivor pins a region, the footprint is then bounded by
+    // the survivors times the region size. Empty regions are kept for
+    // buffers up to a limit, the others are returned to the system.
+    class HeapSpace
+    {
+    public:
+
+        static const uint32_t REGION_SIZE = HeapRegion::SIZE;
+        static const uint32_t LARGE_OBJECT_SIZE = REGION_SIZE / 4;
+
+        // Empty regions, that are kept for buffers
+        static const uint32_t FREE_REGIONS_KEPT = 16;
+
+        HeapSpace() : _shared_buffer(0), _allocated_bytes(0) { }
+        ~HeapSpace();
+
+        // Returns the size of the object in the heap-space.
+        static uint32_t object_size(const Object *object);
+
+        // Sets the mark of the object atomically, returns false if it was
+        // already set.
+        static bool try_mark(const Object *object)
+        {
+            return HeapRegion::of(object)->mark(object);
+        }
+
+        static bool is_marked(const Object *object)
+        {
+            return HeapRegion::of(object)->is_marked(object);
+        }
+
+        // Clears the marks of all objects before the marking.
+        void clear_marks();
+
+        // Records the tops of the regions at the start of a collection,
+        // objects allocated above them during the collection survive it.
+        void record_tops();
+
+        // Records a reference stored into the object, the next young
+        // collection scans it for references to young objects.
+        static void write_barrier(const Object *object)
+        {
+            HeapRegion::dirty_card(object);
+        }
+
+        // Records the reference, that is about to be overwritten, while a
+        // concurrent marking is active.
+        static void pre_write_barrier(Object *previous)
+        {
+            if (previous != 0 && _satb_active.load(std::memory_order_relaxed))
+            {
+                SatbQueue::record(previous);
+            }
+        }
+
+        // Moves the survivors of a collection to the old generation.
+        void promote();
+
+        // Returns the bytes of the old generation, including fillers.
+        uint64_t old_bytes();
+
+        // Allocates zeroed memory of the object-size, returns 0 if the
+        // memory is exhausted.
+        uint8_t *allocate(uint32_t size)
+        {
+            size = align(size);
+
+            Thread *thread = _current_thread;
+            if (thread != 0)
+            {
+                HeapRegion *buffer = thread->tlab();
+                if (buffer != 0 &&
+                    (uint32_t) (buffer->end - buffer->top) >= size)
+                {
+                    uint8_t *memory = buffer->top;
+                    buffer->top += size;
+                    return memory;
+                }
+            }
+
+            return allocate_slow(thread, size);
+        }
+
+        // Turns the object of the size into a filler, its destructor
+        // must have been called.
+        void release(Object *object, uint32_t size);
+
+        // Returns the buffer of the thread to the heap-space.
+        void retire_tlab(Thread *thread);
+
+        // Frees the large regions of released objects and makes the
+        // regions, that hold only fillers, and the free ends of the other
+        // regions available for buffers again.
+        void reclaim_regions();
+
+        // Getters.
+        Mutex &mutex() { return _mutex; }
+        List<HeapRegion *> &regions() { return _regions; }
+        uint64_t allocated_bytes() const { return _allocated_bytes; }
+
+    private:
+
+        static uint32_t align(uint32_t size) { return (size + 7) & ~7; }
+
+        // Refills the buffer of the thread or allocates a large region.
+        uint8_t *allocate_slow(Thread *thread, uint32_t size);
+
+        // Takes a region with a free end, a free region or creates a new
+        // one, returns 0 if the memory is exhausted.
+        HeapRegion *acquire_region();
+
+        Mutex _mutex;
+
+        // Regions holding objects, including the buffers
+        List<HeapRegion *> _regions;
+        List<HeapRegion *> _free_regions;
+
+        // Regions holding objects, whose free end takes a buffer
+        List<HeapRegion *> _partial_regions;
+
+        // Buffer for allocations outside of vm-threads
+        HeapRegion *_shared_buffer;
+
+        // Bytes handed out to buffers and large objects
+        uint64_t _allocated_bytes;
+    };
+
+}
+
+#endif
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_MEMORY_MARKSTACK_HPP_
+#define COLDSPOT_JVM_MEMORY_MARKSTACK_HPP_
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace coldspot
+{
+
+    class Object;
+
+    // Growable stack of marked objects, whose references are not scanned
+    // yet. If the stack can't grow, objects are dropped and the overflow
+    // is flagged, the collector has to rescan the marked objects then.
+    class MarkStack
+    {
+    public:
+
+        static const uint32_t INITIAL_CAPACITY = 4096;
+        static const uint32_t MAX_CAPACITY = 64 * 1024 * 1024;
+
+        MarkStack(uint32_t max_capacity = MAX_CAPACITY)
+            : _objects(0), _size(0), _capacity(0),
+              _max_capacity(max_capacity), _overflowed(false) { }
+
+        ~MarkStack() { free(_objects); }
+
+        MarkStack(const MarkStack &) = delete;
+        MarkStack &operator=(const MarkStack &) = delete;
+
+        void push(Object *object)
+        {
+            if (_size == _capacity && !grow())
+            {
+                _overflowed = true;
+                return;
+            }
+
+            _objects[_size++] = object;
+        }
+
+        Object *pop() { return _objects[--_size]; }
+
+        bool empty() const { return _size == 0; }
+
+        // Returns and clears the overflow flag.
+        bool take_overflow()
+        {
+            bool overflowed = _overflowed;
+            _overflowed = false;
+            return overflowed;
+        }
+
+    private:
+
+        bool grow()
+        {
+            if (_capacity >= _max_capacity)
+            {
+                return false;
+            }
+
+            uint32_t capacity = _capacity == 0 ? INITIAL_CAPACITY
+                                               : _capacity * 2;
+            if (capacity > _max_capacity)
+            {
+                capacity = _max_capacity;
+            }
+
+            Object **objects = (Object **) realloc(_objects,
+                capacity * sizeof(Object *));
+            if (objects == 0)
+            {
+                return false;
+            }
+
+            _objects = objects;
+            _capacity = capacity;
+
+            return true;
+        }
+
+        Object **_objects;
+        uint32_t _size;
+        uint32_t _capacity;
+        uint32_t _max_capacity;
+        bool _overflowed;
+    };
+
+}
+
+#endif
@@ -26,48 +26,27 @@ namespace coldspot
 
     MemoryManager::MemoryManager()
     {
-        _objectAllocator = new ObjectAllocator;
+        _objectAllocator = new ObjectAllocator(&_heap_space);
     }
 
 
     MemoryManager::~MemoryManager()
     {
-        auto iterator = _objects->begin();
-        while (iterator != _objects->end())
-        {
-            release_object(*iterator);
-            iterator = _objects->erase(iterator);
-        }
-
+        // The heap-space destroys the remaining objects
         DELETE_OBJECT(_objectAllocator)
     }
 
 
     error_t MemoryManager::allocate_object(Class *clazz, Object **object)
     {
-        error_t errorValue = _objectAllocator->allocate_object(clazz, object);
-        RETURN_ON_FAIL(errorValue)
-
-        _objects.lock();
-        _objects->add(*object);
-        _objects.unlock();
-
-        return RETURN_OK;
+        return _objectAllocator->allocate_object(clazz, object);
     }
 
 
     error_t MemoryManager::allocate_array(Class *clazz, jsize length,
         Array **array)
     {
-        error_t errorValue = _objectAllocator->allocate_array(clazz, length,
-            array);
-        RETURN_ON_FAIL(errorValue)
-
-        _objects.lock();
-        _objects->add(*array);
-        _objects.unlock();
-
-        return RETURN_OK;
+        return _objectAllocator->allocate_array(clazz, length, array);
     }
 
 
@@ -22,10 +22,10 @@
 #ifndef COLDSPOT_JVM_MEMORY_MEMORYMANAGER_HPP_
 #define COLDSPOT_JVM_MEMORY_MEMORYMANAGER_HPP_
 
-#include <jvm/common/heap.hpp>
-#include <jvm/thread/Lockable.hpp>
 #include <jvm/Error.hpp>
 
+#include "HeapSpace.hpp"
+
 namespace coldspot
 {
 
@@ -42,24 +42,21 @@ namespace coldspot
 
         ~MemoryManager();
 
-        // Allocates a object and stores it in the heap-space.
+        // Allocates a object in the heap-space.
         error_t allocate_object(Class *clazz, Object **object);
 
-        // Allocates an array and stores it in the heap-space.
+        // Allocates an array in the heap-space.
         error_t allocate_array(Class *clazz, jsize length, Array **array);
 
         // Releases the object from the heap-space and releases its memory.
         void release_object(Object *object);
 
         // Getters.
-        Lockable <heap<Object *>> &get_objects()
-        {
-            return _objects;
-        }
+        HeapSpace &heap_space() { return _heap_space; }
 
     protected:
 
-        Lockable <heap<Object *>> _objects;
+        HeapSpace _heap_space;
 
         ObjectAllocator *_objectAllocator;
     };
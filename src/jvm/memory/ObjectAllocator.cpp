@@ -19,8 +19,6 @@
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <cstdlib>
-
 #include <jvm/Global.hpp>
 
 namespace coldspot
@@ -28,9 +26,13 @@ namespace coldspot
 
     error_t ObjectAllocator::allocate_object(Class *clazz, Object **object)
     {
-        // Allocate memory
-        uint8_t *memory = (uint8_t *) calloc(1,
+        // Allocate zeroed memory
+        uint8_t *memory = _heap_space->allocate(
             sizeof(Object) + clazz->object_size);
+        if (memory == 0)
+        {
+            return out_of_memory();
+        }
 
         // Initialize objects
         Object *current_object = new(memory) Object(clazz);
@@ -39,9 +41,6 @@ namespace coldspot
         current_object->set_memory_size(clazz->object_size);
         current_object->set_memory(current_memory);
 
-        // Calculate and set offsets
-        calculate_offsets(current_object, clazz, 0);
-
         *object = (Object *) memory;
 
         return RETURN_OK;
@@ -61,8 +60,12 @@ namespace coldspot
             java_size += clazz->object_size;
         }
 
-        // Allocate memory
-        uint8_t *memory = (uint8_t *) calloc(1, sizeof(Array) + java_size);
+        // Allocate zeroed memory
+        uint8_t *memory = _heap_space->allocate(sizeof(Array) + java_size);
+        if (memory == 0)
+        {
+            return out_of_memory();
+        }
 
         // Initialize objects
         Object *current_object = new(memory) Array(clazz, length);
@@ -71,40 +74,28 @@ namespace coldspot
         current_object->set_memory_size(java_size);
         current_object->set_memory(current_memory);
 
-        // Calculate and set offsets
-        calculate_offsets(current_object, clazz->super_class, array_size);
-
         *array = (Array *) memory;
 
         return RETURN_OK;
     }
 
 
-    void ObjectAllocator::release_object(Object *object)
+    error_t ObjectAllocator::out_of_memory()
     {
-        object->~Object();
-        free(object);
-    }
-
-
-    uint32_t ObjectAllocator::calculate_offsets(Object *object, Class *clazz,
-        uint32_t offset)
-    {
-        if (clazz->super_class != 0)
+        if (_vm == 0 || _vm->out_of_memory_error() == 0 ||
+            _current_executor == 0)
         {
-            offset = calculate_offsets(object, clazz->super_class, offset);
+            return RETURN_ERROR;
         }
 
-        for (uint16_t i = 0; i < clazz->declared_fields.length(); ++i)
-        {
-            Field *field = clazz->declared_fields[i];
-            if (!field->is_static())
-            {
-                field->set_offset(offset);
-                offset += field->type()->type_size;
-            }
-        }
+        return _current_executor->throw_exception(_vm->out_of_memory_error());
+    }
+
 
-        return offset;
+    void ObjectAllocator::release_object(Object *object)
+    {
+        uint32_t size = HeapSpace::object_size(object);
+        object->~Object();
+        _heap_space->release(object, size);
     }
 }
@@ -29,20 +29,25 @@ namespace coldspot
 
     class Array;
     class Class;
+    class HeapSpace;
     class Object;
 
     class ObjectAllocator
     {
     public:
 
+        ObjectAllocator(HeapSpace *heap_space) : _heap_space(heap_space) { }
+
         error_t allocate_object(Class *clazz, Object **object);
         error_t allocate_array(Class *clazz, jsize length, Array **array);
         virtual void release_object(Object *object);
 
     private:
 
-        inline uint32_t calculate_offsets(Object *object, Class *clazz,
-            uint32_t offset);
+        // Throws the pre-allocated OutOfMemoryError.
+        static error_t out_of_memory();
+
+        HeapSpace *_heap_space;
     };
 
 }
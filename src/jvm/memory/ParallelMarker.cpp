@@ -0,0 +1,231 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    static_assert(alignof(GCWorker) <= alignof(std::max_align_t),
+        "workers are allocated with new");
+
+
+    void GCWorker::drain()
+    {
+        Object *object;
+        while ((object = pop()) != 0)
+        {
+            GarbageCollector::scan_references(object, *this);
+        }
+    }
+
+
+    ParallelMarker::ParallelMarker(uint32_t threads)
+        : _threads(threads > 0 ? threads : 1), _tasks(0), _tasks_count(0),
+          _next_task(0), _idle(0), _epoch(0), _busy(0), _alive(0),
+          _stopping(false)
+    {
+        _workers = new GCWorker *[_threads];
+        for (uint32_t i = 0; i < _threads; ++i)
+        {
+            _workers[i] = new GCWorker(this, i);
+        }
+
+        // The first worker is the thread that starts the marking
+        _alive = _threads - 1;
+        for (uint32_t i = 1; i < _threads; ++i)
+        {
+            System::createThread((void *) &worker_start, (void *) _workers[i]);
+        }
+    }
+
+
+    ParallelMarker::~ParallelMarker()
+    {
+        _mutex.lock();
+        _stopping = true;
+        _start_condition.notify_all();
+        while (_alive != 0)
+        {
+            _done_condition.wait(_mutex);
+        }
+        _mutex.unlock();
+
+        for (uint32_t i = 0; i < _threads; ++i)
+        {
+            DELETE_OBJECT(_workers[i])
+        }
+        DELETE_ARRAY(_workers)
+    }
+
+
+    bool ParallelMarker::mark(List<RootTask *> &tasks)
+    {
+        dynarray<RootTask *> taskArray(tasks.size());
+        uint32_t count = 0;
+        for (auto task : tasks)
+        {
+            taskArray[count++] = task;
+        }
+
+        _tasks = taskArray;
+        _tasks_count = count;
+        _next_task.store(0);
+        _idle.store(0);
+
+        // Wake the pool and work as first worker
+        _mutex.lock();
+        _busy = _threads - 1;
+        ++_epoch;
+        _start_condition.notify_all();
+        _mutex.unlock();
+
+        work(_workers[0]);
+
+        _mutex.lock();
+        while (_busy != 0)
+        {
+            _done_condition.wait(_mutex);
+        }
+        _mutex.unlock();
+
+        _tasks = 0;
+
+        bool overflowed = false;
+        for (uint32_t i = 0; i < _threads; ++i)
+        {
+            if (_workers[i]->take_overflow())
+            {
+                overflowed = true;
+            }
+        }
+
+        return overflowed;
+    }
+
+
+    void *ParallelMarker::worker_start(void *parameter)
+    {
+        GCWorker *worker = (GCWorker *) parameter;
+        worker->_marker->run_worker(worker);
+
+        return 0;
+    }
+
+
+    void ParallelMarker::run_worker(GCWorker *worker)
+    {
+        uint32_t epoch = 0;
+
+        _mutex.lock();
+        while (true)
+        {
+            while (!_stopping && _epoch == epoch)
+            {
+                _start_condition.wait(_mutex);
+            }
+
+            if (_stopping)
+            {
+                break;
+            }
+
+            epoch = _epoch;
+            _mutex.unlock();
+
+            work(worker);
+
+            _mutex.lock();
+            if (--_busy == 0)
+            {
+                _done_condition.notify_all();
+            }
+        }
+
+        --_alive;
+        _done_condition.notify_all();
+        _mutex.unlock();
+    }
+
+
+    void ParallelMarker::work(GCWorker *worker)
+    {
+        // Roots first, every task is taken by a single worker
+        uint32_t index;
+        while ((index = _next_task.fetch_add(1)) < _tasks_count)
+        {
+            _tasks[index]->scan(*worker);
+            worker->drain();
+        }
+
+        do
+        {
+            worker->drain();
+        }
+        while (steal(worker) || !terminate());
+    }
+
+
+    bool ParallelMarker::steal(GCWorker *worker)
+    {
+        for (uint32_t i = 1; i < _threads; ++i)
+        {
+            GCWorker *victim = _workers[(worker->_index + i) % _threads];
+            Object *object = victim->_deque.steal();
+            if (object != 0)
+            {
+                GarbageCollector::scan_references(object, *worker);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    bool ParallelMarker::terminate()
+    {
+        _idle.fetch_add(1);
+
+        while (true)
+        {
+            if (_idle.load() == _threads)
+            {
+                return true;
+            }
+
+            // Leave the idle workers, if there is something to steal
+            for (uint32_t i = 0; i < _threads; ++i)
+            {
+                if (!_workers[i]->_deque.empty())
+                {
+                    _idle.fetch_sub(1);
+                    return false;
+                }
+            }
+
+            System::yield();
+        }
+    }
+
+}
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_MEMORY_PARALLELMARKER_HPP_
+#define COLDSPOT_JVM_MEMORY_PARALLELMARKER_HPP_
+
+#include <atomic>
+
+#include <jvm/common/List.hpp>
+#include <jvm/thread/Condition.hpp>
+#include <jvm/thread/Mutex.hpp>
+#include <jvm/Object.hpp>
+
+#include "HeapSpace.hpp"
+#include "MarkStack.hpp"
+#include "WorkStealingDeque.hpp"
+
+namespace coldspot
+{
+
+    class ParallelMarker;
+
+    // A worker marks grey objects of its own deque and steals from the
+    // deques of the others, when it runs out of work.
+    class GCWorker
+    {
+    public:
+
+        GCWorker(ParallelMarker *marker, uint32_t index) : _marker(marker),
+                                                           _index(index) { }
+
+        // Marks the object and pushes it for scanning.
+        void mark(Object *object)
+        {
+            if (object != 0 && HeapSpace::try_mark(object) &&
+                !_deque.push(object))
+            {
+                _overflow.push(object);
+            }
+        }
+
+        // Scans the grey objects of this worker.
+        void drain();
+
+        // Returns true if grey objects were dropped since the last call.
+        bool take_overflow() { return _overflow.take_overflow(); }
+
+    private:
+
+        friend class ParallelMarker;
+
+        Object *pop()
+        {
+            Object *object = _deque.pop();
+            if (object == 0 && !_overflow.empty())
+            {
+                object = _overflow.pop();
+            }
+
+            return object;
+        }
+
+        ParallelMarker *_marker;
+        uint32_t _index;
+
+        // Grey objects, that don't fit into the deque, can't be stolen
+        WorkStealingDeque _deque;
+        MarkStack _overflow;
+    };
+
+    // A group of roots, scanned by one of the workers.
+    class RootTask
+    {
+    public:
+
+        virtual ~RootTask() { }
+
+        virtual void scan(GCWorker &worker) = 0;
+    };
+
+    // Marks the objects reachable from the roots with a pool of workers.
+    // The thread that starts the marking is the first worker.
+    class ParallelMarker
+    {
+    public:
+
+        ParallelMarker(uint32_t threads);
+        ~ParallelMarker();
+
+        // Scans the tasks and marks all reachable objects. Returns true if
+        // grey objects were dropped, the marked objects must be rescanned.
+        bool mark(List<RootTask *> &tasks);
+
+        // Getters.
+        uint32_t threads() const { return _threads; }
+
+    private:
+
+        static void *worker_start(void *parameter);
+
+        // Waits for the next marking until the pool is stopped.
+        void run_worker(GCWorker *worker);
+
+        // Takes root tasks, then steals until all workers are idle.
+        void work(GCWorker *worker);
+
+        // Scans an object stolen from another worker.
+        bool steal(GCWorker *worker);
+
+        // Returns true if all workers ran out of work.
+        bool terminate();
+
+        uint32_t _threads;
+        GCWorker **_workers;
+
+        // Root tasks of the current marking
+        RootTask **_tasks;
+        uint32_t _tasks_count;
+        std::atomic<uint32_t> _next_task;
+        std::atomic<uint32_t> _idle;
+
+        // Pool threads wait for the next epoch
+        Mutex _mutex;
+        Condition _start_condition;
+        Condition _done_condition;
+        uint32_t _epoch;
+        uint32_t _busy;
+        uint32_t _alive;
+        bool _stopping;
+    };
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#include <jvm/Global.hpp>
+
+namespace coldspot
+{
+
+    std::atomic<bool> _satb_active(false);
+
+    Mutex SatbQueue::_global_mutex;
+    List<Object *> SatbQueue::_global;
+
+
+    void SatbQueue::record(Object *object)
+    {
+        // Native code keeps running in a pause, so its queue could not be
+        // drained then
+        Thread *thread = _current_thread;
+        Executor *executor = _current_executor;
+        bool native = executor != 0 && (executor->frames().empty() ||
+                      ((Frame *) executor->frames().peek())->type ==
+                      FRAMETYPE_NATIVE);
+
+        if (thread != 0 && !native)
+        {
+            thread->satb_queue().push(object);
+        }
+        else
+        {
+            _global_mutex.lock();
+            _global.addBack(object);
+            _global_mutex.unlock();
+        }
+    }
+
+
+    void SatbQueue::flush()
+    {
+        // Locking the mutex changes the state of the thread, which flushes
+        // again
+        uint32_t count = _count;
+        if (count == 0)
+        {
+            return;
+        }
+        _count = 0;
+
+        _global_mutex.lock();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            _global.addBack(_objects[i]);
+        }
+        _global_mutex.unlock();
+    }
+
+}
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_MEMORY_SATBQUEUE_HPP_
+#define COLDSPOT_JVM_MEMORY_SATBQUEUE_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+#include <jvm/common/List.hpp>
+#include <jvm/thread/Mutex.hpp>
+
+namespace coldspot
+{
+
+    class Object;
+
+    // Objects, whose references were overwritten by a thread during a
+    // concurrent marking (snapshot-at-the-beginning). They were reachable
+    // when the marking started, so the collector marks them. Full queues
+    // are handed to a global list, so is the queue of a thread that stops
+    // running or calls a native method. Native code records into the
+    // global list directly, it is not stopped by a pause.
+    class SatbQueue
+    {
+    public:
+
+        static const uint32_t CAPACITY = 256;
+
+        SatbQueue() : _count(0) { }
+
+        // Records the object in the queue of the current thread.
+        static void record(Object *object);
+
+        void push(Object *object)
+        {
+            if (_count == CAPACITY)
+            {
+                flush();
+            }
+
+            _objects[_count++] = object;
+        }
+
+        // Hands the recorded objects to the global list.
+        void flush();
+
+        // Marks the recorded objects of the queue and of the global list.
+        template<typename Marker>
+        void drain(Marker &marker)
+        {
+            for (uint32_t i = 0; i < _count; ++i)
+            {
+                marker.mark(_objects[i]);
+            }
+            _count = 0;
+        }
+
+        // Returns false if the global list was empty.
+        template<typename Marker>
+        static bool drain_global(Marker &marker)
+        {
+            _global_mutex.lock();
+            bool drained = !_global.empty();
+            for (auto object : _global)
+            {
+                marker.mark(object);
+            }
+            _global.clear();
+            _global_mutex.unlock();
+
+            return drained;
+        }
+
+    private:
+
+        static Mutex _global_mutex;
+        static List<Object *> _global;
+
+        Object *_objects[CAPACITY];
+        uint32_t _count;
+    };
+
+    // Set while a concurrent marking takes the snapshot, the overwritten
+    // references are recorded then
+    extern std::atomic<bool> _satb_active;
+
+}
+
+#endif
@@ -24,49 +24,23 @@
 namespace coldspot
 {
 
-    void SimpleGarbageCollector::collectGarbage()
+    // Roots of a vm-thread: its object, exceptions and frames.
+    class ThreadRootTask : public RootTask
     {
-        auto &objects = _vm->memory_manager()->get_objects();
-        auto &threads = _vm->threads();
+    public:
 
-        // Prevent creating or deleting threads during gc
-        threads.lock();
-
-        // Suspend all threads
-        _vm->suspend_vm_threads();
+        ThreadRootTask(VMThread *thread) : _thread(thread) { }
 
-        // Mark all objects as unused
-        for (auto object : *objects)
+        void scan(GCWorker &worker) override
         {
-            mark_unused(object);
-        }
-
-        // Mark all referenced objects as used
-        for (auto thread : *threads)
-        {
-            // Don't analyze threads that are
-            // not started yet or are already terminated
-            if (thread->state() == THREADSTATE_NEW ||
-                thread->state() == THREADSTATE_TERMINATED)
-            {
-                continue;
-            }
-
-            // Only vm-threads are relevant for gc
-            if (thread->type() != THREADTYPE_VM &&
-                thread->type() != THREADTYPE_FINALIZER)
-            {
-                continue;
-            }
-
-            VMThread *vmThread = static_cast<VMThread *>(thread);
-            Executor *executor = vmThread->executor();
+            Executor *executor = _thread->executor();
 
             // Check thread-object
-            mark_used(vmThread->object());
+            worker.mark(_thread->object());
 
             // Check uncaught exception
-            mark_used(executor->uncaught_exception());
+            worker.mark(executor->uncaught_exception());
+            worker.mark(executor->initializer_exception());
 
             // Check all frames
             auto &frames = executor->frames();
@@ -76,11 +50,33 @@ namespace coldspot
                 Frame *frame = (Frame * ) * frameIter;
 
                 // Check pending exception on frame
-                mark_used(frame->exception);
+                worker.mark(frame->exception);
 
                 if (frame->type == FrameType::FRAMETYPE_JAVA)
                 {
 
+#if defined(COLDSPOT_UNTAGGED_SLOTS)
+                    // Check local variables and operands, that hold
+                    // references at the current instruction
+                    Method *method = frame->method;
+                    uint32_t pc = CURRENT_PC(frame);
+                    uint16_t localsCount = method->locals_count();
+                    for (uint16_t j = 0; j < localsCount; ++j)
+                    {
+                        if (method->is_reference(pc, j))
+                        {
+                            worker.mark(frame->localVariables[j].as_object());
+                        }
+                    }
+
+                    for (uint32_t j = 0; j < frame->operandsCount; ++j)
+                    {
+                        if (method->is_reference(pc, localsCount + j))
+                        {
+                            worker.mark(frame->operands[j].as_object());
+                        }
+                    }
+#else
                     // Check local variables
                     auto &localVariables = frame->localVariables;
                     for (uint16_t j = 0; j < frame->method->locals_count(); ++j)
@@ -88,7 +84,7 @@ namespace coldspot
                         Value &value = localVariables[j];
                         if (value.type() == Type::TYPE_REFERENCE)
                         {
-                            mark_used(value.as_object());
+                            worker.mark(value.as_object());
                         }
                     }
 
@@ -98,9 +94,10 @@ namespace coldspot
                         Value &operand = frame->operands[j];
                         if (operand.type() == Type::TYPE_REFERENCE)
                         {
-                            mark_used(operand.as_object());
+                            worker.mark(operand.as_object());
                         }
                     }
+#endif
 
                 }
                 else if (frame->type == FrameType::FRAMETYPE_NATIVE)
@@ -108,7 +105,7 @@ namespace coldspot
                     // Check local references
                     for (auto localReference : *(frame->localReferences))
                     {
-                        mark_used(localReference);
+                        worker.mark(localReference);
                     }
                 }
 
@@ -116,73 +113,261 @@ namespace coldspot
             }
         }
 
-        auto &loadedClasses = _vm->class_loader()->loaded_classes();
+    private:
 
-        // Mark all from the class referenced objects
-        auto loadedClassesIterator = loadedClasses.begin();
-        while (loadedClassesIterator != loadedClasses.end())
-        {
-            Class *clazz = loadedClassesIterator->value;
+        VMThread *_thread;
+    };
+
+
+    // Class-objects, class-loaders and static fields of a range of classes.
+    class ClassRootTask : public RootTask
+    {
+    public:
+
+        static const uint32_t CLASSES_PER_TASK = 64;
 
-            // Mark class-object
-            mark_used(clazz->object);
+        ClassRootTask() : _count(0) { }
 
-            // Mark class-loader
-            mark_used(clazz->class_loader);
+        // Adds the class, returns false if the task is full.
+        bool add(Class *clazz)
+        {
+            if (_count == CLASSES_PER_TASK)
+            {
+                return false;
+            }
 
-            // Mark static fields
-            if (!clazz->is_array())
+            _classes[_count++] = clazz;
+            return true;
+        }
+
+        void scan(GCWorker &worker) override
+        {
+            for (uint32_t i = 0; i < _count; ++i)
             {
-                List < Field * > declared_fields;
-                clazz->get_declared_fields(declared_fields);
+                Class *clazz = _classes[i];
 
-                for (auto declared_field : declared_fields)
+                // Mark class-object
+                worker.mark(clazz->object);
+
+                // Mark class-loader
+                worker.mark(clazz->class_loader);
+
+                // Mark static fields
+                if (!clazz->is_array())
                 {
-                    if (declared_field->is_static() &&
-                        !declared_field->type()->is_primitive())
+                    List < Field * > declared_fields;
+                    clazz->get_declared_fields(declared_fields);
+
+                    for (auto declared_field : declared_fields)
                     {
-                        mark_used(declared_field->get_static<jobject>());
+                        if (declared_field->is_static() &&
+                            !declared_field->type()->is_primitive())
+                        {
+                            worker.mark(declared_field->get_static<jobject>());
+                        }
                     }
                 }
             }
+        }
 
-            ++loadedClassesIterator;
+    private:
+
+        Class *_classes[CLASSES_PER_TASK];
+        uint32_t _count;
+    };
+
+
+    // Objects of the string pool.
+    class StringPoolRootTask : public RootTask
+    {
+    public:
+
+        void scan(GCWorker &worker) override
+        {
+            auto iterator = _vm->string_pool().begin();
+            while (iterator != _vm->string_pool().end())
+            {
+                worker.mark(iterator->value);
+                ++iterator;
+            }
         }
+    };
+
+
+    // Local and global references of the vm and pre-allocated objects.
+    class ReferenceRootTask : public RootTask
+    {
+    public:
 
-        // Mark string pool objects
-        auto constantPoolIterator = _vm->string_pool().begin();
-        while (constantPoolIterator != _vm->string_pool().end())
+        void scan(GCWorker &worker) override
         {
-            mark_used(constantPoolIterator->value);
-            ++constantPoolIterator;
+            // Mark all local references
+            for (auto localReference : *_vm->local_references())
+            {
+                worker.mark(localReference);
+            }
+
+            // Mark all global references
+            for (auto globalReference : *_vm->global_references())
+            {
+                worker.mark(globalReference);
+            }
+
+            // Mark pre-allocated error-objects
+            worker.mark(_vm->stack_overflow_error());
+            worker.mark(_vm->out_of_memory_error());
         }
+    };
 
-        // Mark all local references
-        for (auto localReference : *_vm->local_references())
+
+    // Old objects, whose cards are dirty, of a region.
+    class CardRootTask : public RootTask
+    {
+    public:
+
+        CardRootTask(HeapRegion *region) : _region(region) { }
+
+        void scan(GCWorker &worker) override
         {
-            mark_used(localReference);
+            for (Object *object = _region->first_old_object(); object != 0;
+                 object = _region->next_old_object(object))
+            {
+                if (_region->is_card_dirty(object))
+                {
+                    GarbageCollector::scan_references(object, worker);
+                }
+            }
         }
 
-        // Mark all global references
-        for (auto globalReference : *_vm->global_references())
+    private:
+
+        HeapRegion *_region;
+    };
+
+
+    // Objects waiting for the finalizer, the objects they reference must
+    // survive until they are released.
+    class FinalizerRootTask : public RootTask
+    {
+    public:
+
+        void scan(GCWorker &worker) override
         {
-            mark_used(globalReference);
+            Finalizer *finalizer = _vm->finalizer_thread()->finalizer();
+            auto &inObjects = finalizer->in_objects();
+            auto &outObjects = finalizer->out_objects();
+
+            // The finalizer moves the objects under the locks
+            inObjects.lock();
+            outObjects.lock();
+
+            for (auto object : *inObjects)
+            {
+                worker.mark(object);
+            }
+
+            for (auto object : finalizer->current_objects())
+            {
+                worker.mark(object);
+            }
+
+            for (auto object : *outObjects)
+            {
+                worker.mark(object);
+            }
+
+            outObjects.unlock();
+            inObjects.unlock();
         }
+    };
 
-        // Mark pre-allocated error-object
-        mark_used(_vm->stack_overflow_error());
+
+    SimpleGarbageCollector::SimpleGarbageCollector(HeapSpace *heap_space,
+        uint32_t threads) : GarbageCollector(heap_space), _marker(threads),
+                            _full_collection_bytes(FULL_COLLECTION_BYTES)
+    {
+    }
+
+
+    void SimpleGarbageCollector::collectGarbage()
+    {
+        HeapSpace &heapSpace = *_heap_space;
+        auto &threads = _vm->threads();
+
+        // Prevent creating or deleting threads during gc
+        threads.lock();
+
+        // Suspend all threads
+        _vm->suspend_vm_threads();
+
+        // Threads in native code keep allocating, their new objects are
+        // not marked and must not be swept
+        heapSpace.record_tops();
+
+        // Collect the young generation until the old one has grown
+        bool full = heapSpace.old_bytes() >= _full_collection_bytes;
+
+        // Mark all objects as unused, old objects stay marked in a young
+        // collection
+        if (full)
+        {
+            heapSpace.clear_marks();
+        }
+
+        // Partition the roots, the workers take the tasks in turn
+        List<RootTask *> tasks;
+        add_root_tasks(tasks);
+
+        // Old objects may reference young ones, if their cards are dirty
+        if (!full)
+        {
+            heapSpace.mutex().lock();
+            for (auto region : heapSpace.regions())
+            {
+                if (region->has_dirty_cards())
+                {
+                    tasks.addBack(new CardRootTask(region));
+                }
+            }
+            heapSpace.mutex().unlock();
+        }
+
+        // Mark in parallel, dropped grey objects are found by a rescan
+        if (_marker.mark(tasks))
+        {
+            rescan_marked();
+            drain();
+        }
+
+        for (auto task : tasks)
+        {
+            delete task;
+        }
 
         // Delete threads that are terminated
         deleteTerminatedVMThreads();
 
-        // Get finalizer-thread
-        // and move unused objects from object-container to finalizer
-        moveUnusedObjects(*objects,
-            _vm->finalizer_thread()->finalizer()->in_objects());
+        // Release or finalize unused objects
+        sweep(full);
 
         // Remove all finalized objects
         removeFinalizedObjects();
 
+        // The survivors are old now
+        heapSpace.promote();
+
+        // Make the space of released objects available again
+        heapSpace.reclaim_regions();
+
+        if (full)
+        {
+            _full_collection_bytes = heapSpace.old_bytes() * 2;
+            if (_full_collection_bytes < FULL_COLLECTION_BYTES)
+            {
+                _full_collection_bytes = FULL_COLLECTION_BYTES;
+            }
+        }
+
         // Resume all threads
         _vm->resume_vm_threads();
 
@@ -190,6 +375,49 @@ namespace coldspot
     }
 
 
+    void SimpleGarbageCollector::add_root_tasks(List<RootTask *> &tasks)
+    {
+        for (auto thread : *_vm->threads())
+        {
+            // Don't analyze threads that are
+            // not started yet or are already terminated
+            if (thread->state() == THREADSTATE_NEW ||
+                thread->state() == THREADSTATE_TERMINATED)
+            {
+                continue;
+            }
+
+            // Only vm-threads are relevant for gc
+            if (thread->type() != THREADTYPE_VM &&
+                thread->type() != THREADTYPE_FINALIZER)
+            {
+                continue;
+            }
+
+            tasks.addBack(new ThreadRootTask(static_cast<VMThread *>(thread)));
+        }
+
+        // Chunks of the loaded classes
+        ClassRootTask *classTask = 0;
+        auto &loadedClasses = _vm->class_loader()->loaded_classes();
+        auto loadedClassesIterator = loadedClasses.begin();
+        while (loadedClassesIterator != loadedClasses.end())
+        {
+            if (classTask == 0 || !classTask->add(loadedClassesIterator->value))
+            {
+                classTask = new ClassRootTask;
+                classTask->add(loadedClassesIterator->value);
+                tasks.addBack(classTask);
+            }
+            ++loadedClassesIterator;
+        }
+
+        tasks.addBack(new StringPoolRootTask);
+        tasks.addBack(new ReferenceRootTask);
+        tasks.addBack(new FinalizerRootTask);
+    }
+
+
     void SimpleGarbageCollector::collectGarbageForExit()
     {
 
@@ -220,7 +448,7 @@ namespace coldspot
                     VMThread *vmThread = static_cast<VMThread *>(thread);
 
                     // We don't delete the thread if the java-object is still in use
-                    if (vmThread->object()->used())
+                    if (is_live(vmThread->object()))
                     {
                         deleteThread = false;
                     }
@@ -247,19 +475,26 @@ namespace coldspot
     void SimpleGarbageCollector::finalizeAllObjects()
     {
 
-        auto &source = _vm->memory_manager()->get_objects();
+        HeapSpace &source = *_heap_space;
         auto &target = _vm->finalizer_thread()->finalizer()->in_objects();
 
         target.lock();
+        source.mutex().lock();
 
-        auto iterator = source->begin();
-
-        while (iterator != source->end())
+        for (auto region : source.regions())
         {
-            target->addBack(*iterator);
-            iterator = source->erase(iterator);
+            for (Object *object = region->first_object(); object != 0;
+                 object = region->next_object(object))
+            {
+                if (!object->finalizing())
+                {
+                    object->set_finalizing(true);
+                    target->addBack(object);
+                }
+            }
         }
 
+        source.mutex().unlock();
         target.unlock();
     }
 
@@ -289,30 +524,57 @@ namespace coldspot
     }
 
 
-    void SimpleGarbageCollector::moveUnusedObjects(heap < Object * > &source,
-        Lockable < List < Object * >> &target)
+    void SimpleGarbageCollector::sweep(bool full)
     {
+        HeapSpace &heapSpace = *_heap_space;
+        auto &target = _vm->finalizer_thread()->finalizer()->in_objects();
 
-        target.lock();
-
-        auto iterator = source.begin();
-
-        while (iterator != source.end())
+        // Find the unused objects, that have to be finalized
+        List<Object *> finalizable;
+        heapSpace.mutex().lock();
+        for (auto region : heapSpace.regions())
         {
-            Object *object = *iterator;
-
-            if (!object->used())
-            {
-                target->addBack(object);
-                iterator = source.erase(iterator);
-            }
-            else
+            Object *object = full ? region->first_recorded_object()
+                                  : region->first_young_recorded_object();
+            for (; object != 0; object = region->next_recorded_object(object))
             {
-                ++iterator;
+                if (!HeapSpace::is_marked(object) && !object->finalizing() &&
+                    object->type()->finalizable)
+                {
+                    finalizable.addBack(object);
+                }
             }
         }
+        heapSpace.mutex().unlock();
 
+        // Objects stay in place until the finalizer is done, so do the
+        // objects they reference
+        target.lock();
+        for (auto object : finalizable)
+        {
+            object->set_finalizing(true);
+            mark_used(object);
+            target->addBack(object);
+        }
         target.unlock();
+
+        // Release the other unused objects
+        heapSpace.mutex().lock();
+        for (auto region : heapSpace.regions())
+        {
+            Object *object = full ? region->first_recorded_object()
+                                  : region->first_young_recorded_object();
+            while (object != 0)
+            {
+                Object *next = region->next_recorded_object(object);
+                if (!HeapSpace::is_marked(object) && !object->finalizing())
+                {
+                    _vm->memory_manager()->release_object(object);
+                }
+                object = next;
+            }
+        }
+        heapSpace.mutex().unlock();
     }
 
 
@@ -23,34 +23,65 @@
 #define COLDSPOT_JVM_MEMORY_SIMPLEGARBAGECOLLECTOR_HPP_
 
 #include "GarbageCollector.hpp"
+#include "HeapSpace.hpp"
+#include "ParallelMarker.hpp"
 
 namespace coldspot
 {
 
+    // Collects the young generation, the objects allocated since the last
+    // collection, until the old generation has doubled. Survivors stay in
+    // place and become old, the old objects are only scanned if their cards
+    // were dirtied by a reference store.
     class SimpleGarbageCollector : public GarbageCollector
     {
     public:
 
+        // Bytes of the old generation, that trigger the first full
+        // collection
+        static const uint64_t FULL_COLLECTION_BYTES = 16 * 1024 * 1024;
+
+        // Marks with the specified number of threads.
+        SimpleGarbageCollector(HeapSpace *heap_space, uint32_t threads);
+
         void collectGarbage() override;
 
         void collectGarbageForExit() override;
 
-    private:
+    protected:
+
+        // Adds the tasks, that mark the objects referenced by threads,
+        // classes, the string pool, references and the finalizer.
+        void add_root_tasks(List<RootTask *> &tasks);
+
+        // Returns true if the object survived the marking.
+        virtual bool is_live(Object *object)
+        {
+            return HeapSpace::is_marked(object);
+        }
 
         // Deletes all threads that are terminated.
         void deleteTerminatedVMThreads();
 
+        // Removes all finalized objects.
+        void removeFinalizedObjects();
+
+    private:
+
         // Deletes all vm-threads
         void deleteVMThreads();
 
         void finalizeAllObjects();
 
-        // Moves all unused objects from source to target.
-        void moveUnusedObjects(heap<Object *> &source,
-            Lockable <List<Object *>> &target);
+        // Releases the unused objects of the young generation, or of the
+        // whole heap-space, below the recorded tops. Objects with a
+        // finalize-method are handed to the finalizer instead.
+        void sweep(bool full);
 
-        // Removes all finalized objects.
-        void removeFinalizedObjects();
+        ParallelMarker _marker;
+
+        // Size of the old generation, that triggers the next full collection
+        uint64_t _full_collection_bytes;
     };
 
 }
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+//                                                                            //
+//              ColdSpot, a Java virtual machine implementation.              //
+//                    Copyright (C) 2014, Mario Morgenthum                    //
+//                                                                            //
+//                                                                            //
+//  This program is free software: you can redistribute it and/or modify      //
+//  it under the terms of the GNU General Public License as published by      //
+//  the Free Software Foundation, either version 3 of the License, or         //
+//  (at your option) any later version.                                       //
+//                                                                            //
+//  This program is distributed in the hope that it will be useful,           //
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+//  GNU General Public License for more details.                              //
+//                                                                            //
+//  You should have received a copy of the GNU General Public License         //
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef COLDSPOT_JVM_MEMORY_WORKSTEALINGDEQUE_HPP_
+#define COLDSPOT_JVM_MEMORY_WORKSTEALINGDEQUE_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+namespace coldspot
+{
+
+    class Object;
+
+    // Chase-Lev deque of grey objects with a fixed capacity. The owning
+    // worker pushes and pops at the bottom, other workers steal from the
+    // top. Only a race for the last object needs a compare-and-swap.
+    class WorkStealingDeque
+    {
+    public:
+
+        static const int64_t CAPACITY = 64 * 1024;
+        static const uint32_t CACHE_LINE_SIZE = 64;
+
+        WorkStealingDeque() : _top(0), _bottom(0) { }
+
+        WorkStealingDeque(const WorkStealingDeque &) = delete;
+        WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+        // Pushes the object, returns false if the deque is full.
+        bool push(Object *object)
+        {
+            int64_t bottom = _bottom.load(std::memory_order_relaxed);
+            int64_t top = _top.load(std::memory_order_acquire);
+            if (bottom - top >= CAPACITY)
+            {
+                return false;
+            }
+
+            _objects[bottom & (CAPACITY - 1)].store(object,
+                std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        // Pops the object pushed last by the owner, 0 if the deque is empty.
+        Object *pop()
+        {
+            int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = _top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return 0;
+            }
+
+            Object *object = _objects[bottom & (CAPACITY - 1)].load(
+                std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last object, a thief may take it concurrently
+                if (!_top.compare_exchange_strong(top, top + 1,
+                    std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    object = 0;
+                }
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return object;
+        }
+
+        // Steals the oldest object, 0 if the deque is empty or another
+        // worker won the race.
+        Object *steal()
+        {
+            int64_t top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+            {
+                return 0;
+            }
+
+            Object *object = _objects[top & (CAPACITY - 1)].load(
+                std::memory_order_relaxed);
+            if (!_top.compare_exchange_strong(top, top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return 0;
+            }
+
+            return object;
+        }
+
+        // Estimates whether objects are available for stealing.
+        bool empty() const
+        {
+            return _bottom.load(std::memory_order_relaxed) <=
+                   _top.load(std::memory_order_relaxed);
+        }
+
+    private:
+
+        // Thieves and the owner work at different ends, the padding keeps
+        // them on different cache lines. Extended alignment would be lost
+        // by new.
+        std::atomic<int64_t> _top;
+        uint8_t _top_padding[CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+        std::atomic<int64_t> _bottom;
+        uint8_t _bottom_padding[CACHE_LINE_SIZE -
+                                sizeof(std::atomic<int64_t>)];
+        std::atomic<Object *> _objects[CAPACITY];
+    };
+
+}
+
+#endif
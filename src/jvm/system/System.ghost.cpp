@@ -83,6 +83,12 @@ String System::name() {
 }
 
 
+uint32_t System::processorCount() {
+
+  return 1;
+}
+
+
 void System::releaseLibrary(Library_t library) {
 
   // TODO
@@ -139,6 +145,51 @@ void System::join(Thread_t thread) {
   gjoin(thread);
 }
 
+
+void *System::allocateExecutable(size_t size) {
+
+  // TODO
+  return 0;
+}
+
+
+void *System::allocateAligned(size_t size, size_t alignment) {
+
+  // The allocated block is stored in front of the aligned memory
+  uint8_t *memory = (uint8_t *) calloc(1, size + alignment + sizeof(void *));
+  if (memory == 0) {
+    return 0;
+  }
+
+  uintptr_t aligned = ((uintptr_t) memory + sizeof(void *) + alignment - 1)
+                      & ~(alignment - 1);
+  ((void **) aligned)[-1] = memory;
+  return (void *) aligned;
+}
+
+
+bool System::releaseAligned(void *memory, size_t size) {
+
+  free(((void **) memory)[-1]);
+  return true;
+}
+
+
+void System::waitAddress(std::atomic<uint32_t> *address, uint32_t expected,
+    jlong timeoutNanos) {
+
+  // TODO block instead of polling
+  if (address->load(std::memory_order_relaxed) == expected) {
+    gyield();
+  }
+}
+
+
+void System::wakeAddress(std::atomic<uint32_t> *address, bool all) {
+
+  // TODO
+}
+
 }
 
 #endif
@@ -22,6 +22,8 @@
 #ifndef COLDSPOT_JVM_SYSTEM_SYSTEM_HPP_
 #define COLDSPOT_JVM_SYSTEM_SYSTEM_HPP_
 
+#include <atomic>
+
 #include <jvm/common/String.hpp>
 #include <jvm/jdk/Global.hpp>
 #include <jvm/system/NativeTypes.hpp>
@@ -47,6 +49,8 @@ namespace coldspot
 
         static String name();
 
+        static uint32_t processorCount();
+
         static void releaseLibrary(Library_t library);
 
         static void sleep(jlong ms);
@@ -66,6 +70,26 @@ namespace coldspot
         static void yield();
 
         static void join(Thread_t thread);
+
+        // Allocates memory, that can be written and executed,
+        // returns 0 if it is not supported.
+        static void *allocateExecutable(size_t size);
+
+        // Allocates zeroed memory at a multiple of the alignment (a power
+        // of two), returns 0 if it fails.
+        static void *allocateAligned(size_t size, size_t alignment);
+
+        // Releases memory of allocateAligned with the same size, returns
+        // false if it fails.
+        static bool releaseAligned(void *memory, size_t size);
+
+        // Blocks while the value at the address equals the expected value,
+        // at most for the timeout (0 is none). May return spuriously.
+        static void waitAddress(std::atomic<uint32_t> *address,
+            uint32_t expected, jlong timeoutNanos);
+
+        // Wakes up one or all threads waiting on the address.
+        static void wakeAddress(std::atomic<uint32_t> *address, bool all);
     };
 
 }
@@ -25,10 +25,12 @@
 
     #include <jvm/Global.hpp>
 
+    #include <algorithm>
     #include <cstdlib>
 
     #include <chrono>
 
+    #include <sys/mman.h>
     #include <sys/time.h>
     #include <sys/types.h>
     #include <dlfcn.h>
@@ -36,6 +38,11 @@
     #include <pwd.h>
     #include <unistd.h>
 
+    #if defined(__linux__)
+        #include <linux/futex.h>
+        #include <sys/syscall.h>
+    #endif
+
 namespace coldspot
 {
 
@@ -91,6 +98,13 @@ namespace coldspot
   }
 
 
+  uint32_t System::processorCount()
+  {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t) count : 1;
+  }
+
+
   void System::releaseLibrary(Library_t library)
   {
     dlclose(library);
@@ -162,6 +176,87 @@ namespace coldspot
     pthread_join(thread, 0);
   }
 
+
+  void *System::allocateExecutable(size_t size)
+  {
+    void *memory = mmap(0, size, PROT_READ | PROT_WRITE | PROT_EXEC,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? 0 : memory;
+  }
+
+
+  // Rounds the size up to a multiple of the page size, munmap rejects
+  // ranges that end within a page
+  static size_t round_to_pages(size_t size)
+  {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    return (size + page - 1) & ~(page - 1);
+  }
+
+
+  void *System::allocateAligned(size_t size, size_t alignment)
+  {
+    // Map more than needed and unmap the unaligned head and the tail
+    size = round_to_pages(size);
+    alignment = std::max(alignment, round_to_pages(1));
+    size_t mapped = size + alignment;
+    void *memory = mmap(0, mapped, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+      return 0;
+    }
+
+    uintptr_t address = (uintptr_t) memory;
+    uintptr_t aligned = (address + alignment - 1) & ~(alignment - 1);
+    size_t head = aligned - address;
+    size_t tail = mapped - head - size;
+    if ((head > 0 && munmap(memory, head) != 0)
+        || (tail > 0 && munmap((void *) (aligned + size), tail) != 0))
+    {
+      // Unmapping already unmapped pages is no error
+      munmap(memory, mapped);
+      return 0;
+    }
+
+    return (void *) aligned;
+  }
+
+
+  bool System::releaseAligned(void *memory, size_t size)
+  {
+    return munmap(memory, round_to_pages(size)) == 0;
+  }
+
+
+  void System::waitAddress(std::atomic<uint32_t> *address, uint32_t expected,
+      jlong timeoutNanos)
+  {
+#if defined(__linux__)
+    struct timespec timeout;
+    timeout.tv_sec = timeoutNanos / 1000000000;
+    timeout.tv_nsec = timeoutNanos % 1000000000;
+    syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected,
+        timeoutNanos > 0 ? &timeout : 0, 0, 0);
+#else
+    // Without futexes the waiting threads poll
+    if (address->load(std::memory_order_relaxed) == expected)
+    {
+      usleep(timeoutNanos > 0 && timeoutNanos < 100000
+             ? timeoutNanos / 1000 : 100);
+    }
+#endif
+  }
+
+
+  void System::wakeAddress(std::atomic<uint32_t> *address, bool all)
+  {
+#if defined(__linux__)
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1, 0,
+        0, 0);
+#endif
+  }
+
 }
 
 #endif
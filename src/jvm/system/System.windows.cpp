@@ -91,6 +91,14 @@ namespace coldspot {
   }
 
 
+  uint32_t System::processorCount() {
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+  }
+
+
   void System::releaseLibrary(Library_t library) {
 
     FreeLibrary(library);
@@ -154,6 +162,65 @@ namespace coldspot {
     pthread_join(thread, 0);
   }
 
+
+  void *System::allocateExecutable(size_t size) {
+
+    return VirtualAlloc(0, size, MEM_COMMIT | MEM_RESERVE,
+        PAGE_EXECUTE_READWRITE);
+  }
+
+
+  void *System::allocateAligned(size_t size, size_t alignment) {
+
+    // Reserve more than needed to find an aligned address, then try to
+    // take it, another thread may be faster
+    for (int attempt = 0; attempt < 8; ++attempt) {
+
+      void *memory = VirtualAlloc(0, size + alignment, MEM_RESERVE,
+          PAGE_NOACCESS);
+      if (memory == 0) {
+        return 0;
+      }
+
+      uintptr_t aligned = ((uintptr_t) memory + alignment - 1)
+                          & ~(alignment - 1);
+      VirtualFree(memory, 0, MEM_RELEASE);
+
+      memory = VirtualAlloc((void *) aligned, size, MEM_COMMIT | MEM_RESERVE,
+          PAGE_READWRITE);
+      if (memory != 0) {
+        return memory;
+      }
+    }
+
+    return 0;
+  }
+
+
+  bool System::releaseAligned(void *memory, size_t size) {
+
+    return VirtualFree(memory, 0, MEM_RELEASE) != 0;
+  }
+
+
+  void System::waitAddress(std::atomic<uint32_t> *address, uint32_t expected,
+      jlong timeoutNanos) {
+
+    DWORD timeout = timeoutNanos > 0
+                    ? (DWORD) ((timeoutNanos + 999999) / 1000000) : INFINITE;
+    WaitOnAddress(address, &expected, sizeof(expected), timeout);
+  }
+
+
+  void System::wakeAddress(std::atomic<uint32_t> *address, bool all) {
+
+    if (all) {
+      WakeByAddressAll(address);
+    } else {
+      WakeByAddressSingle(address);
+    }
+  }
+
 }
 
 #endif
@@ -21,6 +21,10 @@
 
 #include <jvm/Global.hpp>
 
+#if defined(__linux__)
+#define CONDITION_MONOTONIC
+#endif
+
 namespace coldspot
 {
 
@@ -42,7 +46,15 @@ namespace coldspot
 #else
         _impl = new ConditionImpl;
 
-        pthread_cond_init(&_impl->condition, 0);
+        // Timed waits measure against the monotonic clock where supported,
+        // so that changes of the wall clock do not affect them
+        pthread_condattr_t attributes;
+        pthread_condattr_init(&attributes);
+#ifdef CONDITION_MONOTONIC
+        pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+#endif
+        pthread_cond_init(&_impl->condition, &attributes);
+        pthread_condattr_destroy(&attributes);
 #endif
     }
 
@@ -83,7 +95,8 @@ namespace coldspot
     {
         if (_current_thread != 0)
         {
-            _current_thread->set_state(THREADSTATE_WAITING);
+            _current_thread->set_state(timeout == 0 ? THREADSTATE_WAITING
+                                                    : THREADSTATE_TIMED_WAITING);
         }
 
 #ifdef OS_GHOST
@@ -96,7 +109,21 @@ namespace coldspot
         }
         else
         {
-            pthread_cond_wait(&_impl->condition, mutexHandle); // TODO
+            struct timespec deadline;
+#ifdef CONDITION_MONOTONIC
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+#else
+            clock_gettime(CLOCK_REALTIME, &deadline);
+#endif
+            deadline.tv_sec += timeout / 1000;
+            deadline.tv_nsec += (timeout % 1000) * 1000000;
+            if (deadline.tv_nsec >= 1000000000)
+            {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000;
+            }
+
+            pthread_cond_timedwait(&_impl->condition, mutexHandle, &deadline);
         }
 #endif
 
@@ -19,22 +19,43 @@
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <cstddef>
+
 #include <jvm/Global.hpp>
 
 namespace coldspot
 {
 
+    // The collectors embed mark workers and are allocated with new
+    static_assert(alignof(ConcurrentGarbageCollector) <=
+                  alignof(std::max_align_t), "collector is over-aligned");
+
+
     void GCThread::run()
     {
 
-        SimpleGarbageCollector gc;
+        HeapSpace &heapSpace = _vm->memory_manager()->heap_space();
+        // Mark with one worker per processor by default
+        uint32_t gcThreads = _vm->options()->parallelGCThreads;
+        if (gcThreads == 0)
+        {
+            gcThreads = System::processorCount();
+        }
 
-        auto &objects = _vm->memory_manager()->get_objects();
+        GarbageCollector *gc;
+        if (_vm->options()->concurrentGC)
+        {
+            gc = new ConcurrentGarbageCollector(&heapSpace);
+        }
+        else
+        {
+            gc = new SimpleGarbageCollector(&heapSpace, gcThreads);
+        }
 
         // Cancel the execution if the vm is shutting down
         while (_running)
         {
-            uint32_t lastSize = objects->size();
+            uint64_t lastAllocated = heapSpace.allocated_bytes();
 
             // Set waiting
             set_state(THREADSTATE_WAITING);
@@ -50,8 +71,9 @@ namespace coldspot
                     break;
                 }
 
-                // Run if there are more than 100 objects to gc
-                if (objects->size() - lastSize > 100)
+                // Run if the threads took buffers of more than 1 MB
+                if (heapSpace.allocated_bytes() - lastAllocated >
+                    GC_ALLOCATION_TRIGGER)
                 {
                     break;
                 }
@@ -60,13 +82,14 @@ namespace coldspot
             set_state(THREADSTATE_RUNNABLE);
 
             jlong startMillis = System::millis();
-            gc.collectGarbage();
+            gc->collectGarbage();
             jint neededMillis = (jint)(System::millis() - startMillis);
 
             LOG_DEBUG_VERBOSE(GC, "cycle needed: " << neededMillis << " ms")
         }
 
-        gc.collectGarbageForExit();
+        gc->collectGarbageForExit();
+        DELETE_OBJECT(gc)
 
         // Remove from thread list manually
         auto &threads = _vm->threads();
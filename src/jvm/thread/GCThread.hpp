@@ -31,6 +31,9 @@ namespace coldspot
     {
     public:
 
+        // Bytes allocated since the last cycle, that trigger the next one
+        static const uint64_t GC_ALLOCATION_TRIGGER = 1024 * 1024;
+
         GCThread() : Thread(THREADTYPE_GC), _running(true)
         {
 
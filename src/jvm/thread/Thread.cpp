@@ -19,6 +19,8 @@
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <chrono>
+
 #include <jvm/Global.hpp>
 
 namespace coldspot
@@ -26,6 +28,10 @@ namespace coldspot
 
     __thread Thread *_current_thread;
 
+    std::atomic<bool> _safepoint_poll(false);
+
+    std::atomic<uint32_t> Thread::_last_id(0);
+
 
     void *threadStart(void *parameter)
     {
@@ -63,6 +69,159 @@ namespace coldspot
     }
 
 
+    void Thread::interrupt()
+    {
+        _interrupt_mutex.lock();
+        _interrupted.store(true);
+        if (_blocker != 0)
+        {
+            _blocker->fetch_add(1);
+            System::wakeAddress(_blocker, true);
+        }
+        _interrupt_mutex.unlock();
+    }
+
+
+    bool Thread::is_interrupted(bool clear)
+    {
+        if (clear)
+        {
+            return _interrupted.exchange(false);
+        }
+
+        return _interrupted.load();
+    }
+
+
+    void Thread::set_blocker(std::atomic<uint32_t> *address)
+    {
+        _interrupt_mutex.lock();
+        _blocker = address;
+        _interrupt_mutex.unlock();
+    }
+
+
+    void Thread::set_state(ThreadState state)
+    {
+        // The collector does not touch the queues of other threads
+        if (state != THREADSTATE_RUNNABLE && this == _current_thread)
+        {
+            _satb_queue.flush();
+        }
+
+        _state = state;
+    }
+
+
+    bool Thread::sleep(jlong ms)
+    {
+        using namespace std::chrono;
+
+        // A deadline beyond the range of the clock is no deadline, the time
+        // point would overflow
+        auto now = steady_clock::now();
+        bool timed = ms < duration_cast<milliseconds>(
+            steady_clock::time_point::max() - now).count();
+        auto deadline = timed ? now + milliseconds(ms)
+                              : steady_clock::time_point::max();
+
+        set_blocker(&_sleep_word);
+        set_state(THREADSTATE_TIMED_WAITING);
+
+        while (true)
+        {
+            // Read the word first, an interrupt in between changes it
+            uint32_t value = _sleep_word.load();
+            if (is_interrupted(false))
+            {
+                break;
+            }
+
+            jlong remaining = 0;
+            if (timed)
+            {
+                remaining = duration_cast<nanoseconds>(
+                    deadline - steady_clock::now()).count();
+                if (remaining <= 0)
+                {
+                    break;
+                }
+            }
+
+            System::waitAddress(&_sleep_word, value, remaining);
+        }
+
+        set_state(THREADSTATE_RUNNABLE);
+        set_blocker(0);
+
+        return !is_interrupted(true);
+    }
+
+
+    void Thread::safepoint()
+    {
+        _wait_mutex.lock();
+        while (_wait_condition.wait_requested())
+        {
+            _wait_condition.wait(_wait_mutex);
+        }
+        _wait_mutex.unlock();
+    }
+
+
+    void Thread::park(bool absolute, jlong time)
+    {
+        // Consume an available permit without blocking
+        if (_permit.exchange(0) != 0)
+        {
+            return;
+        }
+
+        if (time < 0 || (absolute && time == 0))
+        {
+            return;
+        }
+
+        jlong nanos = time;
+        if (absolute)
+        {
+            jlong ms = time - System::millis();
+            if (ms <= 0)
+            {
+                return;
+            }
+
+            // Deadlines too far away to count in nanoseconds are none
+            nanos = ms < INT64_MAX / 1000000 ? ms * 1000000 : 0;
+        }
+
+        // Interrupts also change the permit once registered
+        set_blocker(&_permit);
+        set_state(nanos == 0 ? THREADSTATE_WAITING
+                             : THREADSTATE_TIMED_WAITING);
+
+        if (!is_interrupted(false))
+        {
+            System::waitAddress(&_permit, 0, nanos);
+        }
+
+        set_state(THREADSTATE_RUNNABLE);
+        set_blocker(0);
+
+        // Returning spuriously is allowed, the permit is consumed anyway
+        _permit.store(0);
+    }
+
+
+    void Thread::unpark()
+    {
+        if (_permit.exchange(1) == 0)
+        {
+            System::wakeAddress(&_permit, false);
+        }
+    }
+
+
     void Thread::start(bool daemon)
     {
         // Set daemon
@@ -22,6 +22,9 @@
 #ifndef COLDSPOT_JVM_THREAD_THREAD_HPP_
 #define COLDSPOT_JVM_THREAD_THREAD_HPP_
 
+#include <atomic>
+
+#include <jvm/memory/SatbQueue.hpp>
 #include <jvm/system/NativeTypes.hpp>
 
 #include "Condition.hpp"
@@ -33,14 +36,18 @@
 #define THREAD_UNBLOCK \
   _current_thread->block_mutex().unlock();
 
+// Polls the global safepoint word with a single load,
+// the current thread is only consulted if it is armed
 #define SAFEPOINT \
-  while (_current_thread->wait_condition().wait_requested()) { \
-    _current_thread->wait_condition().wait(_current_thread->wait_mutex()); \
+  if (_safepoint_poll.load(std::memory_order_relaxed)) { \
+    _current_thread->safepoint(); \
   }
 
 namespace coldspot
 {
 
+    class HeapRegion;
+
     enum ThreadType
     {
         THREADTYPE_FINALIZER, THREADTYPE_GC, THREADTYPE_VM
@@ -61,11 +68,19 @@ namespace coldspot
     public:
 
 
-        Thread(ThreadType type) : _type(type), _state(THREADSTATE_NEW),
-                                  _native_thread(0), _daemon(false) { }
-        Thread(ThreadType type, ThreadState state) : _type(type), _state(state),
+        Thread(ThreadType type) : _id(++_last_id), _type(type),
+                                  _state(THREADSTATE_NEW), _native_thread(0),
+                                  _daemon(false), _interrupted(false),
+                                  _blocker(0), _sleep_word(0), _permit(0),
+                                  _tlab(0) { }
+        Thread(ThreadType type, ThreadState state) : _id(++_last_id),
+                                                     _type(type), _state(state),
                                                      _native_thread(0),
-                                                     _daemon(false) { }
+                                                     _daemon(false),
+                                                     _interrupted(false),
+                                                     _blocker(0),
+                                                     _sleep_word(0),
+                                                     _permit(0), _tlab(0) { }
         virtual ~Thread() { }
 
         // Executes the thread.
@@ -78,6 +93,33 @@ namespace coldspot
         // Waits until the thread is terminated.
         void join() const;
 
+        // Sets the interrupt flag and wakes the thread if it is blocked
+        // on an address registered as blocker.
+        void interrupt();
+
+        // Returns the interrupt flag and optionally clears it.
+        bool is_interrupted(bool clear);
+
+        // Registers the futex word the thread is about to block on,
+        // so that an interrupt can wake it; 0 unregisters.
+        void set_blocker(std::atomic<uint32_t> *address);
+
+        // Sleeps until the time has elapsed or the thread is interrupted.
+        // Returns false if the sleep was interrupted.
+        bool sleep(jlong ms);
+
+        // Waits while the vm requested a suspension of this thread.
+        void safepoint();
+
+        // Blocks until the permit is available, the deadline has passed
+        // or the thread is interrupted (LockSupport.park). The time is
+        // either absolute in milliseconds since the epoch or relative in
+        // nanoseconds, 0 waits without limit.
+        void park(bool absolute, jlong time);
+
+        // Makes the permit available and wakes the thread if it is parked.
+        void unpark();
+
         bool is_alive() const
         {
             return _state != THREADSTATE_NEW &&
@@ -85,19 +127,30 @@ namespace coldspot
         }
 
         // Getters.
+        uint32_t id() const { return _id; }
         ThreadType type() const { return _type; }
         ThreadState state() const { return _state; }
         Mutex &block_mutex() { return _block_mutex; }
         Mutex &wait_mutex() { return _wait_mutex; }
         Condition &wait_condition() { return _wait_condition; }
         bool is_daemon() const { return _daemon; }
+        HeapRegion *tlab() const { return _tlab; }
+        SatbQueue &satb_queue() { return _satb_queue; }
+
+        // Sets the state, the current thread hands its recorded references
+        // to the collector before it stops running.
+        void set_state(ThreadState state);
 
         // Setters.
-        void set_state(ThreadState state) { _state = state; }
         void set_daemon(bool daemon) { _daemon = daemon; }
+        void set_tlab(HeapRegion *tlab) { _tlab = tlab; }
 
     private:
 
+        // Ids identify the owners of thin locks, 0 is no thread
+        static std::atomic<uint32_t> _last_id;
+
+        uint32_t _id;
         ThreadType _type;
         ThreadState _state;
         Thread_t _native_thread;
@@ -108,6 +161,21 @@ namespace coldspot
 
         bool _daemon;
 
+        // Interruption, the mutex orders interrupts against blockers
+        std::atomic<bool> _interrupted;
+        Mutex _interrupt_mutex;
+        std::atomic<uint32_t> *_blocker;
+        std::atomic<uint32_t> _sleep_word;
+
+        // Park permit, also the futex word parked threads block on
+        std::atomic<uint32_t> _permit;
+
+        // Allocation buffer in the heap-space
+        HeapRegion *_tlab;
+
+        // References overwritten during a concurrent marking
+        SatbQueue _satb_queue;
+
     public:
 
         // Creates a new native thread and executes the run-method.
@@ -120,6 +188,10 @@ namespace coldspot
 
     extern __thread Thread *_current_thread;
 
+    // Armed while the vm suspends the threads, polled by
+    // the interpreter and compiled code
+    extern std::atomic<bool> _safepoint_poll;
+
 }
 
 #endif